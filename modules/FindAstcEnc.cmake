@@ -0,0 +1,73 @@
+#.rst:
+# Find AstcEnc
+# ------------
+#
+# Finds the ARM ASTC Encoder library. This module defines:
+#
+#  AstcEnc_FOUND        - True if the astcenc library is found
+#  AstcEnc::AstcEnc     - astcenc imported target
+#
+# Additionally these variables are defined for internal usage:
+#
+#  AstcEnc_LIBRARY      - astcenc library
+#  AstcEnc_INCLUDE_DIR  - Include dir
+#
+# The library is built in several variants differing in the SIMD instruction
+# set used, named for example astcenc-avx2-static or astcenc-neon-shared. The
+# first found variant is used, preferring the static ones. Set AstcEnc_LIBRARY
+# to pick a particular variant.
+#
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+find_library(AstcEnc_LIBRARY NAMES
+    astcenc-native-static
+    astcenc-avx2-static
+    astcenc-sse4.1-static
+    astcenc-sse2-static
+    astcenc-neon-static
+    astcenc-none-static
+    astcenc-native-shared
+    astcenc-avx2-shared
+    astcenc-sse4.1-shared
+    astcenc-sse2-shared
+    astcenc-neon-shared
+    astcenc-none-shared)
+find_path(AstcEnc_INCLUDE_DIR NAMES astcenc.h)
+
+if(AstcEnc_LIBRARY AND AstcEnc_INCLUDE_DIR AND NOT TARGET AstcEnc::AstcEnc)
+    add_library(AstcEnc::AstcEnc UNKNOWN IMPORTED)
+    set_target_properties(AstcEnc::AstcEnc PROPERTIES
+        IMPORTED_LOCATION ${AstcEnc_LIBRARY}
+        INTERFACE_INCLUDE_DIRECTORIES ${AstcEnc_INCLUDE_DIR})
+endif()
+
+mark_as_advanced(AstcEnc_LIBRARY AstcEnc_INCLUDE_DIR)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(AstcEnc DEFAULT_MSG
+    AstcEnc_LIBRARY
+    AstcEnc_INCLUDE_DIR)
@@ -13,6 +13,7 @@
 # This command will not try to find any actual plugin. The plugins are:
 #
 #  AssimpImporter               - Assimp importer
+#  AstcDecImageConverter        - ASTC image decoder using astcenc
 #  AstcImporter                 - ASTC importer
 #  BasisImageConverter          - Basis image converter
 #  BasisImporter                - Basis importer
@@ -30,6 +31,8 @@
 #  GltfSceneConverter           - glTF converter
 #  HarfBuzzFont                 - HarfBuzz font
 #  IcoImporter                  - ICO importer
+#  IspcTexCompImageConverter    - BC7/BC6H image encoder using ISPC Texture
+#                                 Compressor
 #  JpegImageConverter           - JPEG image converter
 #  JpegImporter                 - JPEG importer
 #  KtxImageConverter            - KTX image converter
@@ -40,6 +43,8 @@
 #  PngImageConverter            - PNG image converter
 #  PngImporter                  - PNG importer
 #  PrimitiveImporter            - Primitive importer
+#  QoiImageConverter            - QOI image converter
+#  QoiImporter                  - QOI importer
 #  SpirvToolsShaderConverter    - SPIR-V Tools shader converter
 #  SpngImporter                 - PNG importer using libspng
 #  StanfordImporter             - Stanford PLY importer
@@ -171,19 +176,21 @@ mark_as_advanced(MAGNUMPLUGINS_INCLUDE_DIR)
 # components from other repositories)
 set(_MAGNUMPLUGINS_LIBRARY_COMPONENTS OpenDdl)
 set(_MAGNUMPLUGINS_PLUGIN_COMPONENTS
-    AssimpImporter AstcImporter BasisImageConverter BasisImporter
+    AssimpImporter AstcDecImageConverter AstcImporter BasisImageConverter
+    BasisImporter
     BcDecImageConverter DdsImporter DevIlImageImporter DrFlacAudioImporter
     DrMp3AudioImporter DrWavAudioImporter EtcDecImageConverter
     Faad2AudioImporter FreeTypeFont GlslangShaderConverter GltfImporter
-    GltfSceneConverter HarfBuzzFont IcoImporter JpegImageConverter JpegImporter
+    GltfSceneConverter HarfBuzzFont IcoImporter IspcTexCompImageConverter
+    JpegImageConverter JpegImporter
     KtxImageConverter KtxImporter MeshOptimizerSceneConverter
     MiniExrImageConverter OpenExrImageConverter OpenExrImporter
     OpenGexImporter PngImageConverter PngImporter PrimitiveImporter
-    SpirvToolsShaderConverter SpngImporter StanfordImporter
-    StanfordSceneConverter StbDxtImageConverter StbImageConverter
-    StbImageImporter StbResizeImageConverter StbTrueTypeFont
-    StbVorbisAudioImporter StlImporter UfbxImporter WebPImageConverter
-    WebPImporter)
+    QoiImageConverter QoiImporter SpirvToolsShaderConverter SpngImporter
+    StanfordImporter StanfordSceneConverter StbDxtImageConverter
+    StbImageConverter StbImageImporter StbResizeImageConverter
+    StbTrueTypeFont StbVorbisAudioImporter StlImporter UfbxImporter
+    WebPImageConverter WebPImporter)
 # Nothing is enabled by default right now
 set(_MAGNUMPLUGINS_IMPLICITLY_ENABLED_COMPONENTS )
 
@@ -334,6 +341,12 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
             set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
                 INTERFACE_LINK_LIBRARIES Assimp::Assimp)
 
+        # AstcDecImageConverter plugin dependencies
+        elseif(_component STREQUAL AstcDecImageConverter)
+            find_package(AstcEnc REQUIRED)
+            set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                INTERFACE_LINK_LIBRARIES AstcEnc::AstcEnc)
+
         # AstcImporter has no dependencies
 
         # BasisImageConverter / BasisImporter has only compiled-in
@@ -436,6 +449,12 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
 
         # IcoImporter has no dependencies
 
+        # IspcTexCompImageConverter plugin dependencies
+        elseif(_component STREQUAL IspcTexCompImageConverter)
+            find_package(IspcTexComp REQUIRED)
+            set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                INTERFACE_LINK_LIBRARIES IspcTexComp::IspcTexComp)
+
         # JpegImporter / JpegImageConverter plugin dependencies
         elseif(_component STREQUAL JpegImageConverter OR _component STREQUAL JpegImporter)
             find_package(JPEG)
@@ -506,12 +525,14 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
             endif()
 
         # PrimitiveImporter has no dependencies
+        # QoiImageConverter has no dependencies
+        # QoiImporter has no dependencies
 
         # SpirvToolsShaderConverter plugin dependencies
         elseif(_component STREQUAL SpirvToolsShaderConverter)
             find_package(SpirvTools REQUIRED)
             set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
-                INTERFACE_LINK_LIBRARIES SpirvTools::SpirvTools SpirvTools::Opt)
+                INTERFACE_LINK_LIBRARIES SpirvTools::SpirvTools SpirvTools::Opt SpirvTools::Link)
 
         # SpngImporter plugin dependencies
         elseif(_component STREQUAL SpngImporter)
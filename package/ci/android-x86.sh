@@ -137,6 +137,8 @@ cmake .. \
     -DMAGNUM_WITH_PNGIMAGECONVERTER=OFF \
     -DMAGNUM_WITH_PNGIMPORTER=OFF \
     -DMAGNUM_WITH_PRIMITIVEIMPORTER=ON \
+    -DMAGNUM_WITH_QOIIMAGECONVERTER=ON \
+    -DMAGNUM_WITH_QOIIMPORTER=ON \
     -DMAGNUM_WITH_SPIRVTOOLSSHADERCONVERTER=OFF \
     -DMAGNUM_WITH_SPNGIMPORTER=OFF \
     -DMAGNUM_WITH_STANFORDIMPORTER=ON \
@@ -100,6 +100,8 @@ cmake .. ^
     -DMAGNUM_WITH_PNGIMAGECONVERTER=%EXCEPT_MSVC2015% ^
     -DMAGNUM_WITH_PNGIMPORTER=%EXCEPT_MSVC2015% ^
     -DMAGNUM_WITH_PRIMITIVEIMPORTER=ON ^
+    -DMAGNUM_WITH_QOIIMAGECONVERTER=ON ^
+    -DMAGNUM_WITH_QOIIMPORTER=ON ^
     -DMAGNUM_WITH_SPIRVTOOLSSHADERCONVERTER=%EXCEPT_MSVC2015% ^
     -DMAGNUM_WITH_SPNGIMPORTER=%EXCEPT_MSVC2015% ^
     -DMAGNUM_WITH_STANFORDIMPORTER=ON ^
@@ -86,6 +86,8 @@ cmake .. \
     -DMAGNUM_WITH_PNGIMAGECONVERTER=ON \
     -DMAGNUM_WITH_PNGIMPORTER=ON \
     -DMAGNUM_WITH_PRIMITIVEIMPORTER=ON \
+    -DMAGNUM_WITH_QOIIMAGECONVERTER=ON \
+    -DMAGNUM_WITH_QOIIMPORTER=ON \
     -DMAGNUM_WITH_SPIRVTOOLSSHADERCONVERTER=ON \
     -DMAGNUM_WITH_SPNGIMPORTER=ON \
     -DMAGNUM_WITH_STANFORDIMPORTER=ON \
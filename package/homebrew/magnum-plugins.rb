@@ -101,6 +101,8 @@ class MagnumPlugins < Formula
         "-D#{option_prefix}WITH_PNGIMAGECONVERTER=#{(build.with? 'libpng') ? 'ON' : 'OFF'}",
         "-D#{option_prefix}WITH_PNGIMPORTER=#{(build.with? 'libpng') ? 'ON' : 'OFF'}",
         "-D#{option_prefix}WITH_PRIMITIVEIMPORTER=ON",
+        "-D#{option_prefix}WITH_QOIIMAGECONVERTER=ON",
+        "-D#{option_prefix}WITH_QOIIMPORTER=ON",
         "-DMAGNUM_WITH_SPIRVTOOLSSHADERCONVERTER=#{(build.with? 'spirv-tools') ? 'ON' : 'OFF'}",
         "-DMAGNUM_WITH_SPNGIMPORTER=#{(build.with? 'libspng') ? 'ON' : 'OFF'}",
         "-D#{option_prefix}WITH_STANFORDIMPORTER=ON",
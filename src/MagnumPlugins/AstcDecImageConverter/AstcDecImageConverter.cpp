@@ -0,0 +1,200 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "AstcDecImageConverter.h"
+
+#include <thread>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include <astcenc.h>
+
+namespace Magnum { namespace Trade {
+
+AstcDecImageConverter::AstcDecImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter{manager, plugin} {}
+
+ImageConverterFeatures AstcDecImageConverter::doFeatures() const {
+    return ImageConverterFeature::ConvertCompressed2D|ImageConverterFeature::ConvertCompressed3D;
+}
+
+namespace {
+
+/* Picks the astcenc profile and the output format for given ASTC format,
+   returns false if it's not an ASTC format */
+bool formatProperties(const CompressedPixelFormat format, const bool hdrToFloat, astcenc_profile& profile, PixelFormat& outputFormat) {
+    switch(format) {
+        #define _c(size)                                                    \
+            case CompressedPixelFormat::Astc ## size ## RGBAUnorm:          \
+                profile = ASTCENC_PRF_LDR;                                  \
+                outputFormat = PixelFormat::RGBA8Unorm;                     \
+                return true;                                                \
+            case CompressedPixelFormat::Astc ## size ## RGBASrgb:           \
+                profile = ASTCENC_PRF_LDR_SRGB;                             \
+                outputFormat = PixelFormat::RGBA8Srgb;                      \
+                return true;                                                \
+            case CompressedPixelFormat::Astc ## size ## RGBAF:              \
+                profile = ASTCENC_PRF_HDR;                                  \
+                outputFormat = hdrToFloat ?                                 \
+                    PixelFormat::RGBA32F : PixelFormat::RGBA16F;            \
+                return true;
+        _c(4x4)
+        _c(5x4)
+        _c(5x5)
+        _c(6x5)
+        _c(6x6)
+        _c(8x5)
+        _c(8x6)
+        _c(8x8)
+        _c(10x5)
+        _c(10x6)
+        _c(10x8)
+        _c(10x10)
+        _c(12x10)
+        _c(12x12)
+        _c(3x3x3)
+        _c(4x3x3)
+        _c(4x4x3)
+        _c(4x4x4)
+        _c(5x4x4)
+        _c(5x5x4)
+        _c(5x5x5)
+        _c(6x5x5)
+        _c(6x6x5)
+        _c(6x6x6)
+        #undef _c
+        default: return false;
+    }
+}
+
+template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> decode(const Utility::ConfigurationGroup& configuration, const CompressedImageView<dimensions>& image) {
+    astcenc_profile profile;
+    PixelFormat format;
+    if(!formatProperties(image.format(), configuration.value<bool>("hdrToFloat"), profile, format)) {
+        Error{} << "Trade::AstcDecImageConverter::convert(): unsupported format" << image.format();
+        return {};
+    }
+
+    /** @todo clean up and remove the error once there's a blocks() accessor */
+    if(image.storage() != CompressedPixelStorage{}) {
+        Error{} << "Trade::AstcDecImageConverter::convert(): non-default compressed storage is not supported";
+        return {};
+    }
+
+    /* A 2D image is a single slice, a 3D image with a 2D block format is
+       decoded as an array of slices */
+    /** @todo clean up once the block size is stored directly in the image */
+    const Vector3i size = Vector3i::pad(image.size(), 1);
+    const Vector3i blockSize = compressedPixelFormatBlockSize(image.format());
+    const Vector3i blockCount = (size + blockSize - Vector3i{1})/blockSize;
+    const std::size_t dataSize = std::size_t(blockCount.product())*compressedPixelFormatBlockDataSize(image.format());
+    if(image.data().size() < dataSize) {
+        Error{} << "Trade::AstcDecImageConverter::convert(): expected at least" << dataSize << "bytes for" << blockCount.product() << "blocks but got" << image.data().size();
+        return {};
+    }
+
+    /* The context is only ever used for decompression, so the quality preset
+       doesn't matter */
+    astcenc_config config;
+    astcenc_error error = astcenc_config_init(profile, blockSize.x(), blockSize.y(), blockSize.z(), ASTCENC_PRE_FASTEST, ASTCENC_FLG_DECOMPRESS_ONLY, &config);
+    if(error != ASTCENC_SUCCESS) {
+        Error{} << "Trade::AstcDecImageConverter::convert(): can't initialize the decoder:" << astcenc_get_error_string(error);
+        return {};
+    }
+
+    /* There's no point in having more threads than there are blocks */
+    UnsignedInt threadCount = configuration.value<UnsignedInt>("threads");
+    if(!threadCount)
+        threadCount = std::thread::hardware_concurrency();
+    threadCount = Math::max(Math::min(threadCount, UnsignedInt(blockCount.product())), 1u);
+
+    astcenc_context* context;
+    error = astcenc_context_alloc(&config, threadCount, &context);
+    if(error != ASTCENC_SUCCESS) {
+        Error{} << "Trade::AstcDecImageConverter::convert(): can't initialize the decoder:" << astcenc_get_error_string(error);
+        return {};
+    }
+    Containers::ScopeGuard contextGuard{context, astcenc_context_free};
+
+    /* Output is tightly packed RGBA, which is always four-byte aligned, and
+       each slice is referenced separately */
+    const std::size_t pixelSize = pixelFormatSize(format);
+    const std::size_t sliceSize = pixelSize*size.xy().product();
+    Containers::Array<char> out{NoInit, sliceSize*size.z()};
+    Containers::Array<void*> slices{NoInit, std::size_t(size.z())};
+    for(std::size_t i = 0; i != slices.size(); ++i)
+        slices[i] = out.data() + i*sliceSize;
+
+    astcenc_image astcImage;
+    astcImage.dim_x = size.x();
+    astcImage.dim_y = size.y();
+    astcImage.dim_z = size.z();
+    astcImage.data_type =
+        format == PixelFormat::RGBA32F ? ASTCENC_TYPE_F32 :
+        format == PixelFormat::RGBA16F ? ASTCENC_TYPE_F16 :
+        ASTCENC_TYPE_U8;
+    astcImage.data = slices.data();
+    const astcenc_swizzle swizzle{ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A};
+
+    /* Each thread calls into the same context with its own index, astcenc
+       then hands out ranges of blocks to them until all are decoded. The
+       calling thread is one of the workers, so spawn one thread less. */
+    Containers::Array<astcenc_error> errors{ValueInit, threadCount};
+    const auto worker = [&](const UnsignedInt threadIndex) {
+        errors[threadIndex] = astcenc_decompress_image(context, reinterpret_cast<const uint8_t*>(image.data().data()), dataSize, &astcImage, &swizzle, threadIndex);
+    };
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{worker, UnsignedInt(i + 1)};
+    worker(0);
+    for(std::thread& thread: threads)
+        thread.join();
+
+    for(const astcenc_error threadError: errors) if(threadError != ASTCENC_SUCCESS) {
+        Error{} << "Trade::AstcDecImageConverter::convert(): decoding failed:" << astcenc_get_error_string(threadError);
+        return {};
+    }
+
+    return Containers::optional<ImageData<dimensions>>(format, image.size(), Utility::move(out), image.flags());
+}
+
+}
+
+Containers::Optional<ImageData2D> AstcDecImageConverter::doConvert(const CompressedImageView2D& image) {
+    return decode(configuration(), image);
+}
+
+Containers::Optional<ImageData3D> AstcDecImageConverter::doConvert(const CompressedImageView3D& image) {
+    return decode(configuration(), image);
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(AstcDecImageConverter, Magnum::Trade::AstcDecImageConverter,
+    MAGNUM_TRADE_ABSTRACTIMAGECONVERTER_PLUGIN_INTERFACE)
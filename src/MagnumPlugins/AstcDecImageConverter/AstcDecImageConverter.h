@@ -0,0 +1,189 @@
+#ifndef Magnum_Trade_AstcDecImageConverter_h
+#define Magnum_Trade_AstcDecImageConverter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Trade::AstcDecImageConverter
+ * @m_since_latest_{plugins}
+ */
+
+#include <Magnum/Trade/AbstractImageConverter.h>
+
+#include "MagnumPlugins/AstcDecImageConverter/configure.h"
+
+#ifndef DOXYGEN_GENERATING_OUTPUT
+#ifndef MAGNUM_ASTCDECIMAGECONVERTER_BUILD_STATIC
+    #ifdef AstcDecImageConverter_EXPORTS
+        #define MAGNUM_ASTCDECIMAGECONVERTER_EXPORT CORRADE_VISIBILITY_EXPORT
+    #else
+        #define MAGNUM_ASTCDECIMAGECONVERTER_EXPORT CORRADE_VISIBILITY_IMPORT
+    #endif
+#else
+    #define MAGNUM_ASTCDECIMAGECONVERTER_EXPORT CORRADE_VISIBILITY_STATIC
+#endif
+#define MAGNUM_ASTCDECIMAGECONVERTER_LOCAL CORRADE_VISIBILITY_LOCAL
+#else
+#define MAGNUM_ASTCDECIMAGECONVERTER_EXPORT
+#define MAGNUM_ASTCDECIMAGECONVERTER_LOCAL
+#endif
+
+namespace Magnum { namespace Trade {
+
+/**
+@brief ASTC-compressed image decoding using astcenc
+@m_since_latest_{plugins}
+
+Decodes 2D and 3D ASTC blocks of all sizes in both the LDR and HDR profile to
+uncompressed RGBA using the [ARM ASTC Encoder](https://github.com/ARM-software/astc-encoder)
+library. Useful for example to get ASTC assets working on GPUs that don't
+support the format, see also the @ref BcDecImageConverter and
+@ref EtcDecImageConverter plugins for decoding BCn and ETC / EAC images.
+
+@m_class{m-block m-success}
+
+@thirdparty This plugin makes use of the
+    [ARM ASTC Encoder](https://github.com/ARM-software/astc-encoder) library,
+    licensed under @m_class{m-label m-success} **Apache-2.0**
+    ([license text](https://github.com/ARM-software/astc-encoder/blob/main/LICENSE.txt),
+    [choosealicense.com](https://choosealicense.com/licenses/apache-2.0/)).
+    It requires attribution for public use.
+
+@section Trade-AstcDecImageConverter-usage Usage
+
+@m_class{m-note m-success}
+
+@par
+    This class is a plugin that's meant to be dynamically loaded and used
+    via the base @ref AbstractImageConverter interface. See its documentation
+    for introduction and usage examples.
+
+This plugin depends on the @ref Trade library and the ARM ASTC Encoder library
+and is built if `MAGNUM_WITH_ASTCDECIMAGECONVERTER` is enabled when building
+Magnum Plugins. To use as a dynamic plugin, load
+@cpp "AstcDecImageConverter" @ce via @ref Corrade::PluginManager::Manager.
+
+Additionally, if you're using Magnum as a CMake subproject, bundle the
+[magnum-plugins repository](https://github.com/mosra/magnum-plugins) and do the
+following. Using astcenc itself as a CMake subproject isn't tested at the
+moment, so you need to provide it as a system dependency and point
+`CMAKE_PREFIX_PATH` to its installation dir if necessary.
+
+@code{.cmake}
+set(MAGNUM_WITH_ASTCDECIMAGECONVERTER ON CACHE BOOL "" FORCE)
+add_subdirectory(magnum-plugins EXCLUDE_FROM_ALL)
+
+# So the dynamically loaded plugin gets built implicitly
+add_dependencies(your-app MagnumPlugins::AstcDecImageConverter)
+@endcode
+
+To use as a static plugin or as a dependency of another plugin with CMake, put
+[FindMagnumPlugins.cmake](https://github.com/mosra/magnum-plugins/blob/master/modules/FindMagnumPlugins.cmake)
+and [FindAstcEnc.cmake](https://github.com/mosra/magnum-plugins/blob/master/modules/FindAstcEnc.cmake)
+into your `modules/` directory, request the `AstcDecImageConverter` component
+of the `MagnumPlugins` package and link to the
+`MagnumPlugins::AstcDecImageConverter` target:
+
+@code{.cmake}
+find_package(MagnumPlugins REQUIRED AstcDecImageConverter)
+
+# ...
+target_link_libraries(your-app PRIVATE MagnumPlugins::AstcDecImageConverter)
+@endcode
+
+See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
+information.
+
+@section Trade-AstcDecImageConverter-behavior Behavior and limitations
+
+All 2D and 3D ASTC block sizes are supported, with the output format picked
+as follows:
+
+-   @ref CompressedPixelFormat::Astc4x4RGBAUnorm and other `*RGBAUnorm`
+    formats are decoded to @ref PixelFormat::RGBA8Unorm using the LDR profile
+-   @ref CompressedPixelFormat::Astc4x4RGBASrgb and other `*RGBASrgb`
+    formats are decoded to @ref PixelFormat::RGBA8Srgb using the LDR sRGB
+    profile
+-   @ref CompressedPixelFormat::Astc4x4RGBAF and other `*RGBAF` formats are
+    decoded to @ref PixelFormat::RGBA16F by default, and to
+    @ref PixelFormat::RGBA32F if the @cb{.ini} hdrToFloat @ce
+    @ref Trade-AstcDecImageConverter-configuration "configuration option" is
+    enabled. The HDR profile is used, which is able to decode LDR blocks as
+    well.
+
+Blocks that use HDR endpoints in a format that's decoded with the LDR profile
+are decoded as magenta, as mandated by the specification. Unlike with the
+@ref BcDecImageConverter, the output image has exactly the size of the input
+and isn't padded to whole blocks. Non-default @ref CompressedPixelStorage
+isn't supported in input images.
+
+Both 2D and 3D image conversion is supported. A 3D image with a 2D block
+format is treated as a 2D array, decoding each slice separately. Image flags,
+if any, are passed through unchanged.
+
+The decoding can be spread across multiple threads using the
+@cb{.ini} threads @ce @ref Trade-AstcDecImageConverter-configuration "configuration option".
+The astcenc context is created anew for every conversion, threads are spawned
+for the duration of the conversion and the blocks get distributed among them
+by astcenc itself.
+
+@subsection Trade-AstcDecImageConverter-behavior-loading Loading the plugin fails with undefined symbol: pthread_create
+
+On Linux it may happen that loading the plugin will fail with
+`undefined symbol: pthread_create`. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+plugin isn't linked to `pthread` and requires *the application* to link to it
+instead. With CMake it can be done like this:
+
+@code{.cmake}
+find_package(Threads REQUIRED)
+target_link_libraries(your-application PRIVATE Threads::Threads)
+@endcode
+
+@section Trade-AstcDecImageConverter-configuration Plugin-specific configuration
+
+It's possible to tune various conversion options through @ref configuration().
+See below for all options and their default values:
+
+@snippet MagnumPlugins/AstcDecImageConverter/AstcDecImageConverter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
+*/
+class MAGNUM_ASTCDECIMAGECONVERTER_EXPORT AstcDecImageConverter: public AbstractImageConverter {
+    public:
+        /** @brief Plugin manager constructor */
+        explicit AstcDecImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
+
+    private:
+        MAGNUM_ASTCDECIMAGECONVERTER_LOCAL ImageConverterFeatures doFeatures() const override;
+
+        MAGNUM_ASTCDECIMAGECONVERTER_LOCAL Containers::Optional<ImageData2D> doConvert(const CompressedImageView2D& image) override;
+        MAGNUM_ASTCDECIMAGECONVERTER_LOCAL Containers::Optional<ImageData3D> doConvert(const CompressedImageView3D& image) override;
+};
+
+}}
+
+#endif
@@ -0,0 +1,381 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Path.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/DebugTools/CompareImage.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Half.h>
+#include <Magnum/Math/Packing.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct AstcDecImageConverterTest: TestSuite::Tester {
+    explicit AstcDecImageConverterTest();
+
+    void test2D();
+    void test3D();
+    void hdr();
+    void threads();
+
+    void preserveFlags2D();
+    void preserveFlags3D();
+
+    void unsupportedFormat();
+    void unsupportedStorage();
+    void dataTooShort();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImageConverter> _manager{"nonexistent"};
+    PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
+};
+
+using namespace Math::Literals;
+
+/* Correspondence of the ASTC files to the uncompressed input can be seen in
+   AstcImporter/Test/convert.sh */
+const struct {
+    const char* name;
+    const char* filename;
+    const char* importerFormat;
+    CompressedPixelFormat format;
+    PixelFormat expectedFormat;
+    const char* expected;
+    Float maxThreshold, meanThreshold;
+} Test2DData[]{
+    {"8x8", "8x8.astc", nullptr,
+        CompressedPixelFormat::Astc8x8RGBAUnorm, PixelFormat::RGBA8Unorm,
+        "rgba-64x32.png", 38.0f, 3.5f},
+    {"8x8, sRGB", "8x8.astc", "srgb",
+        CompressedPixelFormat::Astc8x8RGBASrgb, PixelFormat::RGBA8Srgb,
+        "rgba-64x32.png", 38.0f, 3.5f},
+    {"12x10, incomplete blocks", "12x10-incomplete-blocks.astc", nullptr,
+        CompressedPixelFormat::Astc12x10RGBAUnorm, PixelFormat::RGBA8Unorm,
+        "rgba-63x27.png", 56.0f, 5.0f},
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    CompressedPixelFormat format;
+    ImageFlags3D expectedFlags;
+    Vector3i expectedSize;
+    const char* expected[3];
+    Float maxThreshold, meanThreshold;
+} Test3DData[]{
+    {"3x3x3", "3x3x3.astc",
+        CompressedPixelFormat::Astc3x3x3RGBAUnorm, {}, {27, 27, 3},
+        {"rgba-27x27.png", "rgba-27x27-slice1.png", "rgba-27x27-slice2.png"},
+        24.0f, 1.5f},
+    {"12x12 2D array, incomplete blocks", "12x12-array-incomplete-blocks.astc",
+        CompressedPixelFormat::Astc12x12RGBAUnorm, ImageFlag3D::Array, {27, 27, 2},
+        {"rgba-27x27.png", "rgba-27x27-slice2.png", nullptr},
+        56.0f, 5.0f},
+};
+
+const struct {
+    const char* name;
+    Containers::Optional<bool> hdrToFloat;
+    PixelFormat expectedFormat;
+} HdrData[]{
+    {"", {}, PixelFormat::RGBA16F},
+    {"to float", true, PixelFormat::RGBA32F},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} ThreadsData[]{
+    {"two threads", 2},
+    {"more threads than blocks", 32},
+    {"hardware concurrency", 0},
+};
+
+/* A constant-color LDR void-extent block, decoding to opaque white */
+constexpr char WhiteBlock[]{
+    '\xfc', '\xfd', '\xff', '\xff', '\xff', '\xff', '\xff', '\xff',
+    '\xff', '\xff', '\xff', '\xff', '\xff', '\xff', '\xff', '\xff'
+};
+
+AstcDecImageConverterTest::AstcDecImageConverterTest() {
+    addInstancedTests({&AstcDecImageConverterTest::test2D},
+        Containers::arraySize(Test2DData));
+
+    addInstancedTests({&AstcDecImageConverterTest::test3D},
+        Containers::arraySize(Test3DData));
+
+    addInstancedTests({&AstcDecImageConverterTest::hdr},
+        Containers::arraySize(HdrData));
+
+    addInstancedTests({&AstcDecImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    addTests({&AstcDecImageConverterTest::preserveFlags2D,
+              &AstcDecImageConverterTest::preserveFlags3D,
+
+              &AstcDecImageConverterTest::unsupportedFormat,
+              &AstcDecImageConverterTest::unsupportedStorage,
+              &AstcDecImageConverterTest::dataTooShort});
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef ASTCDECIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(ASTCDECIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef ASTCIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(ASTCIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STBIMAGEIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(STBIMAGEIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void AstcDecImageConverterTest::test2D() {
+    auto&& data = Test2DData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("AstcImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("AstcImporter plugin not found, cannot test conversion");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("AstcImporter");
+    /* The ASTC files are Y down but we don't want the importer to warn about
+       that. Instead the output gets flipped for comparison below. */
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    if(data.importerFormat)
+        importer->configuration().setValue("format", data.importerFormat);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASTCIMPORTER_TEST_DIR, data.filename)));
+
+    Containers::Optional<ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->compressedFormat(), data.format);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("AstcDecImageConverter");
+    Containers::Optional<ImageData2D> converted = converter->convert(*image);
+    CORRADE_VERIFY(converted);
+    CORRADE_VERIFY(!converted->isCompressed());
+    CORRADE_COMPARE(converted->format(), data.expectedFormat);
+    CORRADE_COMPARE(converted->size(), image->size());
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot compare converted output");
+
+    Containers::Pointer<AbstractImporter> expectedImporter = _importerManager.instantiate("StbImageImporter");
+    CORRADE_VERIFY(expectedImporter->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, data.expected)));
+    Containers::Optional<ImageData2D> expected = expectedImporter->image2D(0);
+    CORRADE_VERIFY(expected);
+    CORRADE_COMPARE_WITH(converted->pixels<Color4ub>().flipped<0>(),
+        *expected,
+        (DebugTools::CompareImage{data.maxThreshold, data.meanThreshold}));
+}
+
+void AstcDecImageConverterTest::test3D() {
+    auto&& data = Test3DData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("AstcImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("AstcImporter plugin not found, cannot test conversion");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("AstcImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASTCIMPORTER_TEST_DIR, data.filename)));
+
+    Containers::Optional<ImageData3D> image = importer->image3D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->compressedFormat(), data.format);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("AstcDecImageConverter");
+    Containers::Optional<ImageData3D> converted = converter->convert(*image);
+    CORRADE_VERIFY(converted);
+    CORRADE_VERIFY(!converted->isCompressed());
+    CORRADE_COMPARE(converted->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(converted->size(), data.expectedSize);
+    CORRADE_COMPARE(converted->flags(), data.expectedFlags);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot compare converted output");
+
+    /* Comparing slice by slice as CompareImage has no 3D support */
+    Containers::Pointer<AbstractImporter> expectedImporter = _importerManager.instantiate("StbImageImporter");
+    for(std::size_t i = 0; i != std::size_t(data.expectedSize.z()); ++i) {
+        CORRADE_ITERATION(data.expected[i]);
+        CORRADE_VERIFY(expectedImporter->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, data.expected[i])));
+        Containers::Optional<ImageData2D> expected = expectedImporter->image2D(0);
+        CORRADE_VERIFY(expected);
+        CORRADE_COMPARE_WITH(converted->pixels<Color4ub>()[i].flipped<0>(),
+            *expected,
+            (DebugTools::CompareImage{data.maxThreshold, data.meanThreshold}));
+    }
+}
+
+void AstcDecImageConverterTest::hdr() {
+    auto&& data = HdrData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("AstcImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("AstcImporter plugin not found, cannot test conversion");
+
+    /* Import the same LDR file once as LDR and once as HDR. The HDR profile
+       is a superset of the LDR one, so both should give the same result, save
+       for rounding. */
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("AstcImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASTCIMPORTER_TEST_DIR, "8x8.astc")));
+    Containers::Optional<ImageData2D> ldrImage = importer->image2D(0);
+    CORRADE_VERIFY(ldrImage);
+
+    importer->configuration().setValue("format", "float");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASTCIMPORTER_TEST_DIR, "8x8.astc")));
+    Containers::Optional<ImageData2D> hdrImage = importer->image2D(0);
+    CORRADE_VERIFY(hdrImage);
+    CORRADE_COMPARE(hdrImage->compressedFormat(), CompressedPixelFormat::Astc8x8RGBAF);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("AstcDecImageConverter");
+    Containers::Optional<ImageData2D> ldr = converter->convert(*ldrImage);
+    CORRADE_VERIFY(ldr);
+    CORRADE_COMPARE(ldr->format(), PixelFormat::RGBA8Unorm);
+
+    if(data.hdrToFloat)
+        converter->configuration().setValue("hdrToFloat", *data.hdrToFloat);
+    Containers::Optional<ImageData2D> hdr = converter->convert(*hdrImage);
+    CORRADE_VERIFY(hdr);
+    CORRADE_COMPARE(hdr->format(), data.expectedFormat);
+    CORRADE_COMPARE(hdr->size(), ldr->size());
+
+    /* Unpack both to floats for comparison */
+    const Vector2i size = ldr->size();
+    Containers::Array<Color4> expected{NoInit, std::size_t(size.product())};
+    Containers::Array<Color4> actual{NoInit, std::size_t(size.product())};
+    for(Int y = 0; y != size.y(); ++y) for(Int x = 0; x != size.x(); ++x) {
+        const std::size_t i = y*size.x() + x;
+        expected[i] = Math::unpack<Color4>(ldr->pixels<Color4ub>()[y][x]);
+        actual[i] = data.expectedFormat == PixelFormat::RGBA16F ?
+            Color4{Math::unpackHalf(hdr->pixels<Vector4us>()[y][x])} :
+            hdr->pixels<Color4>()[y][x];
+    }
+    CORRADE_COMPARE_WITH(
+        (ImageView2D{PixelFormat::RGBA32F, size, actual}),
+        (ImageView2D{PixelFormat::RGBA32F, size, expected}),
+        (DebugTools::CompareImage{1.0f/255.0f, 0.5f/255.0f}));
+}
+
+void AstcDecImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("AstcImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("AstcImporter plugin not found, cannot test conversion");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("AstcImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASTCIMPORTER_TEST_DIR, "12x10-incomplete-blocks.astc")));
+    Containers::Optional<ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("AstcDecImageConverter");
+    Containers::Optional<ImageData2D> serial = converter->convert(*image);
+    CORRADE_VERIFY(serial);
+
+    /* The output should be exactly the same as when decoded serially */
+    converter->configuration().setValue("threads", data.threads);
+    Containers::Optional<ImageData2D> parallel = converter->convert(*image);
+    CORRADE_VERIFY(parallel);
+    CORRADE_COMPARE(parallel->size(), serial->size());
+    CORRADE_COMPARE_AS(parallel->data(),
+        serial->data(),
+        TestSuite::Compare::Container);
+}
+
+void AstcDecImageConverterTest::preserveFlags2D() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("AstcDecImageConverter");
+
+    /* Just verify that the flags don't get lost in the process. Everything
+       else is tested well enough above. */
+    Containers::Optional<ImageData2D> converted = converter->convert(CompressedImageView2D{CompressedPixelFormat::Astc4x4RGBAUnorm, {3, 2}, WhiteBlock, ImageFlag2D::Array});
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->flags(), ImageFlag2D::Array);
+    CORRADE_COMPARE(converted->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE(converted->pixels<Color4ub>()[1][2], 0xffffffff_rgba);
+}
+
+void AstcDecImageConverterTest::preserveFlags3D() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("AstcDecImageConverter");
+
+    char data[32];
+    std::memcpy(data, WhiteBlock, 16);
+    std::memcpy(data + 16, WhiteBlock, 16);
+    Containers::Optional<ImageData3D> converted = converter->convert(CompressedImageView3D{CompressedPixelFormat::Astc4x4RGBAUnorm, {4, 4, 2}, data, ImageFlag3D::Array});
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->flags(), ImageFlag3D::Array);
+    CORRADE_COMPARE(converted->size(), (Vector3i{4, 4, 2}));
+    CORRADE_COMPARE(converted->pixels<Color4ub>()[1][3][3], 0xffffffff_rgba);
+}
+
+void AstcDecImageConverterTest::unsupportedFormat() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("AstcDecImageConverter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(CompressedImageView2D{CompressedPixelFormat::Bc1RGBAUnorm, {1, 1}, "yeyhey!"}));
+    CORRADE_COMPARE(out.str(), "Trade::AstcDecImageConverter::convert(): unsupported format CompressedPixelFormat::Bc1RGBAUnorm\n");
+}
+
+void AstcDecImageConverterTest::unsupportedStorage() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("AstcDecImageConverter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(CompressedImageView2D{CompressedPixelStorage{}.setCompressedBlockDataSize(16), CompressedPixelFormat::Astc4x4RGBASrgb, {1, 1}, WhiteBlock}));
+    CORRADE_COMPARE(out.str(), "Trade::AstcDecImageConverter::convert(): non-default compressed storage is not supported\n");
+}
+
+void AstcDecImageConverterTest::dataTooShort() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("AstcDecImageConverter");
+
+    /* Two blocks needed, only one supplied */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(CompressedImageView2D{CompressedPixelFormat::Astc4x4RGBAUnorm, {5, 4}, WhiteBlock}));
+    CORRADE_COMPARE(out.str(), "Trade::AstcDecImageConverter::convert(): expected at least 32 bytes for 2 blocks but got 16\n");
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::AstcDecImageConverterTest)
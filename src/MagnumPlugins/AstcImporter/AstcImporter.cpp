@@ -25,13 +25,20 @@
 
 #include "AstcImporter.h"
 
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h> /** @todo remove once file callbacks are std::string-free */
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/FileCallback.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
 namespace Magnum { namespace Trade {
@@ -61,53 +68,25 @@ static_assert(sizeof(AstcHeader) == 16, "Invalid AstcHeader size");
 /* All ASTC formats are 128-bit blocks */
 constexpr Int AstcBlockDataSize = 128/8;
 
-}
-
-struct AstcImporter::State {
-    CompressedPixelFormat format;
-    Vector3i size;
-    /* Could be retrieved from format block size, but that's a giant switch.
-       This makes the structure 8 bytes larger, which is 64x more memory than
-       needed to store a single bit, but that doesn't matter here. Can't set
-       Z=0 to mark 2D images, because the file can have zero size and still be
-       a 3D format. */
-    bool is3D;
-    ImageFlags3D flags;
-    /* Needed because the data might be longer */
-    std::size_t dataSize;
-    Containers::Array<char> data;
-};
-
-AstcImporter::AstcImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin) : AbstractImporter{manager, plugin} {}
-
-AstcImporter::~AstcImporter() = default;
-
-ImporterFeatures AstcImporter::doFeatures() const { return ImporterFeature::OpenData; }
-
-bool AstcImporter::doIsOpened() const { return !!_state; }
-
-void AstcImporter::doClose() { _state = nullptr; }
-
-void AstcImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
-    /* Unlike with e.g. TgaImporter, where doOpenData() only takes over the
-       data array, here we need to parse the format to decide whether it's a
-       2D or a 3D image. And while at it, why not do also all other checks. */
-
+/* Checks the header and that the data are large enough for all blocks,
+   returning the block size, image size and block data size. The format is
+   always the *RGBAUnorm variant. Used for both the opened file and the
+   additional mip level files, prefix is printed before all messages. */
+bool parseHeader(const Containers::StringView prefix, const ImporterFlags flags, const Containers::ArrayView<const char> data, CompressedPixelFormat& format, Vector3ub& blockSize, Vector3i& size, std::size_t& dataSize) {
     /* There should be at least the header */
     if(data.size() < sizeof(AstcHeader)) {
-        Error{} << "Trade::AstcImporter::openData(): file header too short, expected at least" << sizeof(AstcHeader) << "bytes but got" << data.size();
-        return;
+        Error{} << prefix << "file header too short, expected at least" << sizeof(AstcHeader) << "bytes but got" << data.size();
+        return false;
     }
 
     /* Check magic, SCALABLE, unfortunately in LE so it's not as visible */
     AstcHeader header = *reinterpret_cast<const AstcHeader*>(data.begin());
     if(Containers::StringView{header.magic, 4} != "\x13\xAB\xA1\x5C"_s) {
-        Error{} << "Trade::AstcImporter::openData(): invalid file magic 0x" << Debug::nospace << Utility::format("{:.8X}", header.magicNumber);
-        return;
+        Error{} << prefix << "invalid file magic 0x" << Debug::nospace << Utility::format("{:.8X}", header.magicNumber);
+        return false;
     }
 
     /* Calculate format from block size */
-    CompressedPixelFormat format;
     switch(header.blockSize.x() << 16 | header.blockSize.y() << 8 | header.blockSize.z()) {
         /* LCOV_EXCL_START */
         #define _c(sizeX, sizeY) case sizeX << 16 | sizeY << 8 | 1:         \
@@ -146,10 +125,75 @@ void AstcImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
         /* LCOV_EXCL_STOP */
 
         default:
-            Error{} << "Trade::AstcImporter::openData(): invalid block size" << Debug::packed << header.blockSize;
-        return;
+            Error{} << prefix << "invalid block size" << Debug::packed << header.blockSize;
+        return false;
+    }
+    blockSize = header.blockSize;
+
+    /* Image size, check if file isn't too short */
+    size = {
+        header.sizeX[0] | header.sizeX[1] << 8 | header.sizeX[2] << 16,
+        header.sizeY[0] | header.sizeY[1] << 8 | header.sizeY[2] << 16,
+        header.sizeZ[0] | header.sizeZ[1] << 8 | header.sizeZ[2] << 16
+    };
+    dataSize = AstcBlockDataSize*((size + Vector3i{header.blockSize} - Vector3i{1})/Vector3i{header.blockSize}).product();
+    if(sizeof(AstcHeader) + dataSize > data.size()) {
+        Error{} << prefix << "file too short, expected" << sizeof(AstcHeader) + dataSize << "bytes but got" << data.size();
+        return false;
+    } else if(!(flags & ImporterFlag::Quiet) && sizeof(AstcHeader) + dataSize < data.size()) {
+        Warning{} << prefix << "ignoring" << data.size() - sizeof(AstcHeader) - dataSize << "extra bytes at the end of file";
     }
 
+    return true;
+}
+
+}
+
+struct AstcImporter::State {
+    CompressedPixelFormat format;
+    /* Kept to verify that additional mip level files match */
+    Vector3ub blockSize;
+    /* Could be retrieved from format block size, but that's a giant switch.
+       This makes the structure 8 bytes larger, which is 64x more memory than
+       needed to store a single bit, but that doesn't matter here. Can't set
+       Z=0 to mark 2D images, because the file can have zero size and still be
+       a 3D format. */
+    bool is3D;
+    ImageFlags3D flags;
+
+    /* The opened file is the first level, additional levels are loaded from
+       sibling files if mipLevelFilename is set */
+    struct Level {
+        Vector3i size;
+        /* Needed because the data might be longer */
+        std::size_t dataSize;
+        /* Including the header */
+        Containers::Array<char> data;
+    };
+    Containers::Array<Level> levels;
+};
+
+AstcImporter::AstcImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin) : AbstractImporter{manager, plugin} {}
+
+AstcImporter::~AstcImporter() = default;
+
+ImporterFeatures AstcImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::FileCallback; }
+
+bool AstcImporter::doIsOpened() const { return !!_state; }
+
+void AstcImporter::doClose() { _state = nullptr; }
+
+void AstcImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    /* Unlike with e.g. TgaImporter, where doOpenData() only takes over the
+       data array, here we need to parse the format to decide whether it's a
+       2D or a 3D image. And while at it, why not do also all other checks. */
+    CompressedPixelFormat format;
+    Vector3ub blockSize;
+    Vector3i size;
+    std::size_t dataSize;
+    if(!parseHeader("Trade::AstcImporter::openData():", flags(), data, format, blockSize, size, dataSize))
+        return;
+
     /* Patch the format if requested. Relies on CompressedPixelFormat::Astc*
        values consistently being first Unorm, then Srgb, then F. */
     const Containers::StringView formatPatch = configuration().value<Containers::StringView>("format");
@@ -162,20 +206,6 @@ void AstcImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
         return;
     }
 
-    /* Image size, check if file isn't too short */
-    const Vector3i size{
-        header.sizeX[0] | header.sizeX[1] << 8 | header.sizeX[2] << 16,
-        header.sizeY[0] | header.sizeY[1] << 8 | header.sizeY[2] << 16,
-        header.sizeZ[0] | header.sizeZ[1] << 8 | header.sizeZ[2] << 16
-    };
-    const std::size_t dataSize = AstcBlockDataSize*((size + Vector3i{header.blockSize} - Vector3i{1})/Vector3i{header.blockSize}).product();
-    if(sizeof(AstcHeader) + dataSize > data.size()) {
-        Error{} << "Trade::AstcImporter::openData(): file too short, expected" << sizeof(AstcHeader) + dataSize << "bytes but got" << data.size();
-        return;
-    } else if(!(flags() & ImporterFlag::Quiet) && sizeof(AstcHeader) + dataSize < data.size()) {
-        Warning{} << "Trade::AstcImporter::openData(): ignoring" << data.size() - sizeof(AstcHeader) - dataSize << "extra bytes at the end of file";
-    }
-
     /* Unlike KTX or Basis, the file format doesn't contain any orientation
        metadata, so we have to rely on an externally-provided hint */
     if(!(flags() & ImporterFlag::Quiet) && !configuration().value<bool>("assumeYUpZBackward")) {
@@ -185,11 +215,11 @@ void AstcImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
     /* All good now, let's save everything */
     _state.emplace();
     _state->format = format;
-    _state->size = size;
+    _state->blockSize = blockSize;
     /* An image is 3D if ... */
     _state->is3D =
         /* it has a 3D block, */
-        header.blockSize.z() != 1 ||
+        blockSize.z() != 1 ||
         /* it has Z size larger than 1, */
         size.z() > 1 ||
         /* or it has Z size 0 and XY is non-zero, in which case the 2D image
@@ -197,19 +227,94 @@ void AstcImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
            2D image. */
         (!size.z() && size.xy().product());
     /* Mark the image as 2D array if it's 3D but has a 2D format */
-    if(_state->is3D && header.blockSize.z() == 1)
+    if(_state->is3D && blockSize.z() == 1)
         _state->flags |= ImageFlag3D::Array;
-    _state->dataSize = dataSize;
 
     /* Take over the existing array or copy the data if we can't. For
        simplicity we copy it including the tiny header so we don't need to have
        different handling based on whether the data was taken over or copied
        later. */
+    State::Level level;
+    level.size = size;
+    level.dataSize = dataSize;
     if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
-        _state->data = Utility::move(data);
+        level.data = Utility::move(data);
     } else {
-        _state->data = Containers::Array<char>{NoInit, data.size()};
-        Utility::copy(data, _state->data);
+        level.data = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, level.data);
+    }
+    arrayAppend(_state->levels, Utility::move(level));
+}
+
+void AstcImporter::doOpenFile(const Containers::StringView filename) {
+    AbstractImporter::doOpenFile(filename);
+    if(!_state) return;
+
+    const Containers::String levelFilenameFormat = configuration().value<Containers::String>("mipLevelFilename");
+    if(levelFilenameFormat.isEmpty()) return;
+
+    /* Empty images can't have any mip levels */
+    const Vector3i baseSize = _state->levels[0].size;
+    if(!baseSize.product()) return;
+
+    /* For 2D images and 2D arrays only the XY size gets halved */
+    const bool halveZ = _state->is3D && !(_state->flags & ImageFlag3D::Array);
+    const Containers::StringView filenameWithoutExtension = Utility::Path::splitExtension(filename).first();
+
+    /* Continue until the 1x1 level or until there's no further file,
+       whichever comes first */
+    for(Int i = 1; ; ++i) {
+        const Vector3i previousSize = _state->levels.back().size;
+        if(previousSize.xy() == Vector2i{1} && (!halveZ || previousSize.z() == 1))
+            break;
+
+        const Containers::String levelFilename = Utility::format(levelFilenameFormat.data(), filenameWithoutExtension, i);
+
+        /* If a file callback is set, ask it to keep the data in memory for
+           the whole importer lifetime and reference them directly, otherwise
+           read the file into a newly allocated array. A missing file is not
+           an error, it just ends the mip chain. */
+        Containers::Array<char> data;
+        if(fileCallback()) {
+            const Containers::Optional<Containers::ArrayView<const char>> view = fileCallback()(levelFilename, InputFileCallbackPolicy::LoadPermanent, fileCallbackUserData());
+            if(!view) break;
+            data = Containers::Array<char>{const_cast<char*>(view->data()), view->size(), [](char*, std::size_t){}};
+        } else {
+            if(!Utility::Path::exists(levelFilename)) break;
+            Containers::Optional<Containers::Array<char>> read = Utility::Path::read(levelFilename);
+            if(!read) {
+                Error{} << "Trade::AstcImporter::openFile(): cannot read" << levelFilename;
+                _state = nullptr;
+                return;
+            }
+            data = *Utility::move(read);
+        }
+
+        const Containers::String prefix = Utility::format("Trade::AstcImporter::openFile(): level {} file {}:", i, levelFilename);
+        CompressedPixelFormat format;
+        Vector3ub blockSize;
+        State::Level level;
+        if(!parseHeader(prefix, flags(), data, format, blockSize, level.size, level.dataSize)) {
+            _state = nullptr;
+            return;
+        }
+
+        if(blockSize != _state->blockSize) {
+            Error{} << prefix << "expected block size" << Debug::packed << _state->blockSize << "but got" << Debug::packed << blockSize;
+            _state = nullptr;
+            return;
+        }
+
+        Vector3i expectedSize = Math::max(baseSize >> i, Vector3i{1});
+        if(!halveZ) expectedSize.z() = baseSize.z();
+        if(level.size != expectedSize) {
+            Error{} << prefix << "expected size" << Debug::packed << expectedSize << "but got" << Debug::packed << level.size;
+            _state = nullptr;
+            return;
+        }
+
+        level.data = Utility::move(data);
+        arrayAppend(_state->levels, Utility::move(level));
     }
 }
 
@@ -217,20 +322,44 @@ UnsignedInt AstcImporter::doImage2DCount() const {
     return _state->is3D ? 0 : 1;
 }
 
-Containers::Optional<ImageData2D> AstcImporter::doImage2D(UnsignedInt, UnsignedInt) {
-    Containers::Array<char> data{NoInit, _state->dataSize};
-    Utility::copy(_state->data.slice(sizeof(AstcHeader), sizeof(AstcHeader) + _state->dataSize), data);
-    return ImageData2D{_state->format, _state->size.xy(), Utility::move(data), ImageFlag2D(UnsignedShort(_state->flags))};
+UnsignedInt AstcImporter::doImage2DLevelCount(UnsignedInt) {
+    return _state->levels.size();
+}
+
+Containers::Optional<ImageData2D> AstcImporter::doImage2D(UnsignedInt, const UnsignedInt level) {
+    const State::Level& l = _state->levels[level];
+    const Containers::ArrayView<const char> blocks = l.data.slice(sizeof(AstcHeader), sizeof(AstcHeader) + l.dataSize);
+
+    /* Reference the data directly if requested, they stay valid until the
+       importer is closed */
+    if(configuration().value<bool>("zeroCopy"))
+        return ImageData2D{_state->format, l.size.xy(), DataFlags{}, blocks, ImageFlag2D(UnsignedShort(_state->flags))};
+
+    Containers::Array<char> data{NoInit, l.dataSize};
+    Utility::copy(blocks, data);
+    return ImageData2D{_state->format, l.size.xy(), Utility::move(data), ImageFlag2D(UnsignedShort(_state->flags))};
 }
 
 UnsignedInt AstcImporter::doImage3DCount() const {
     return _state->is3D ? 1 : 0;
 }
 
-Containers::Optional<ImageData3D> AstcImporter::doImage3D(UnsignedInt, UnsignedInt) {
-    Containers::Array<char> data{NoInit, _state->dataSize};
-    Utility::copy(_state->data.slice(sizeof(AstcHeader), sizeof(AstcHeader) + _state->dataSize), data);
-    return ImageData3D{_state->format, _state->size, Utility::move(data), _state->flags};
+UnsignedInt AstcImporter::doImage3DLevelCount(UnsignedInt) {
+    return _state->levels.size();
+}
+
+Containers::Optional<ImageData3D> AstcImporter::doImage3D(UnsignedInt, const UnsignedInt level) {
+    const State::Level& l = _state->levels[level];
+    const Containers::ArrayView<const char> blocks = l.data.slice(sizeof(AstcHeader), sizeof(AstcHeader) + l.dataSize);
+
+    /* Reference the data directly if requested, they stay valid until the
+       importer is closed */
+    if(configuration().value<bool>("zeroCopy"))
+        return ImageData3D{_state->format, l.size, DataFlags{}, blocks, _state->flags};
+
+    Containers::Array<char> data{NoInit, l.dataSize};
+    Utility::copy(blocks, data);
+    return ImageData3D{_state->format, l.size, Utility::move(data), _state->flags};
 }
 
 }}
@@ -136,6 +136,26 @@ option enforces use of a 3D ASTC format), but other tools might.
 The plugin recognizes @ref ImporterFlag::Quiet, which will cause all import
 warnings to be suppressed.
 
+The file format contains just a single image level. If the
+@cb{.ini} mipLevelFilename @ce @ref Trade-AstcImporter-configuration "configuration option"
+is set, @ref openFile() additionally loads mip levels from sibling files named
+according to it, until a 1x1 level is reached or until a file doesn't exist.
+With a file callback set, the files are requested with
+@ref InputFileCallbackPolicy::LoadPermanent and referenced directly, otherwise
+each is read into a single allocation. Each level is expected to have the same
+block size as the base level and half its size, rounded down. For 2D array
+images only the X and Y dimension is halved.
+
+By default, the data of each imported image is copied out of the file. The
+file itself is referenced without a copy if it's opened through
+@ref openFile(), with @ref openData() and a r-value array or with
+@ref openMemory(). Enabling the @cb{.ini} zeroCopy @ce
+@ref Trade-AstcImporter-configuration "configuration option" makes the
+returned images reference the data directly, with empty
+@ref ImageData::dataFlags(). Such images are then valid only
+as long as the importer stays open, or in case of @ref openMemory() as long as
+the memory stays valid.
+
 @section Trade-AstcImporter-configuration Plugin-specific configuration
 
 It's possible to tune various import options through @ref configuration(). See
@@ -158,11 +178,14 @@ class MAGNUM_ASTCIMPORTER_EXPORT AstcImporter: public AbstractImporter {
         MAGNUM_ASTCIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_ASTCIMPORTER_LOCAL void doClose() override;
         MAGNUM_ASTCIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
+        MAGNUM_ASTCIMPORTER_LOCAL void doOpenFile(Containers::StringView filename) override;
 
         MAGNUM_ASTCIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
+        MAGNUM_ASTCIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
         MAGNUM_ASTCIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
 
         MAGNUM_ASTCIMPORTER_LOCAL UnsignedInt doImage3DCount() const override;
+        MAGNUM_ASTCIMPORTER_LOCAL UnsignedInt doImage3DLevelCount(UnsignedInt id) override;
         MAGNUM_ASTCIMPORTER_LOCAL Containers::Optional<ImageData3D> doImage3D(UnsignedInt id, UnsignedInt level) override;
 
         struct State;
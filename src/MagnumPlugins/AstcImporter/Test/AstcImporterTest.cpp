@@ -33,7 +33,9 @@
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
+#include <Magnum/FileCallback.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
@@ -64,6 +66,14 @@ struct AstcImporterTest: TestSuite::Tester {
     void fileTooLong2D();
     void fileTooLong3D();
 
+    void zeroCopy2D();
+    void zeroCopy3D();
+
+    void mipChain();
+    void mipChainArray();
+    void mipChainNoFiles();
+    void mipChainInvalid();
+
     void openMemory();
     void openTwice();
     void importTwice();
@@ -153,6 +163,56 @@ const struct {
     {"quiet", ImporterFlag::Quiet, true}
 };
 
+const struct {
+    const char* name;
+    UnsignedInt fileCount;
+    UnsignedInt expectedLevelCount;
+    const char* expectedRequested;
+} MipChainData[]{
+    {"no files", 0, 1,
+        "image-1.astc "},
+    {"partial chain", 2, 3,
+        "image-1.astc image-2.astc image-3.astc "},
+    /* 64x32, 32x16, 16x8, 8x4, 4x2, 2x1, 1x1 */
+    {"full chain", 6, 7,
+        "image-1.astc image-2.astc image-3.astc image-4.astc image-5.astc image-6.astc "},
+    /* Files past the 1x1 level shouldn't get even looked at */
+    {"more files than levels", 8, 7,
+        "image-1.astc image-2.astc image-3.astc image-4.astc image-5.astc image-6.astc "},
+};
+
+const struct {
+    const char* name;
+    Vector3ub blockSize;
+    Vector3i size;
+    std::size_t dataSize;
+    const char* message;
+} MipChainInvalidData[]{
+    {"different block size", {6, 6, 1}, {32, 16, 1}, 16 + 6*3*16,
+        "level 1 file image-1.astc: expected block size {8, 8, 1} but got {6, 6, 1}"},
+    {"wrong size", {8, 8, 1}, {32, 32, 1}, 16 + 4*4*16,
+        "level 1 file image-1.astc: expected size {32, 16, 1} but got {32, 32, 1}"},
+    {"file too short", {8, 8, 1}, {32, 16, 1}, 16 + 4*2*16 - 1,
+        "level 1 file image-1.astc: file too short, expected 144 bytes but got 143"},
+};
+
+/* Creates an ASTC file with given block size and image size, with block data
+   filled with given value */
+Containers::Array<char> astcFile(const Vector3ub& blockSize, const Vector3i& size, char fill, std::size_t dataSize = ~std::size_t{}) {
+    const Vector3i blockCount = (size + Vector3i{blockSize} - Vector3i{1})/Vector3i{blockSize};
+    if(dataSize == ~std::size_t{})
+        dataSize = 16 + blockCount.product()*16;
+    Containers::Array<char> out{DirectInit, dataSize, fill};
+    Utility::copy(Containers::arrayView("\x13\xAB\xA1\x5C", 4), out.prefix(4));
+    for(std::size_t i = 0; i != 3; ++i) {
+        out[4 + i] = blockSize[i];
+        out[7 + i*3 + 0] = size[i] & 0xff;
+        out[7 + i*3 + 1] = (size[i] >> 8) & 0xff;
+        out[7 + i*3 + 2] = (size[i] >> 16) & 0xff;
+    }
+    return out;
+}
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -196,6 +256,20 @@ AstcImporterTest::AstcImporterTest() {
         &AstcImporterTest::fileTooLong3D},
         Containers::arraySize(QuietData));
 
+    addInstancedTests({&AstcImporterTest::zeroCopy2D},
+        Containers::arraySize(OpenMemoryData));
+
+    addTests({&AstcImporterTest::zeroCopy3D});
+
+    addInstancedTests({&AstcImporterTest::mipChain},
+        Containers::arraySize(MipChainData));
+
+    addTests({&AstcImporterTest::mipChainArray,
+              &AstcImporterTest::mipChainNoFiles});
+
+    addInstancedTests({&AstcImporterTest::mipChainInvalid},
+        Containers::arraySize(MipChainInvalidData));
+
     addInstancedTests({&AstcImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
@@ -541,6 +615,176 @@ void AstcImporterTest::fileTooLong3D() {
     }), TestSuite::Compare::Container);
 }
 
+void AstcImporterTest::zeroCopy2D() {
+    auto&& data = OpenMemoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(ASTCIMPORTER_TEST_DIR, "8x8.astc"));
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(data.open(*importer, *memory));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Astc8x8RGBAUnorm);
+    CORRADE_COMPARE(image->size(), (Vector2i{64, 32}));
+    CORRADE_COMPARE(image->data().size(), 8*4*128/8);
+    CORRADE_COMPARE(image->data()[1], '\x84');
+
+    /* With openMemory() (the second instance) the data should be referenced
+       directly from the passed memory, with openData() from the internal
+       copy */
+    if(testCaseInstanceId() == 1)
+        CORRADE_COMPARE(static_cast<const void*>(image->data().data()), static_cast<const void*>(memory->data() + 16));
+    else
+        CORRADE_VERIFY(static_cast<const void*>(image->data().data()) != static_cast<const void*>(memory->data() + 16));
+
+    /* Importing the second time references the same data */
+    Containers::Optional<Trade::ImageData2D> image2 = importer->image2D(0);
+    CORRADE_VERIFY(image2);
+    CORRADE_COMPARE(static_cast<const void*>(image2->data().data()), static_cast<const void*>(image->data().data()));
+}
+
+void AstcImporterTest::zeroCopy3D() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASTCIMPORTER_TEST_DIR, "3x3x3.astc")));
+
+    Containers::Optional<Trade::ImageData3D> image = importer->image3D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+    CORRADE_COMPARE(image->flags(), ImageFlags3D{});
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Astc3x3x3RGBAUnorm);
+    CORRADE_COMPARE(image->size(), (Vector3i{27, 27, 3}));
+    CORRADE_COMPARE(image->data().size(), 9*9*1*128/8);
+}
+
+void AstcImporterTest::mipChain() {
+    auto&& data = MipChainData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* The base level is 64x32 with 8x8 blocks, each further level is half
+       the size and filled with a different value to distinguish them */
+    struct Files {
+        Containers::Array<char> base;
+        Containers::Array<char> levels[8];
+        UnsignedInt levelCount;
+        Containers::String requested;
+    } files;
+    files.base = astcFile({8, 8, 1}, {64, 32, 1}, 'b');
+    for(UnsignedInt i = 0; i != data.fileCount; ++i)
+        files.levels[i] = astcFile({8, 8, 1}, Math::max(Vector3i{64 >> (i + 1), 32 >> (i + 1), 1}, Vector3i{1}), 'c' + i);
+    files.levelCount = data.fileCount;
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    importer->configuration().setValue("mipLevelFilename", "{0}-{1}.astc");
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, Files& files) -> Containers::Optional<Containers::ArrayView<const char>> {
+        if(filename == "image.astc")
+            return Containers::arrayView(files.base);
+        /* The additional levels are expected to stay in memory */
+        CORRADE_INTERNAL_ASSERT(policy == InputFileCallbackPolicy::LoadPermanent);
+        files.requested = Utility::format("{}{} ", files.requested, filename);
+        for(UnsignedInt i = 0; i != files.levelCount; ++i)
+            if(filename == Utility::formatString("image-{}.astc", i + 1))
+                return Containers::arrayView(files.levels[i]);
+        return {};
+    }, files);
+
+    CORRADE_VERIFY(importer->openFile("image.astc"));
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    CORRADE_COMPARE(importer->image2DLevelCount(0), data.expectedLevelCount);
+
+    for(UnsignedInt i = 0; i != data.expectedLevelCount; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Astc8x8RGBAUnorm);
+        CORRADE_COMPARE(image->size(), Math::max(Vector2i{64 >> i, 32 >> i}, Vector2i{1}));
+        CORRADE_COMPARE(image->data()[0], i ? char('c' + i - 1) : 'b');
+    }
+
+    /* The file after the last level is looked for, but only if the last
+       level isn't 1x1 yet */
+    CORRADE_COMPARE(files.requested, data.expectedRequested);
+}
+
+void AstcImporterTest::mipChainArray() {
+    /* A 2D array, only the XY size gets halved */
+    struct Files {
+        Containers::Array<char> base;
+        Containers::Array<char> level;
+    } files;
+    files.base = astcFile({4, 4, 1}, {8, 4, 3}, 'b');
+    files.level = astcFile({4, 4, 1}, {4, 2, 3}, 'c');
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    importer->configuration().setValue("mipLevelFilename", "{0}.{1}.astc");
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy, Files& files) -> Containers::Optional<Containers::ArrayView<const char>> {
+        if(filename == "array.astc")
+            return Containers::arrayView(files.base);
+        if(filename == "array.1.astc")
+            return Containers::arrayView(files.level);
+        return {};
+    }, files);
+
+    CORRADE_VERIFY(importer->openFile("array.astc"));
+    CORRADE_COMPARE(importer->image3DCount(), 1);
+    CORRADE_COMPARE(importer->image3DLevelCount(0), 2);
+
+    Containers::Optional<Trade::ImageData3D> image = importer->image3D(0, 1);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->flags(), ImageFlag3D::Array);
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Astc4x4RGBAUnorm);
+    CORRADE_COMPARE(image->size(), (Vector3i{4, 2, 3}));
+    CORRADE_COMPARE(image->data()[0], 'c');
+}
+
+void AstcImporterTest::mipChainNoFiles() {
+    /* There are no sibling files on the filesystem, so it should just stay
+       with a single level */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    importer->configuration().setValue("mipLevelFilename", "{0}-level{1}.astc");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ASTCIMPORTER_TEST_DIR, "8x8.astc")));
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 1);
+}
+
+void AstcImporterTest::mipChainInvalid() {
+    auto&& data = MipChainInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    struct Files {
+        Containers::Array<char> base;
+        Containers::Array<char> level;
+    } files;
+    files.base = astcFile({8, 8, 1}, {64, 32, 1}, 'b');
+    files.level = astcFile(data.blockSize, data.size, 'c', data.dataSize);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    importer->configuration().setValue("mipLevelFilename", "{0}-{1}.astc");
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy, Files& files) -> Containers::Optional<Containers::ArrayView<const char>> {
+        if(filename == "image.astc")
+            return Containers::arrayView(files.base);
+        if(filename == "image-1.astc")
+            return Containers::arrayView(files.level);
+        return {};
+    }, files);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile("image.astc"));
+    CORRADE_VERIFY(!importer->isOpened());
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::AstcImporter::openFile(): {}\n", data.message));
+}
+
 void AstcImporterTest::openMemory() {
     /* same as (a subset of) twoDimensions() except that it uses openData() &
        openMemory() instead of openFile() to test data copying on import */
@@ -36,12 +36,39 @@
 #include <IL/il.h>
 #include <IL/ilu.h>
 
+#ifdef CORRADE_BUILD_MULTITHREADED
+#include <mutex>
+#endif
+
 #ifdef CORRADE_TARGET_WINDOWS
 #include <Corrade/Utility/Unicode.h>
 #endif
 
 namespace Magnum { namespace Trade {
 
+namespace {
+
+#ifdef CORRADE_BUILD_MULTITHREADED
+std::mutex devIlMutex;
+#endif
+
+/* DevIL has a global bound image and a global error stack, so every access
+   to it from all importer instances is serialized. The image is bound only
+   for the duration of the lock and unbound on destruction, before the lock
+   is released, so no instance can ever see an image bound by another. */
+struct DevIlLock {
+    explicit DevIlLock() = default;
+
+    /* Rebinds the default image */
+    ~DevIlLock() { ilBindImage(0); }
+
+    #ifdef CORRADE_BUILD_MULTITHREADED
+    std::lock_guard<std::mutex> lock{devIlMutex};
+    #endif
+};
+
+}
+
 void DevIlImageImporter::initialize() {
     /* You are a funny devil, DevIL. No tutorials or docs mention this function
        (except for a tiny note at https://openil.sourceforge.net/tuts/tut_step/)
@@ -58,6 +85,7 @@ ImporterFeatures DevIlImageImporter::doFeatures() const { return ImporterFeature
 bool DevIlImageImporter::doIsOpened() const { return _image; }
 
 void DevIlImageImporter::doClose() {
+    DevIlLock lock;
     ilDeleteImages(1, &_image);
     _image = 0;
 }
@@ -66,16 +94,20 @@ void DevIlImageImporter::doClose() {
 static_assert(!IL_FALSE, "IL_FALSE doesn't have a zero value");
 
 void DevIlImageImporter::doOpenData(Containers::Array<char>&& data, DataFlags) {
+    const ILenum type = configuration().value<ILenum>("type", Utility::ConfigurationValueFlag::Hex);
+
+    DevIlLock lock;
     UnsignedInt image;
     ilGenImages(1, &image);
     ilBindImage(image);
 
     /* The documentation doesn't state if the data needs to stay in scope.
        Let's assume it doesn't. */
-    if(!ilLoadL(configuration().value<ILenum>("type", Utility::ConfigurationValueFlag::Hex), data.begin(), data.size())) {
+    if(!ilLoadL(type, data.begin(), data.size())) {
         /* iluGetString() returns empty string for 0x512, which is even more
            useless than just returning the error ID */
         Error() << "Trade::DevIlImageImporter::openData(): cannot open the image:" << Debug::hex << ilGetError();
+        ilDeleteImages(1, &image);
         return;
     }
 
@@ -84,11 +116,14 @@ void DevIlImageImporter::doOpenData(Containers::Array<char>&& data, DataFlags) {
 }
 
 void DevIlImageImporter::doOpenFile(const Containers::StringView filename) {
+    const ILenum type = configuration().value<ILenum>("type", Utility::ConfigurationValueFlag::Hex);
+
+    DevIlLock lock;
     UnsignedInt image;
     ilGenImages(1, &image);
     ilBindImage(image);
 
-    if(!ilLoad(configuration().value<ILenum>("type", Utility::ConfigurationValueFlag::Hex),
+    if(!ilLoad(type,
         #ifdef CORRADE_TARGET_WINDOWS
         Utility::Unicode::widen(filename).data()
         #else
@@ -98,6 +133,7 @@ void DevIlImageImporter::doOpenFile(const Containers::StringView filename) {
         /* iluGetString() returns empty string for 0x512, which is even more
            useless than just returning the error ID */
         Error() << "Trade::DevIlImageImporter::openFile(): cannot open the image:" << Debug::hex << ilGetError();
+        ilDeleteImages(1, &image);
         return;
     }
 
@@ -106,17 +142,17 @@ void DevIlImageImporter::doOpenFile(const Containers::StringView filename) {
 }
 
 UnsignedInt DevIlImageImporter::doImage2DCount() const {
-    /* Bind the image. This was done above already, but since it's a global
-       state, this avoids a mismatch in case there's more than one importer
-       active at a time. */
+    /* Bind the image. It's a global state, so it has to be done under the
+       lock every time. */
+    DevIlLock lock;
     ilBindImage(_image);
     return ilGetInteger(IL_NUM_IMAGES) + 1;
 }
 
 Containers::Optional<ImageData2D> DevIlImageImporter::doImage2D(UnsignedInt id, UnsignedInt) {
-    /* Bind the image. This was done above already, but since it's a global
-       state, this avoids a mismatch in case there's more than one importer
-       active at a time. */
+    /* Bind the image. It's a global state, so it has to be done under the
+       lock every time. */
+    DevIlLock lock;
     ilBindImage(_image);
     ilActiveImage(id);
 
@@ -179,9 +215,12 @@ Containers::Optional<ImageData2D> DevIlImageImporter::doImage2D(UnsignedInt id,
         return Containers::NullOpt;
     }
 
-    /* Copy the data into array that is owned by us and not by IL. Make a 2D
-       view so we can flip the image to have the origin bottom left. */
-    Containers::Array<char> imageData{std::size_t(size.product()*components)};
+    /* Copy the data into array that is owned by us and not by IL, as the IL
+       memory is freed together with the image and a plugin can't return an
+       array with a custom deleter anyway. The copy overwrites everything so
+       the allocation doesn't need to be zero-initialized. Make a 2D view so
+       we can flip the image to have the origin bottom left while copying. */
+    Containers::Array<char> imageData{NoInit, std::size_t(size.product()*components)};
     Containers::StridedArrayView2D<const char> src{
         Containers::arrayView(reinterpret_cast<const char*>(ilGetData()), ilGetInteger(IL_IMAGE_SIZE_OF_DATA)),
         {std::size_t(size.y()), std::size_t(size.x()*components)}};
@@ -181,6 +181,14 @@ to @ref PixelFormat::RGBA8Unorm. Images are imported with default
 @ref PixelStorage parameters except for alignment, which may be changed to `1`
 if the data require it.
 
+@subsection Trade-DevIlImageImporter-behavior-multithreading Thread safety
+
+DevIL has a single global state, including the currently bound image. If
+@ref CORRADE_BUILD_MULTITHREADED is enabled, all access to it from all plugin
+instances is guarded by a mutex, so it's safe to use multiple instances from
+different threads. The library isn't reentrant however, so the file opening
+and import is serialized, not executed in parallel.
+
 @subsection Trade-DevIlImageImporter-behavior-dds Compressed DDS files
 
 DDS files with BCn compression are always decompressed to RGBA on input.
@@ -39,6 +39,10 @@
 
 #include "configure.h"
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include <thread>
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct DevIlImageImporterTest: TestSuite::Tester {
@@ -65,6 +69,9 @@ struct DevIlImageImporterTest: TestSuite::Tester {
     void openTwice();
     void importTwice();
     void twoImporters();
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    void twoImportersMultithreaded();
+    #endif
 
     void utf8Filename();
 
@@ -111,9 +118,13 @@ DevIlImageImporterTest::DevIlImageImporterTest() {
 
               &DevIlImageImporterTest::openTwice,
               &DevIlImageImporterTest::importTwice,
-              &DevIlImageImporterTest::twoImporters,
+              &DevIlImageImporterTest::twoImporters});
+
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    addRepeatedTests({&DevIlImageImporterTest::twoImportersMultithreaded}, 10);
+    #endif
 
-              &DevIlImageImporterTest::utf8Filename});
+    addTests({&DevIlImageImporterTest::utf8Filename});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -458,6 +469,51 @@ void DevIlImageImporterTest::twoImporters() {
     CORRADE_COMPARE(imageB->pixels<Color4ub>()[0][0], 0x87ceeb_rgb);
 }
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void DevIlImageImporterTest::twoImportersMultithreaded() {
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
+    #endif
+
+    Containers::Pointer<AbstractImporter> a = _manager.instantiate("DevIlImageImporter");
+    Containers::Pointer<AbstractImporter> b = _manager.instantiate("DevIlImageImporter");
+
+    /* Like twoImporters(), but with each importer repeatedly opening and
+       importing its file in a separate thread. Counting only imports that
+       produced the expected result, as the test macros can't be used from
+       other threads. */
+    int counterA = 0, counterB = 0;
+    {
+        std::thread threadA{[&]() {
+            const Containers::String filename = Utility::Path::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg");
+            for(std::size_t i = 0; i != 100; ++i) {
+                if(!a->openFile(filename) || a->image2DCount() != 1)
+                    continue;
+                Containers::Optional<Trade::ImageData2D> image = a->image2D(0);
+                if(image && image->size() == Vector2i{3, 2} && image->pixels<Color3ub>()[0][0] == 0xcafe76_rgb)
+                    ++counterA;
+            }
+        }};
+        std::thread threadB{[&]() {
+            const Containers::String filename = Utility::Path::join(STBIMAGEIMPORTER_TEST_DIR, "dispose_bgnd.gif");
+            for(std::size_t i = 0; i != 100; ++i) {
+                if(!b->openFile(filename) || b->image2DCount() != 5)
+                    continue;
+                Containers::Optional<Trade::ImageData2D> image = b->image2D(0);
+                if(image && image->size() == Vector2i{100, 100} && image->pixels<Color4ub>()[0][0] == 0x87ceebff_rgba)
+                    ++counterB;
+            }
+        }};
+
+        threadA.join();
+        threadB.join();
+    }
+
+    CORRADE_COMPARE(counterA, 100);
+    CORRADE_COMPARE(counterB, 100);
+}
+#endif
+
 void DevIlImageImporterTest::utf8Filename() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DevIlImageImporter");
 
@@ -28,6 +28,7 @@
 
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
 
@@ -56,54 +57,129 @@ constexpr BufferFormat Mp3FormatTable[8]{
 
 }
 
+struct DrMp3Importer::State {
+    /* The decoder references this, so it has to stay alive for the whole
+       lifetime of the opened file */
+    Containers::Array<char> in;
+    drmp3 mp3;
+    /* Referenced by the decoder as well */
+    Containers::Array<drmp3_seek_point> seekPoints;
+    UnsignedLong frameCount;
+    BufferFormat format;
+    UnsignedInt channelCount;
+    UnsignedInt frequency;
+    /* drmp3_init_memory() calls drmp3_uninit() on failure already, calling
+       it again would result in a double free */
+    bool initialized;
+
+    ~State() {
+        if(initialized) drmp3_uninit(&mp3);
+    }
+};
+
 DrMp3Importer::DrMp3Importer() = default;
 
 DrMp3Importer::DrMp3Importer(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
+DrMp3Importer::~DrMp3Importer() = default;
+
 ImporterFeatures DrMp3Importer::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool DrMp3Importer::doIsOpened() const { return !!_data; }
+bool DrMp3Importer::doIsOpened() const { return !!_state; }
 
 void DrMp3Importer::doOpenData(Containers::ArrayView<const char> data) {
-    drmp3_config config;
-    config.outputChannels = config.outputSampleRate = 0;
-    drmp3_uint64 frameCount;
-
-    drmp3_int16* const decodedPointer = drmp3_open_memory_and_read_s16(data.data(), data.size(), &config, &frameCount);
-    if(!decodedPointer) {
+    /* The decoder doesn't make a copy of the data, so we have to. Allocate
+       the state on heap first as the decoder stores a pointer to itself. All
+       members are zero-initialized. */
+    Containers::Pointer<State> state{InPlaceInit};
+    state->in = Containers::Array<char>{NoInit, data.size()};
+    Utility::copy(data, state->in);
+
+    /* drmp3_init_memory() decodes the first frame to verify the stream is
+       valid, so this fails also for files with zero frames */
+    if(!drmp3_init_memory(&state->mp3, state->in.data(), state->in.size(), nullptr)) {
         Error() << "Audio::DrMp3Importer::openData(): failed to open and decode MP3 data";
         return;
     }
+    state->initialized = true;
 
-    const std::uint32_t numChannels = config.outputChannels;
-    Containers::Array<char> decodedData{reinterpret_cast<char*>(decodedPointer), std::size_t(frameCount*sizeof(Short)*numChannels), [](char* data, std::size_t) {
-        drmp3_free(data);
-    }};
-
+    const UnsignedInt numChannels = state->mp3.channels;
     if(numChannels == 0 || numChannels == 3 || numChannels == 5 || numChannels > 8) {
         Error() << "Audio::DrMp3Importer::openData(): unsupported channel count"
                 << numChannels;
         return;
     }
 
-    _frequency = config.outputSampleRate;
-    _format = Mp3FormatTable[numChannels - 1];
-    CORRADE_INTERNAL_ASSERT(_format != BufferFormat{});
+    /* Count the frames. This only parses the MP3 frame headers, no decoding
+       is done. */
+    drmp3_uint64 frameCount;
+    if(!drmp3_get_mp3_and_pcm_frame_count(&state->mp3, nullptr, &frameCount)) {
+        Error() << "Audio::DrMp3Importer::openData(): failed to calculate frame count";
+        return;
+    }
+
+    /* Calculate the seek table, if desired. The count gets adjusted to what
+       makes sense for given stream, which is at most the MP3 frame count. */
+    if(drmp3_uint32 seekPointCount = configuration().value<UnsignedInt>("seekPointCount")) {
+        state->seekPoints = Containers::Array<drmp3_seek_point>{NoInit, seekPointCount};
+        if(!drmp3_calculate_seek_points(&state->mp3, &seekPointCount, state->seekPoints.data()) ||
+           !drmp3_bind_seek_table(&state->mp3, seekPointCount, state->seekPoints.data())) {
+            Error() << "Audio::DrMp3Importer::openData(): failed to calculate a seek table";
+            return;
+        }
+    }
+
+    state->frameCount = frameCount;
+    state->channelCount = numChannels;
+    state->frequency = state->mp3.sampleRate;
+    state->format = Mp3FormatTable[numChannels - 1];
+    CORRADE_INTERNAL_ASSERT(state->format != BufferFormat{});
 
-    /* All good, save the data */
-    _data = Utility::move(decodedData);
+    /* All good, save the state */
+    _state = Utility::move(state);
 }
 
-void DrMp3Importer::doClose() { _data = Containers::NullOpt; }
+void DrMp3Importer::doClose() { _state = nullptr; }
 
-BufferFormat DrMp3Importer::doFormat() const { return _format; }
+BufferFormat DrMp3Importer::doFormat() const { return _state->format; }
 
-UnsignedInt DrMp3Importer::doFrequency() const { return _frequency; }
+UnsignedInt DrMp3Importer::doFrequency() const { return _state->frequency; }
 
 Containers::Array<char> DrMp3Importer::doData() {
-    Containers::Array<char> copy{NoInit, _data->size()};
-    Utility::copy(*_data, copy);
-    return copy;
+    const UnsignedLong startFrame = configuration().value<UnsignedLong>("startFrame");
+    UnsignedLong frameCount = configuration().value<UnsignedLong>("frameCount");
+    if(startFrame > _state->frameCount) {
+        Error() << "Audio::DrMp3Importer::data(): start frame" << startFrame << "out of range for" << _state->frameCount << "frames";
+        return {};
+    }
+    if(!frameCount)
+        frameCount = _state->frameCount - startFrame;
+    else if(frameCount > _state->frameCount - startFrame) {
+        Error() << "Audio::DrMp3Importer::data(): frame range [" << Debug::nospace << startFrame << Debug::nospace << "," << startFrame + frameCount << Debug::nospace << ") out of range for" << _state->frameCount << "frames";
+        return {};
+    }
+
+    /* Uses the seek table if present, otherwise it decodes everything from
+       the start (or from the current position, if before the target) */
+    if(!drmp3_seek_to_pcm_frame(&_state->mp3, startFrame)) {
+        Error() << "Audio::DrMp3Importer::data(): failed to seek to frame" << startFrame;
+        return {};
+    }
+
+    const std::size_t frameSize = sizeof(Short)*_state->channelCount;
+    Containers::Array<char> out{NoInit, std::size_t(frameCount*frameSize)};
+    const UnsignedLong decodedFrameCount = drmp3_read_pcm_frames_s16(&_state->mp3, frameCount, reinterpret_cast<drmp3_int16*>(out.data()));
+
+    /* The frame count calculated on open should match what's actually
+       decoded, but if the stream has a variable sample rate it may differ
+       due to rounding. Shrink the output in that case. */
+    if(decodedFrameCount != frameCount) {
+        Containers::Array<char> shrunk{NoInit, std::size_t(decodedFrameCount*frameSize)};
+        Utility::copy(out.prefix(shrunk.size()), shrunk);
+        return shrunk;
+    }
+
+    return out;
 }
 
 }}
@@ -32,7 +32,7 @@
  */
 
 #include <Corrade/Containers/Array.h>
-#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/DrMp3AudioImporter/configure.h"
@@ -125,6 +125,29 @@ The files are imported as @ref BufferFormat::Mono16,
 @ref BufferFormat::Stereo16, @ref BufferFormat::Quad16,
 @ref BufferFormat::Surround51Channel16, @ref BufferFormat::Surround61Channel16
 or @ref BufferFormat::Surround71Channel16.
+
+The file is only parsed on open, decoding is deferred to @ref data(). By
+default the whole stream is decoded, a subrange of PCM frames can be selected
+using the @cb{.ini} startFrame @ce and @cb{.ini} frameCount @ce
+@ref Audio-DrMp3Importer-configuration "configuration options", which are
+read on every @ref data() call. In order to make decoding from an arbitrary
+position fast, a seek table with @cb{.ini} seekPointCount @ce entries is
+calculated on open and kept for the whole lifetime of the opened file, so
+only a few MP3 frames preceding the requested position need to be decoded
+instead of everything from the start of the stream. The seek table
+calculation only parses MP3 frame headers and doesn't involve any audio
+decoding. Note that if the stream has a variable sample rate, seeking may
+not be sample-exact.
+
+@section Audio-DrMp3Importer-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/DrMp3AudioImporter/DrMp3Importer.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_DRMP3AUDIOIMPORTER_EXPORT DrMp3Importer: public AbstractImporter {
     public:
@@ -134,6 +157,8 @@ class MAGNUM_DRMP3AUDIOIMPORTER_EXPORT DrMp3Importer: public AbstractImporter {
         /** @brief Plugin manager constructor */
         explicit DrMp3Importer(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        ~DrMp3Importer();
+
     private:
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL bool doIsOpened() const override;
@@ -144,9 +169,8 @@ class MAGNUM_DRMP3AUDIOIMPORTER_EXPORT DrMp3Importer: public AbstractImporter {
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL UnsignedInt doFrequency() const override;
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
 
-        Containers::Optional<Containers::Array<char>> _data;
-        BufferFormat _format;
-        UnsignedInt _frequency;
+        struct State;
+        Containers::Pointer<State> _state;
 };
 
 }}
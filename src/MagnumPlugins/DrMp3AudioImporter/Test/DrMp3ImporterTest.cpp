@@ -31,6 +31,7 @@
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Magnum/Audio/AbstractImporter.h>
@@ -39,6 +40,17 @@
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
 
+const struct {
+    const char* name;
+    UnsignedInt seekPointCount;
+} FrameRangeData[]{
+    {"no seek table", 0},
+    {"single seek point", 1},
+    {"default seek table", 64},
+    /* dr_mp3 clamps this to the MP3 frame count */
+    {"more seek points than frames", 100000},
+};
+
 struct DrMp3ImporterTest: TestSuite::Tester {
     explicit DrMp3ImporterTest();
 
@@ -49,6 +61,11 @@ struct DrMp3ImporterTest: TestSuite::Tester {
     void mono16();
     void stereo16();
 
+    void frameRange();
+    void frameRangeUntilEnd();
+    void frameRangeStartOutOfRange();
+    void frameRangeCountOutOfRange();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -61,6 +78,13 @@ DrMp3ImporterTest::DrMp3ImporterTest() {
               &DrMp3ImporterTest::mono16,
               &DrMp3ImporterTest::stereo16});
 
+    addInstancedTests({&DrMp3ImporterTest::frameRange},
+        Containers::arraySize(FrameRangeData));
+
+    addTests({&DrMp3ImporterTest::frameRangeUntilEnd,
+              &DrMp3ImporterTest::frameRangeStartOutOfRange,
+              &DrMp3ImporterTest::frameRangeCountOutOfRange});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef DRMP3AUDIOIMPORTER_PLUGIN_FILENAME
@@ -119,6 +143,76 @@ void DrMp3ImporterTest::stereo16() {
         }), TestSuite::Compare::Container);
 }
 
+void DrMp3ImporterTest::frameRange() {
+    auto&& data = FrameRangeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    importer->configuration().setValue("seekPointCount", data.seekPointCount);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRMP3AUDIOIMPORTER_TEST_DIR, "stereo16.mp3")));
+
+    /* Decode the whole stream for comparison. It's 6912 frames in total,
+       four bytes each. */
+    Containers::Array<char> full = importer->data();
+    CORRADE_COMPARE(full.size(), 6912*4);
+
+    importer->configuration().setValue("startFrame", 3000);
+    importer->configuration().setValue("frameCount", 1000);
+    CORRADE_COMPARE_AS(importer->data(),
+        full.slice(3000*4, 4000*4),
+        TestSuite::Compare::Container);
+
+    /* Seeking backwards should work as well */
+    importer->configuration().setValue("startFrame", 1200);
+    importer->configuration().setValue("frameCount", 5);
+    CORRADE_COMPARE_AS(importer->data(),
+        full.slice(1200*4, 1205*4),
+        TestSuite::Compare::Container);
+}
+
+void DrMp3ImporterTest::frameRangeUntilEnd() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRMP3AUDIOIMPORTER_TEST_DIR, "mono16.mp3")));
+
+    /* Frame count being 0 means until the end */
+    importer->configuration().setValue("startFrame", 3360);
+    Containers::Array<char> data = importer->data();
+    CORRADE_COMPARE(data.size(), 13824 - 6720);
+    CORRADE_COMPARE_AS(Containers::arrayCast<UnsignedShort>(data.prefix(4)),
+        Containers::arrayView<UnsignedShort>({
+            0x0332, 0x099c
+        }), TestSuite::Compare::Container);
+
+    /* Starting at the end gives back an empty array */
+    importer->configuration().setValue("startFrame", 6912);
+    CORRADE_VERIFY(importer->data().isEmpty());
+}
+
+void DrMp3ImporterTest::frameRangeStartOutOfRange() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRMP3AUDIOIMPORTER_TEST_DIR, "mono16.mp3")));
+
+    importer->configuration().setValue("startFrame", 6913);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(importer->data().isEmpty());
+    CORRADE_COMPARE(out.str(), "Audio::DrMp3Importer::data(): start frame 6913 out of range for 6912 frames\n");
+}
+
+void DrMp3ImporterTest::frameRangeCountOutOfRange() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DRMP3AUDIOIMPORTER_TEST_DIR, "mono16.mp3")));
+
+    importer->configuration().setValue("startFrame", 6000);
+    importer->configuration().setValue("frameCount", 913);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(importer->data().isEmpty());
+    CORRADE_COMPARE(out.str(), "Audio::DrMp3Importer::data(): frame range [6000, 6913) out of range for 6912 frames\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::DrMp3ImporterTest)
@@ -25,17 +25,130 @@
 
 #include "Faad2Importer.h"
 
+#include <thread> /* std::thread::hardware_concurrency(), sigh */
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/ScopeGuard.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
+#include <Magnum/Math/Functions.h>
 
 #include <neaacdec.h>
 
 namespace Magnum { namespace Audio {
 
+namespace {
+
+/* https://wiki.multimedia.cx/index.php/ADTS */
+constexpr std::size_t AdtsHeaderSize = 7;
+
+constexpr UnsignedInt AdtsSampleRates[]{
+    96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000,
+    11025, 8000, 7350
+};
+
+struct AdtsFrame {
+    std::size_t offset;
+    std::size_t size;
+};
+
+struct AdtsStream {
+    Containers::Array<AdtsFrame> frames;
+    /* Audio object type minus one, 1 is AAC LC */
+    UnsignedByte profile;
+    UnsignedInt sampleRate;
+    /* Each raw data block has 1024 samples per channel */
+    UnsignedInt rawDataBlockCount;
+};
+
+/* Scans headers of all ADTS frames in the stream. Returns an empty frame list
+   if the data isn't an ADTS stream or if the frames differ in properties that
+   affect the output size, in which case the stream is decoded the slow
+   way. */
+AdtsStream scanAdtsFrames(const Containers::ArrayView<const char> data) {
+    const auto bytes = Containers::arrayCast<const UnsignedByte>(data);
+
+    AdtsStream out{};
+    for(std::size_t pos = 0; pos != bytes.size(); ) {
+        /* 12-bit syncword */
+        if(bytes.size() - pos < AdtsHeaderSize || bytes[pos] != 0xff || (bytes[pos + 1] & 0xf0) != 0xf0)
+            return {};
+
+        const UnsignedByte profile = bytes[pos + 2] >> 6;
+        const UnsignedByte sampleRateIndex = (bytes[pos + 2] >> 2) & 0x0f;
+        const std::size_t size =
+            (std::size_t(bytes[pos + 3] & 0x03) << 11)|
+            (std::size_t(bytes[pos + 4]) << 3)|
+            (std::size_t(bytes[pos + 5]) >> 5);
+        const UnsignedInt rawDataBlockCount = (bytes[pos + 6] & 0x03) + 1;
+        if(sampleRateIndex >= Containers::arraySize(AdtsSampleRates) || size < AdtsHeaderSize || size > bytes.size() - pos)
+            return {};
+
+        if(out.frames.isEmpty()) {
+            out.profile = profile;
+            out.sampleRate = AdtsSampleRates[sampleRateIndex];
+            out.rawDataBlockCount = rawDataBlockCount;
+        } else if(profile != out.profile || AdtsSampleRates[sampleRateIndex] != out.sampleRate || rawDataBlockCount != out.rawDataBlockCount)
+            return {};
+
+        arrayAppend(out.frames, InPlaceInit, pos, size);
+        pos += size;
+    }
+
+    return out;
+}
+
+enum class SegmentResult {
+    Success,
+    DecodingError,
+    UnexpectedSampleCount,
+    /* SBR or PS state carries over across many frames, so a segment primed
+       with just a single frame isn't the same as serial decoding */
+    DependentFrames
+};
+
+/* Decodes frames [begin, end) into the output, where the output is expected
+   to be sized for exactly that many frames. Decoding starts at frame
+   begin - 1 to prime the decoder state, and FAAD2 itself discards output of
+   the first decoded frame, so begin is expected to be at least 1. */
+SegmentResult decodeSegment(const Containers::ArrayView<const char> data, const Containers::ArrayView<const AdtsFrame> frames, const std::size_t begin, const std::size_t end, const std::size_t samplesPerFrame, const Containers::ArrayView<UnsignedShort> output) {
+    CORRADE_INTERNAL_ASSERT(begin >= 1 && end > begin && output.size() == (end - begin)*samplesPerFrame);
+
+    const NeAACDecHandle decoder = NeAACDecOpen();
+    Containers::ScopeGuard exit{decoder, NeAACDecClose};
+
+    unsigned char* const input = const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.data()));
+    unsigned long samplerate = 0;
+    unsigned char channels = 0;
+    if(NeAACDecInit(decoder, input + frames[begin - 1].offset, frames[begin - 1].size, &samplerate, &channels) < 0)
+        return SegmentResult::DecodingError;
+
+    for(std::size_t i = begin - 1; i != end; ++i) {
+        NeAACDecFrameInfo info;
+        void* sampleBuffer = NeAACDecDecode(decoder, &info, input + frames[i].offset, frames[i].size);
+        if(info.error)
+            return SegmentResult::DecodingError;
+        if(info.sbr != NO_SBR || info.ps)
+            return SegmentResult::DependentFrames;
+
+        /* Output of the pre-roll frame is only used to prime the decoder
+           state. FAAD2 produces no samples for it anyway. */
+        if(i == begin - 1) continue;
+
+        if(info.samples != samplesPerFrame)
+            return SegmentResult::UnexpectedSampleCount;
+        Utility::copy(
+            {reinterpret_cast<UnsignedShort*>(sampleBuffer), info.samples},
+            output.slice((i - begin)*samplesPerFrame, (i - begin + 1)*samplesPerFrame));
+    }
+
+    return SegmentResult::Success;
+}
+
+}
+
 Faad2Importer::Faad2Importer() = default;
 
 Faad2Importer::Faad2Importer(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
@@ -78,9 +191,70 @@ void Faad2Importer::doOpenData(Containers::ArrayView<const char> data) {
         return;
     }
 
-    /** @todo s there any way to get the sample count beforehand? the faad
-        fronted does it by manually parsing the headers and NO WAY IN HELL i
-        am doing that here: https://github.com/knik0/faad2/blob/7da4a83b230d069a9d731b1e64f6e6b52802576a/frontend/main.c#L613-L630 */
+    /* If the file is an ADTS stream, scan all frame headers first to know
+       the exact output size. FAAD2 produces no output for the first frame,
+       so there's one frame less in the output. */
+    const AdtsStream adts = scanAdtsFrames(data);
+    if(adts.frames.size() >= 2) {
+        /* In case of implicit SBR the output sample rate is twice the one in
+           the header, and so is the sample count in each frame */
+        const bool implicitSbr = samplerate != adts.sampleRate;
+        const std::size_t samplesPerFrame = 1024*adts.rawDataBlockCount*channels*(implicitSbr ? 2 : 1);
+        const std::size_t outputFrameCount = adts.frames.size() - 1;
+        Containers::Array<UnsignedShort> samples{NoInit, outputFrameCount*samplesPerFrame};
+
+        /* Split the stream into segments, each decoded by a separate decoder
+           instance in its own thread. A single preceding frame is enough to
+           prime the decoder state only for AAC LC, profiles such as AAC Main
+           or LTP carry the prediction state across many frames, and so does
+           SBR in HE-AAC streams, so those are always decoded serially. If
+           SBR or PS is signaled explicitly and not detected from the sample
+           rate, decodeSegment() bails and it falls back to serial decoding
+           below. Value of 0 means hardware concurrency,
+           consistently with OpenExrImporter and BasisImageConverter. */
+        std::size_t threadCount = configuration().value<UnsignedInt>("threads");
+        if(!threadCount) threadCount = std::thread::hardware_concurrency();
+        const std::size_t minFramesPerThread = Math::max(configuration().value<UnsignedInt>("minFramesPerThread"), 1u);
+        const std::size_t segmentCount = adts.profile != 1 || implicitSbr ? 1 :
+            Math::max(Math::min(threadCount, outputFrameCount/minFramesPerThread), std::size_t{1});
+
+        /* Output frame i corresponds to ADTS frame i + 1 */
+        Containers::Array<SegmentResult> results{NoInit, segmentCount};
+        const auto decode = [&](const std::size_t segment) {
+            const std::size_t begin = segment*outputFrameCount/segmentCount;
+            const std::size_t end = (segment + 1)*outputFrameCount/segmentCount;
+            results[segment] = decodeSegment(data, adts.frames, begin + 1, end + 1, samplesPerFrame, samples.slice(begin*samplesPerFrame, end*samplesPerFrame));
+        };
+
+        /* The first segment is decoded on the calling thread */
+        Containers::Array<std::thread> threads{segmentCount - 1};
+        for(std::size_t i = 1; i < segmentCount; ++i)
+            threads[i - 1] = std::thread{decode, i};
+        decode(0);
+        for(std::thread& thread: threads)
+            thread.join();
+
+        bool fallback = false;
+        for(const SegmentResult segmentResult: results) {
+            if(segmentResult == SegmentResult::DecodingError) {
+                Error{} << "Audio::Faad2Importer::openData(): decoding error";
+                return;
+            }
+            if(segmentResult == SegmentResult::UnexpectedSampleCount ||
+               segmentResult == SegmentResult::DependentFrames)
+                fallback = true;
+        }
+
+        /* If the sample count estimated from the headers didn't match what
+           was actually decoded or the frames depend on each other more than
+           expected, fall back to decoding serially below */
+        if(!fallback) {
+            _samples = Utility::move(samples);
+            return;
+        }
+    }
+
+    /* Otherwise decode the stream serially, growing the output as needed */
     std::size_t pos = result;
     Containers::Array<UnsignedShort> samples;
     while(pos < data.size()) {
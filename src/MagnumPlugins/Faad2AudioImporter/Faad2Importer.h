@@ -119,6 +119,48 @@ information.
 @section Audio-Faad2Importer-behavior Behavior and limitations
 
 The files are always imported with @ref BufferFormat::Stereo16.
+
+If the file is an ADTS stream, headers of all frames are parsed first in order
+to allocate the output upfront. Additionally, AAC LC streams can be decoded in
+multiple threads by setting the @cb{.ini} threads @ce
+@ref Audio-Faad2Importer-configuration "configuration option" to a value
+other than @cpp 1 @ce. The stream is then split into contiguous segments of
+at least @cb{.ini} minFramesPerThread @ce frames, each decoded by a separate
+decoder instance that's primed with one preceding frame, giving the same
+output as serial decoding. Other profiles, HE-AAC streams with SBR or PS,
+raw AAC streams and ADIF files are always decoded serially, as their decoder
+state depends on more than one preceding frame.
+
+AAC LC streams that use perceptual noise substitution (PNS) are a
+limitation of the multithreaded decoding --- the substituted noise comes from
+a random generator that's local to each decoder instance, and since FAAD2
+doesn't report PNS usage, such streams aren't detected. The output is then a
+valid decode, but differs from serial decoding in the noise-substituted bands.
+Keep the @cb{.ini} threads @ce option at @cpp 1 @ce if bit-exact output is
+needed.
+
+@subsection Audio-Faad2Importer-behavior-loading Loading the plugin fails with undefined symbol: pthread_create
+
+On Linux it may happen that loading the plugin will fail with
+`undefined symbol: pthread_create`. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+plugin isn't linked to `pthread` and requires *the application* to link to it
+instead. With CMake it can be done like this:
+
+@code{.cmake}
+find_package(Threads REQUIRED)
+target_link_libraries(your-application PRIVATE Threads::Threads)
+@endcode
+
+@section Audio-Faad2Importer-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/Faad2AudioImporter/Faad2Importer.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_FAAD2AUDIOIMPORTER_EXPORT Faad2Importer: public AbstractImporter {
     public:
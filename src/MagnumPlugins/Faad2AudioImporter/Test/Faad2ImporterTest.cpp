@@ -25,9 +25,13 @@
 
 #include <sstream>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringStl.h> /** @todo remove once AbstractImporter is <string>-free */
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Magnum/ImageView.h>
@@ -39,6 +43,21 @@
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
 
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt frequency;
+    UnsignedInt threads;
+} ThreadsData[]{
+    {"two threads", "stereo.aac", 44100, 2},
+    {"three threads", "stereo.aac", 44100, 3},
+    /* Each thread has just one frame, the rest isn't used */
+    {"more threads than frames", "stereo.aac", 44100, 32},
+    {"hardware concurrency", "stereo.aac", 44100, 0},
+    {"mono, two threads", "mono.aac", 96000, 2},
+    {"mono, more threads than frames", "mono.aac", 96000, 32}
+};
+
 struct Faad2ImporterTest: TestSuite::Tester {
     explicit Faad2ImporterTest();
 
@@ -48,6 +67,8 @@ struct Faad2ImporterTest: TestSuite::Tester {
     void mono();
     void stereo();
 
+    void threads();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -59,6 +80,9 @@ Faad2ImporterTest::Faad2ImporterTest() {
               &Faad2ImporterTest::mono,
               &Faad2ImporterTest::stereo});
 
+    addInstancedTests({&Faad2ImporterTest::threads},
+        Containers::arraySize(ThreadsData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef FAAD2AUDIOIMPORTER_PLUGIN_FILENAME
@@ -142,6 +166,39 @@ void Faad2ImporterTest::stereo() {
         (DebugTools::CompareImage{1.0f, 0.625f}));
 }
 
+void Faad2ImporterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* The file has two ADTS frames, repeat it to have something to split
+       among threads */
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(FAAD2AUDIOIMPORTER_TEST_DIR, data.filename));
+    CORRADE_VERIFY(file);
+    Containers::Array<char> stream;
+    for(std::size_t i = 0; i != 8; ++i)
+        arrayAppend(stream, *file);
+
+    /* Decode serially for comparison */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    CORRADE_COMPARE(importer->configuration().value<UnsignedInt>("threads"), 1);
+    CORRADE_VERIFY(importer->openData(stream));
+    Containers::Array<char> expected = importer->data();
+    /* FAAD2 produces no output for the first frame */
+    CORRADE_COMPARE(expected.size(), 15*1024*2*2);
+
+    importer->configuration().setValue("threads", data.threads);
+    importer->configuration().setValue("minFramesPerThread", 1);
+    CORRADE_VERIFY(importer->openData(stream));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    CORRADE_COMPARE(importer->frequency(), data.frequency);
+
+    /* As the decoders are primed with a preceding frame, the output should
+       be exactly the same, sample for sample */
+    CORRADE_COMPARE_AS(importer->data(),
+        expected,
+        TestSuite::Compare::Container);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::Faad2ImporterTest)
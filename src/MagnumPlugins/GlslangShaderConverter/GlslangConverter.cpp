@@ -25,6 +25,10 @@
 
 #include "GlslangConverter.h"
 
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread> /* std::thread::hardware_concurrency(), sigh */
 #include <unordered_map>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
@@ -34,13 +38,22 @@
 #include <Corrade/Containers/StaticArray.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringIterable.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/Sha1.h>
 #include <Magnum/FileCallback.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/ShaderTools/Stage.h>
 
+#ifndef CORRADE_TARGET_WINDOWS
+#include <unistd.h> /* getpid() */
+#else
+#include <process.h> /* _getpid() */
+#endif
+
 #include <glslang/Public/ShaderLang.h> /* Haha what the fuck this name */
 /* This can't be <glslang/SPIRV/GlslangToSpv.h> because such path doesn't exist
    in the glslang repository itself, which means the plugin wouldn't build with
@@ -73,6 +86,18 @@
 
 namespace Magnum { namespace ShaderTools {
 
+namespace {
+
+/* Contents of included files shared across conversions if the cacheIncludes
+   option is enabled. Guarded by a mutex as convertDataToDataBatch() accesses
+   it from multiple threads. */
+struct IncludeCache {
+    std::mutex mutex;
+    std::unordered_map<std::string, Containers::Array<char>> files;
+};
+
+}
+
 struct GlslangConverter::State {
     Format inputFormat, outputFormat;
     Containers::String inputVersion, outputVersion;
@@ -83,6 +108,8 @@ struct GlslangConverter::State {
     std::string definitions;
 
     Containers::String debugInfo;
+
+    IncludeCache includeCache;
 };
 
 void GlslangConverter::initialize() {
@@ -117,18 +144,28 @@ void GlslangConverter::doSetOutputFormat(const Format format, const Containers::
     _state->outputVersion = Containers::String::nullTerminatedGlobalView(version);
 }
 
-void GlslangConverter::doSetDefinitions(const Containers::ArrayView<const Containers::Pair<Containers::StringView, Containers::StringView>> definitions) {
-    /* Concatenate (un)definitions to a preamble */
-    /** @todo rework w/o std::string once we have formatInto() w/ a String */
-    _state->definitions.clear();
+namespace {
+
+/* Concatenates (un)definitions to a preamble, shared between
+   doSetDefinitions() and convertDataToDataBatch() */
+/** @todo rework w/o std::string once we have formatInto() w/ a String */
+std::string definitionsPreamble(const Containers::ArrayView<const Containers::Pair<Containers::StringView, Containers::StringView>> definitions) {
+    std::string out;
     for(const Containers::Pair<Containers::StringView, Containers::StringView>& definition: definitions) {
         if(!definition.second().data())
-            Utility::formatInto(_state->definitions, _state->definitions.size(), "#undef {}\n", definition.first());
+            Utility::formatInto(out, out.size(), "#undef {}\n", definition.first());
         else if(definition.second().isEmpty())
-            Utility::formatInto(_state->definitions, _state->definitions.size(), "#define {}\n", definition.first());
+            Utility::formatInto(out, out.size(), "#define {}\n", definition.first());
         else
-            Utility::formatInto(_state->definitions, _state->definitions.size(), "#define {} {}\n", definition.first(), definition.second());
+            Utility::formatInto(out, out.size(), "#define {} {}\n", definition.first(), definition.second());
     }
+    return out;
+}
+
+}
+
+void GlslangConverter::doSetDefinitions(const Containers::ArrayView<const Containers::Pair<Containers::StringView, Containers::StringView>> definitions) {
+    _state->definitions = definitionsPreamble(definitions);
 }
 
 void GlslangConverter::doSetDebugInfoLevel(const Containers::StringView level) {
@@ -304,13 +341,36 @@ OutputVersion parseOutputVersion(const char* const prefix, Format format, const
 }
 
 struct Includer: glslang::TShader::Includer {
-    explicit Includer(Containers::Optional<Containers::ArrayView<const char>>(*const callback)(const std::string&, InputFileCallbackPolicy, void*), void* const userData): _callback{callback}, _userData{userData} {}
+    explicit Includer(Containers::Optional<Containers::ArrayView<const char>>(*const callback)(const std::string&, InputFileCallbackPolicy, void*), void* const userData, IncludeCache* const cache): _callback{callback}, _userData{userData}, _cache{cache} {}
 
     IncludeResult* includeLocal(const char* const headerName, const char* const includerName, std::size_t) override {
         /* If path/to/shader.glsl includes ../definitions.glsl, it should
            resolves to path/to/../definitions.glsl */
         const Containers::String fullPath = Utility::Path::join(Utility::Path::split(includerName).first(), headerName);
 
+        /* If the include cache is enabled, the file is loaded through the
+           callback just once, copied to the cache and closed right after.
+           Any further includes of the same file, in this or subsequent
+           conversions, are served from the cache. Entries are never removed
+           while the cache is in use, so the pointers stay valid until
+           releaseInclude(), which then has nothing to close. */
+        if(_cache) {
+            std::lock_guard<std::mutex> lock{_cache->mutex};
+            auto found = _cache->files.find(fullPath);
+            if(found == _cache->files.end()) {
+                const Containers::Optional<Containers::ArrayView<const char>> data = _callback(fullPath, InputFileCallbackPolicy::LoadTemporary, _userData);
+                if(!data)
+                    return nullptr;
+
+                Containers::Array<char> copy{NoInit, data->size()};
+                Utility::copy(*data, copy);
+                _callback(fullPath, InputFileCallbackPolicy::Close, _userData);
+                found = _cache->files.emplace(fullPath, Utility::move(copy)).first;
+            }
+
+            return new IncludeResult{fullPath, found->second.data(), found->second.size(), nullptr};
+        }
+
         /* If one header is included recursively (for whatever reason), glslang
            calls the includer multiple times, followed by calling
            releaseInclude() multiple times. I suppose it's because it can't
@@ -352,6 +412,12 @@ struct Includer: glslang::TShader::Includer {
            from Includer. That's not great. */
         if(!result) return;
 
+        /* Files coming from the include cache have nothing to close */
+        if(!result->userData) {
+            delete result;
+            return;
+        }
+
         /* Decrease the reference counter, if it goes to zero, close the data */
         auto& reference = *static_cast<Containers::Pair<Containers::ArrayView<const char>, std::size_t>*>(result->userData);
         CORRADE_INTERNAL_ASSERT(reference.second());
@@ -368,62 +434,12 @@ struct Includer: glslang::TShader::Includer {
     private:
         Containers::Optional<Containers::ArrayView<const char>>(*_callback)(const std::string&, InputFileCallbackPolicy, void*);
         void* _userData;
+        IncludeCache* _cache;
 
         std::unordered_map<std::string, Containers::Pair<Containers::ArrayView<const char>, std::size_t>> _references;
 };
 
-Containers::Pair<bool, bool> compileAndLinkShader(glslang::TShader& shader, glslang::TProgram& program, const Utility::ConfigurationGroup& configuration, const ConverterFlags flags, const Containers::Pair<int, EProfile> inputVersion, const OutputVersion outputVersion, const bool versionExplicitlySpecified, const Containers::StringView definitions, const Containers::StringView filename, Containers::Optional<Containers::ArrayView<const char>>(*const fileCallback)(const std::string&, InputFileCallbackPolicy, void*), void* const fileCallbackUserData, const Containers::ArrayView<const char> data, Int messages) {
-    /* Add preprocessor definitions */
-    shader.setPreamble(definitions.data());
-
-    /* Add the actual shader source. We're not making use of the
-       multiple-source inputs here, it would only further complicate the plugin
-       interface. Google's shaderc does the same, and glslangValidator (WHAT A
-       NAME!!) seems to do that also, but its API is too confusing so I can't
-       tell for sure. If we're validating/compiling a file, the name gets used
-       in potential error messages. */
-    const char* string = data.data();
-    int length = data.size();
-    const char* filenames = filename.data();
-    shader.setStringsWithLengthsAndNames(&string, &length, filename.isEmpty() ? nullptr : &filenames, 1);
-
-    /* Set up the includer -- if we have callbacks, simply use those */
-    Containers::Optional<Includer> includer;
-    std::unordered_map<std::string, Containers::Array<char>> files;
-    if(fileCallback) {
-        includer.emplace(fileCallback, fileCallbackUserData);
-
-    /* Otherwise, if we have filename, build an includer from the filesystem */
-    } else if(!filename.isEmpty()) {
-        includer.emplace([](const std::string& filename, InputFileCallbackPolicy policy, void* userData) -> Containers::Optional<Containers::ArrayView<const char>> {
-            auto& files = *static_cast<std::unordered_map<std::string, Containers::Array<char>>*>(userData);
-            auto found = files.find(filename);
-
-            /* Discard the loaded file, if not needed anymore */
-            if(policy == InputFileCallbackPolicy::Close) {
-                CORRADE_INTERNAL_ASSERT(found != files.end());
-                files.erase(found);
-                return {};
-            }
-
-            /* Read if not there yet */
-            if(found == files.end()) {
-                Containers::Optional<Containers::Array<char>> file = Utility::Path::read(filename);
-                if(!file) return {};
-
-                found = files.emplace(filename, *Utility::move(file)).first;
-            }
-
-            return Containers::ArrayView<const char>{found->second};
-        }, &files);
-
-    /* Otherwise we can't load files in any way */
-    }
-
-    /** @todo ability to override entrypoint name (for linking multiple same
-        stages together), for some reason not working in glslang, only for
-        hlsl */
-
+TBuiltInResource builtInResources(const Utility::ConfigurationGroup& configuration) {
     /* Set up builtin values and resource limits. There's no default
        constructor for that thing so we'd have to populate it either way, even
        if not exposing any of these. Sigh.
@@ -433,6 +449,9 @@ Containers::Pair<bool, bool> compileAndLinkShader(glslang::TShader& shader, glsl
        Update when neccessary -- the last member is commented out because it's
        not in 8.13.3743 yet */
     TBuiltInResource resources;
+    /* Zero-init everything, including padding and members we don't expose,
+       so the whole struct can be hashed for the compilation cache */
+    std::memset(&resources, 0, sizeof(TBuiltInResource));
     const Utility::ConfigurationGroup* builtins = configuration.group("builtins");
     CORRADE_INTERNAL_ASSERT(builtins);
     #define _c(name) resources.name = builtins->value<Int>(#name);
@@ -545,6 +564,116 @@ Containers::Pair<bool, bool> compileAndLinkShader(glslang::TShader& shader, glsl
     _c(generalConstantMatrixVectorIndexing)
     #undef _c
 
+    return resources;
+}
+
+std::string cacheKey(const EShLanguage stage, const Format inputFormat, const Containers::StringView inputVersion, const Format outputFormat, const Containers::StringView outputVersion, const std::string& definitions, const Containers::StringView debugInfo, const Containers::StringView filename, const Utility::ConfigurationGroup& configuration, const TBuiltInResource& resources, const Containers::ArrayView<const char> data) {
+    /* Glslang version goes in as well, as a different version may produce a
+       different output for the same input */
+    #ifdef GLSLANG_VERSION_MAJOR
+    const Int glslangVersion[]{GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR, GLSLANG_VERSION_PATCH};
+    #else
+    const Int glslangVersion[]{0, 0, GLSLANG_PATCH_LEVEL};
+    #endif
+
+    /* Everything else that affects the output. Variable-length strings are
+       prefixed with their size so different combinations can't result in the
+       same byte sequence. The filename is embedded in the output only with
+       debug info enabled, otherwise it doesn't matter. Flags are not included
+       as they only affect whether a warning is treated as an error or not,
+       and failed compilations are never cached. */
+    const std::string header = Utility::formatString(
+        "glslang {}.{}.{}\n"
+        "stage {}\n"
+        "input {} {}:{}\n"
+        "output {} {}:{}\n"
+        "debugInfo {}:{}\n"
+        "filename {}:{}\n"
+        "cascadingErrors {} permissive {} forwardCompatible {}\n"
+        "definitions {}:{}\n",
+        glslangVersion[0], glslangVersion[1], glslangVersion[2],
+        Int(stage),
+        UnsignedInt(inputFormat), inputVersion.size(), inputVersion,
+        UnsignedInt(outputFormat), outputVersion.size(), outputVersion,
+        debugInfo.size(), debugInfo,
+        debugInfo == "1"_s ? filename.size() : 0, debugInfo == "1"_s ? filename : ""_s,
+        Int(configuration.value<bool>("cascadingErrors")),
+        Int(configuration.value<bool>("permissive")),
+        Int(configuration.value<bool>("forwardCompatible")),
+        definitions.size(), definitions);
+
+    /* Builtins and limits are hashed as-is, builtInResources() made sure the
+       padding is zeroed */
+    Utility::Sha1 sha1;
+    sha1 << Containers::arrayView(header.data(), header.size())
+         << Containers::arrayView(reinterpret_cast<const char*>(&resources), sizeof(TBuiltInResource))
+         << data;
+    return sha1.digest().hexString();
+}
+
+IncludeCache* includeCacheFor(const Utility::ConfigurationGroup& configuration, IncludeCache& cache) {
+    /* If the include cache is disabled, drop whatever might have been there
+       from before */
+    if(!configuration.value<bool>("cacheIncludes")) {
+        cache.files.clear();
+        return nullptr;
+    }
+
+    return &cache;
+}
+
+Containers::Pair<bool, bool> compileAndLinkShader(glslang::TShader& shader, glslang::TProgram& program, const Utility::ConfigurationGroup& configuration, const TBuiltInResource& resources, const ConverterFlags flags, const Containers::Pair<int, EProfile> inputVersion, const OutputVersion outputVersion, const bool versionExplicitlySpecified, const Containers::StringView definitions, const Containers::StringView filename, Containers::Optional<Containers::ArrayView<const char>>(*const fileCallback)(const std::string&, InputFileCallbackPolicy, void*), void* const fileCallbackUserData, IncludeCache* const includeCache, const Containers::ArrayView<const char> data, Int messages) {
+    /* Add preprocessor definitions */
+    shader.setPreamble(definitions.data());
+
+    /* Add the actual shader source. We're not making use of the
+       multiple-source inputs here, it would only further complicate the plugin
+       interface. Google's shaderc does the same, and glslangValidator (WHAT A
+       NAME!!) seems to do that also, but its API is too confusing so I can't
+       tell for sure. If we're validating/compiling a file, the name gets used
+       in potential error messages. */
+    const char* string = data.data();
+    int length = data.size();
+    const char* filenames = filename.data();
+    shader.setStringsWithLengthsAndNames(&string, &length, filename.isEmpty() ? nullptr : &filenames, 1);
+
+    /* Set up the includer -- if we have callbacks, simply use those */
+    Containers::Optional<Includer> includer;
+    std::unordered_map<std::string, Containers::Array<char>> files;
+    if(fileCallback) {
+        includer.emplace(fileCallback, fileCallbackUserData, includeCache);
+
+    /* Otherwise, if we have filename, build an includer from the filesystem */
+    } else if(!filename.isEmpty()) {
+        includer.emplace([](const std::string& filename, InputFileCallbackPolicy policy, void* userData) -> Containers::Optional<Containers::ArrayView<const char>> {
+            auto& files = *static_cast<std::unordered_map<std::string, Containers::Array<char>>*>(userData);
+            auto found = files.find(filename);
+
+            /* Discard the loaded file, if not needed anymore */
+            if(policy == InputFileCallbackPolicy::Close) {
+                CORRADE_INTERNAL_ASSERT(found != files.end());
+                files.erase(found);
+                return {};
+            }
+
+            /* Read if not there yet */
+            if(found == files.end()) {
+                Containers::Optional<Containers::Array<char>> file = Utility::Path::read(filename);
+                if(!file) return {};
+
+                found = files.emplace(filename, *Utility::move(file)).first;
+            }
+
+            return Containers::ArrayView<const char>{found->second};
+        }, &files, includeCache);
+
+    /* Otherwise we can't load files in any way */
+    }
+
+    /** @todo ability to override entrypoint name (for linking multiple same
+        stages together), for some reason not working in glslang, only for
+        hlsl */
+
     /* Decide on the client based on output version */
     glslang::EShClient client{};
     switch(outputVersion.client) {
@@ -693,6 +822,177 @@ Containers::Pair<bool, bool> compileAndLinkShader(glslang::TShader& shader, glsl
     return {true, true};
 }
 
+bool spirvOptions(const char* const prefix, const Containers::StringView debugInfo, glslang::SpvOptions& spvOptions, Int& messages) {
+    /* Compilation and SPIR-V options */
+    /* We'll do these ourselves (and better) on the resulting SPIR-V instead */
+    spvOptions.disableOptimizer = true;
+    spvOptions.optimizeSize = false;
+    spvOptions.disassemble = false;
+    /* We have a dedicated plugin for SPIR-V validation with far more options */
+    spvOptions.validate = false;
+    /* Might be overriden below */
+    spvOptions.generateDebugInfo = false;
+
+    /* Debug info level */
+    if(debugInfo == "1"_s) {
+        /* My expectations for glslang can't get much lower anymore but
+           nevertheless, for some reason, there isn't a single option that
+           enables debug info -- one has to set *two* options in sync. Behold:
+
+           1. If both are specified, the resulting SPIR-V has both the original
+           source embedded in OpSource, line info in OpLine and processing info
+           in OpModuleProcessed. It makes sense this way:
+
+            %1 = OpString "a.vert"
+                 OpSource ESSL 310 %1 "…
+            …
+            "
+                 OpModuleProcessed "client vulkan100"
+                 …
+
+           2. If just generateDebugInfo is specified, it results in a mess like
+
+            %1 = OpString ""
+            %7 = OpString "a.vert"
+                 OpSource ESSL 310 %1
+                 …
+
+           where the referenced source name should be clearly %7 and not %1
+           (OTOH the following OpLine statements reference %7 correctly, so I
+           suppose this is yet another weird bug I came across as the first
+           person on Earth). On SPIR-V 1.0 (`vulkan1.0` / `opengl4.5` target)
+           the OpSource additionally contains the OpModuleProcessed entries
+           embedded in the source and then a #line 1 to reset the line counter
+           back, but the actual source is *still* missing and the same %1 / %7
+           mismatch remains:
+
+            %1 = OpString ""
+            %7 = OpString "a.vert"
+                 OpSource ESSL 310 %1 "// OpModuleProcessed client vulkan100
+            …
+            #line 1
+            "
+                 …
+
+           3. If just EShMsgDebugInfo is specified, the output has no debug
+           info at all. */
+        spvOptions.generateDebugInfo = true;
+        messages |= EShMsgDebugInfo;
+
+    /* There's also a stripDebugInfo option since version 10-11.0.0 (yes, a
+       DASH, WTAF!!) (see https://github.com/KhronosGroup/glslang/pull/2278 ),
+       however even after spending half an hour investigating what it actually
+       does I fail to see its purpose -- if I don't generate any debug info in
+       the first place, there's no debug info to strip later, no?! The purpose
+       of the PR is to add -g0 analogously to GCC, but for GCC it's simply
+
+        Level 0 produces no debug information at all. Thus, -g0 negates -g.
+
+       So here we do the same. If the user specifies -g0, it'll act as a reset
+       for -g1 specified earlier and -g0 alone will have the same effect as not
+       doing anything at all because by default, no debug info is generated. */
+    } else if(debugInfo != "0"_s && debugInfo != ""_s) {
+        Error{} << prefix << "debug info level should be 0, 1 or empty but got" << debugInfo;
+        return false;
+    }
+
+    return true;
+}
+
+struct CompilationResult {
+    /* Whether compilation and linking succeeded */
+    Containers::Pair<bool, bool> success;
+    Containers::String shaderLog, programLog;
+    Containers::Array<char> spirv;
+};
+
+CompilationResult compileToSpirv(const EShLanguage stage, const Utility::ConfigurationGroup& configuration, const TBuiltInResource& resources, const ConverterFlags flags, const Containers::Pair<int, EProfile> inputVersion, const OutputVersion outputVersion, const bool versionExplicitlySpecified, const Containers::StringView definitions, const Containers::StringView filename, Containers::Optional<Containers::ArrayView<const char>>(*const fileCallback)(const std::string&, InputFileCallbackPolicy, void*), void* const fileCallbackUserData, IncludeCache* const includeCache, const Containers::ArrayView<const char> data, const Int messages, const glslang::SpvOptions& spvOptions) {
+    /* Amazing, why some enums have the glslang:: namespace and some don't /
+       can't? Why can't you just be consistent, FFS? The shader and program
+       are created here and not passed from outside because glslang binds its
+       internal allocator to the thread that creates them. That way it's
+       possible to call this function from multiple threads at once. */
+    glslang::TShader shader{stage};
+
+    /* This is done differently for validation and compilation, so it's not
+       inside compileAndLinkShader(). Unlike in doValidateData(), here we just
+       set a SPIR-V target because that's what we want. */
+    shader.setEnvTarget(glslang::EShTargetSpv, outputVersion.language);
+
+    /* Add preprocessor definitions, input source, configure limits,
+       input/output formats, targets and versions, compile and "link". This
+       function is shared between doValidateData() and compileToSpirv() and
+       does the same in both. */
+    glslang::TProgram program;
+    CompilationResult out;
+    out.success = compileAndLinkShader(shader, program, configuration, resources, flags, inputVersion, outputVersion, versionExplicitlySpecified, definitions, filename, fileCallback, fileCallbackUserData, includeCache, data, messages);
+
+    /* Trim excessive newlines and spaces from the output. What the fuck, did
+       nobody ever verify what mess it spits out?! */
+    /** @todo clean up also trailing newlines inside, ffs */
+    out.shaderLog = Containers::String{Containers::StringView{shader.getInfoLog()}.trimmedSuffix()};
+    if(!out.success.first()) return out;
+
+    /* Trim excessive newlines and spaces here as well */
+    out.programLog = Containers::String{Containers::StringView{program.getInfoLog()}.trimmedSuffix()};
+    if(!out.success.second()) return out;
+
+    /* Translate the glslang IR to SPIR-V. Yes, this goes separately for each
+       stage, so the actual "linking" is no linking at all (and no, it doesn't
+       do any cross-stage validation or checks either, at least in the current
+       version). */
+    glslang::TIntermediate* ir = program.getIntermediate(stage);
+    CORRADE_INTERNAL_ASSERT(ir);
+
+    /* WTF, a vector?! U MAD? */
+    std::vector<UnsignedInt> spirv;
+    spv::SpvBuildLogger logger;
+    glslang::GlslangToSpv(*ir, spirv, &logger, &spvOptions);
+
+    /* Copy the vector into something sane */
+    Containers::ArrayView<const char> spirvBytes = Containers::arrayCast<const char>(Containers::arrayView(spirv));
+    out.spirv = Containers::Array<char>{NoInit, spirvBytes.size()};
+    Utility::copy(spirvBytes, out.spirv);
+    return out;
+}
+
+Containers::Optional<Containers::Array<char>> readCache(const Containers::StringView filename) {
+    /* Check for existence first so Path::read() doesn't print an error, a
+       cache miss isn't anything the user should be concerned about */
+    if(!Utility::Path::exists(filename))
+        return {};
+
+    /* Use the cached file only if it looks like SPIR-V, otherwise compile
+       again and overwrite it */
+    Containers::Optional<Containers::Array<char>> cached = Utility::Path::read(filename);
+    if(!cached || cached->size() < 20 || cached->size() % 4 != 0 || Containers::arrayCast<const UnsignedInt>(*cached)[0] != 0x07230203)
+        return {};
+
+    return cached;
+}
+
+bool writeCache(const Containers::StringView directory, const Containers::StringView filename, const Containers::ArrayView<const char> data) {
+    /* Write to a temporary file first and then move it over, so another
+       thread or process compiling the same shader at the same time never sees
+       a partially written file. The temporary name contains the process ID
+       and a hash of the thread ID, making it unique among all threads of all
+       processes that may be writing to the cache at the same time. Failing
+       to write the cache isn't fatal, the conversion itself succeeded, so
+       the caller only prints a warning. That's done by the caller and not
+       here because in case of convertDataToDataBatch() this gets called
+       from worker threads. */
+    const Containers::String temporaryFilename = Utility::format("{}.{}.{}.tmp", filename,
+        #ifndef CORRADE_TARGET_WINDOWS
+        getpid(),
+        #else
+        _getpid(),
+        #endif
+        std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    return Utility::Path::make(directory) &&
+           Utility::Path::write(temporaryFilename, data) &&
+           Utility::Path::move(temporaryFilename, filename);
+}
+
 }
 
 Containers::Pair<bool, Containers::String> GlslangConverter::doValidateFile(const Stage stage, const Containers::StringView filename) {
@@ -787,7 +1087,7 @@ Containers::Pair<bool, Containers::String> GlslangConverter::doValidateData(cons
        function is shared between doValidateData() and doConvertDataToData()
        and does the same in both. Here we use just the output log. */
     glslang::TProgram program;
-    const Containers::Pair<bool, bool> success = compileAndLinkShader(shader, program, configuration(), flags(), inputVersion, outputVersion, !_state->inputVersion.isEmpty(), _state->definitions, inputFilename, inputFileCallback(), inputFileCallbackUserData(), data, 0);
+    const Containers::Pair<bool, bool> success = compileAndLinkShader(shader, program, configuration(), builtInResources(configuration()), flags(), inputVersion, outputVersion, !_state->inputVersion.isEmpty(), _state->definitions, inputFilename, inputFileCallback(), inputFileCallbackUserData(), includeCacheFor(configuration(), _state->includeCache), data, 0);
 
     /* Trim excessive newlines and spaces from the output. What the fuck, did
        nobody ever verify what mess it spits out?! */
@@ -859,144 +1159,165 @@ Containers::Optional<Containers::Array<char>> GlslangConverter::doConvertDataToD
     const OutputVersion outputVersion = parseOutputVersion("ShaderTools::GlslangConverter::convertDataToData():", Format::Spirv, _state->outputVersion);
     if(!inputVersion.first() || !outputVersion.client) return {};
 
-    /* Compilation and SPIR-V options */
+    /* Compilation and SPIR-V options, debug info level */
     Int messages = 0;
     glslang::SpvOptions spvOptions;
-    /* We'll do these ourselves (and better) on the resulting SPIR-V instead */
-    spvOptions.disableOptimizer = true;
-    spvOptions.optimizeSize = false;
-    spvOptions.disassemble = false;
-    /* We have a dedicated plugin for SPIR-V validation with far more options */
-    spvOptions.validate = false;
-    /* Might be overriden below */
-    spvOptions.generateDebugInfo = false;
-
-    /* Debug info level */
-    if(_state->debugInfo == "1"_s) {
-        /* My expectations for glslang can't get much lower anymore but
-           nevertheless, for some reason, there isn't a single option that
-           enables debug info -- one has to set *two* options in sync. Behold:
-
-           1. If both are specified, the resulting SPIR-V has both the original
-           source embedded in OpSource, line info in OpLine and processing info
-           in OpModuleProcessed. It makes sense this way:
-
-            %1 = OpString "a.vert"
-                 OpSource ESSL 310 %1 "…
-            …
-            "
-                 OpModuleProcessed "client vulkan100"
-                 …
-
-           2. If just generateDebugInfo is specified, it results in a mess like
-
-            %1 = OpString ""
-            %7 = OpString "a.vert"
-                 OpSource ESSL 310 %1
-                 …
-
-           where the referenced source name should be clearly %7 and not %1
-           (OTOH the following OpLine statements reference %7 correctly, so I
-           suppose this is yet another weird bug I came across as the first
-           person on Earth). On SPIR-V 1.0 (`vulkan1.0` / `opengl4.5` target)
-           the OpSource additionally contains the OpModuleProcessed entries
-           embedded in the source and then a #line 1 to reset the line counter
-           back, but the actual source is *still* missing and the same %1 / %7
-           mismatch remains:
-
-            %1 = OpString ""
-            %7 = OpString "a.vert"
-                 OpSource ESSL 310 %1 "// OpModuleProcessed client vulkan100
-            …
-            #line 1
-            "
-                 …
-
-           3. If just EShMsgDebugInfo is specified, the output has no debug
-           info at all. */
-        spvOptions.generateDebugInfo = true;
-        messages |= EShMsgDebugInfo;
-
-    /* There's also a stripDebugInfo option since version 10-11.0.0 (yes, a
-       DASH, WTAF!!) (see https://github.com/KhronosGroup/glslang/pull/2278 ),
-       however even after spending half an hour investigating what it actually
-       does I fail to see its purpose -- if I don't generate any debug info in
-       the first place, there's no debug info to strip later, no?! The purpose
-       of the PR is to add -g0 analogously to GCC, but for GCC it's simply
-
-        Level 0 produces no debug information at all. Thus, -g0 negates -g.
-
-       So here we do the same. If the user specifies -g0, it'll act as a reset
-       for -g1 specified earlier and -g0 alone will have the same effect as not
-       doing anything at all because by default, no debug info is generated. */
-    } else if(_state->debugInfo != "0"_s && _state->debugInfo != ""_s) {
-        Error{} << "ShaderTools::GlslangConverter::convertDataToData(): debug info level should be 0, 1 or empty but got" << _state->debugInfo;
+    if(!spirvOptions("ShaderTools::GlslangConverter::convertDataToData():", _state->debugInfo, spvOptions, messages))
         return {};
-    }
-
-    /* Amazing, why some enums have the glslang:: namespace and some don't /
-       can't? Why can't you just be consistent, FFS? */
-    glslang::TShader shader{translatedStage};
 
-    /* This is done differently for validation and compilation, so it's not
-       inside compileAndLinkShader(). Unlike in doValidateData(), here we just
-       set a SPIR-V target because that's what we want. */
-    shader.setEnvTarget(glslang::EShTargetSpv, outputVersion.language);
+    /* Builtins and limits are needed both for compilation and the cache key */
+    const TBuiltInResource resources = builtInResources(configuration());
+
+    /* If the cache is enabled, look for an already compiled output. Sources
+       containing #include directives are never cached, as we don't know which
+       files they pull in without preprocessing them first. */
+    const Containers::StringView cacheDirectory = configuration().value<Containers::StringView>("cacheDirectory");
+    Containers::String cacheFilename;
+    if(!cacheDirectory.isEmpty() && !Containers::StringView{data}.contains("#include"_s)) {
+        cacheFilename = Utility::Path::join(cacheDirectory, cacheKey(translatedStage, _state->inputFormat, _state->inputVersion, _state->outputFormat, _state->outputVersion, _state->definitions, _state->debugInfo, inputFilename, configuration(), resources, data) + ".spv");
+        if(Containers::Optional<Containers::Array<char>> cached = readCache(cacheFilename)) {
+            if(flags() & ConverterFlag::Verbose)
+                Debug{} << "ShaderTools::GlslangConverter::convertDataToData(): using cached" << Utility::Path::split(cacheFilename).second();
+            return cached;
+        }
+    }
 
     /* Add preprocessor definitions, input source, configure limits,
-       input/output formats, targets and versions, compile and "link". This
-       function is shared between doValidateData() and doConvertDataToData()
-       and does the same in both.
+       input/output formats, targets and versions, compile, "link" and
+       translate to SPIR-V. This function is shared between
+       doConvertDataToData() and convertDataToDataBatch() and does the same in
+       both.
 
        We use Format::Spirv even if outputFormat is Unspecified, as
        Format::Unspecified is meant for validation purposes only without
        enforcing SPIR-V specific rules such as presence of explicit locations
        and bindings. */
-    glslang::TProgram program;
-    Containers::Pair<bool, bool> success = compileAndLinkShader(shader, program, configuration(), flags(), inputVersion, outputVersion, !_state->inputVersion.isEmpty(), _state->definitions, inputFilename, inputFileCallback(), inputFileCallbackUserData(), data, messages);
+    CompilationResult result = compileToSpirv(translatedStage, configuration(), resources, flags(), inputVersion, outputVersion, !_state->inputVersion.isEmpty(), _state->definitions, inputFilename, inputFileCallback(), inputFileCallbackUserData(), includeCacheFor(configuration(), _state->includeCache), data, messages, spvOptions);
 
-    /* Trim excessive newlines and spaces from the output. What the fuck, did
-       nobody ever verify what mess it spits out?! */
-    /** @todo clean up also trailing newlines inside, ffs */
-    const auto shaderLog = Containers::StringView{shader.getInfoLog()}.trimmedSuffix();
-    if(!success.first()) {
-        Error{} << "ShaderTools::GlslangConverter::convertDataToData(): compilation failed:" << Debug::newline << shaderLog;
+    if(!result.success.first()) {
+        Error{} << "ShaderTools::GlslangConverter::convertDataToData(): compilation failed:" << Debug::newline << result.shaderLog;
         return {};
     }
 
     /* Assertions in compileAndLinkShader() should have checked that we get
        warnings only if Quiet is not enabled */
-    if(!shaderLog.isEmpty())
-        Warning{} << "ShaderTools::GlslangConverter::convertDataToData(): compilation succeeded with the following message:" << Debug::newline << shaderLog;
+    if(!result.shaderLog.isEmpty())
+        Warning{} << "ShaderTools::GlslangConverter::convertDataToData(): compilation succeeded with the following message:" << Debug::newline << result.shaderLog;
 
-    /* Trim excessive newlines and spaces here as well */
-    const auto programLog =  Containers::StringView{program.getInfoLog()}.trimmedSuffix();
-    if(!success.second()) {
-        Error{} << "ShaderTools::GlslangConverter::convertDataToData(): linking failed:" << Debug::newline << programLog;
+    if(!result.success.second()) {
+        Error{} << "ShaderTools::GlslangConverter::convertDataToData(): linking failed:" << Debug::newline << result.programLog;
         return {};
     }
 
     /* Assertions in compileAndLinkShader() should have checked that we get
        warnings only if Quiet is not enabled */
-    if(!programLog.isEmpty())
-        Warning{} << "ShaderTools::GlslangConverter::convertDataToData(): linking succeeded with the following message:" << Debug::newline << programLog;
+    if(!result.programLog.isEmpty())
+        Warning{} << "ShaderTools::GlslangConverter::convertDataToData(): linking succeeded with the following message:" << Debug::newline << result.programLog;
 
-    /* Translate the glslang IR to SPIR-V. Yes, this goes separately for each
-       stage, so the actual "linking" is no linking at all (and no, it doesn't
-       do any cross-stage validation or checks either, at least in the current
-       version). */
-    glslang::TIntermediate* ir = program.getIntermediate(translatedStage);
-    CORRADE_INTERNAL_ASSERT(ir);
+    /* Save the output to the cache, if enabled */
+    if(!cacheFilename.isEmpty())
+        if(!writeCache(cacheDirectory, cacheFilename, result.spirv))
+            Warning{} << "ShaderTools::GlslangConverter::convertDataToData(): can't save the output to cache in" << cacheDirectory;
 
-    /* WTF, a vector?! U MAD? */
-    std::vector<UnsignedInt> spirv;
-    spv::SpvBuildLogger logger;
-    glslang::GlslangToSpv(*ir, spirv, &logger, &spvOptions);
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(result.spirv));
+}
 
-    /* Copy the vector into something sane */
-    Containers::ArrayView<const char> spirvBytes = Containers::arrayCast<const char>(Containers::arrayView(spirv));
-    Containers::Array<char> out{NoInit, spirvBytes.size()};
-    Utility::copy(spirvBytes, out);
+Containers::Optional<Containers::Array<GlslangConverter::BatchResult>> GlslangConverter::convertDataToDataBatch(const Containers::ArrayView<const BatchJob> jobs) {
+    /* Clear the input filename, if set from a previous validation or
+       conversion, same as in doConvertDataToData(). There's no filename
+       associated with the batch jobs. */
+    _state->inputFilename = {};
+
+    /* Same checks as in doConvertDataToData(), done just once for all jobs */
+    if(flags() & ConverterFlag::PreprocessOnly) {
+        Error{} << "ShaderTools::GlslangConverter::convertDataToDataBatch(): PreprocessOnly is not implemented yet, sorry";
+        return {};
+    }
+    if(_state->inputFormat != Format::Unspecified &&
+       _state->inputFormat != Format::Glsl) {
+        Error{} << "ShaderTools::GlslangConverter::convertDataToDataBatch(): input format should be Glsl or Unspecified but got" << _state->inputFormat;
+        return {};
+    }
+    if(_state->outputFormat != Format::Unspecified &&
+       _state->outputFormat != Format::Spirv) {
+        Error{} << "ShaderTools::GlslangConverter::convertDataToDataBatch(): output format should be Spirv or Unspecified but got" << _state->outputFormat;
+        return {};
+    }
+    const Containers::Pair<int, EProfile> inputVersion = parseInputVersion("ShaderTools::GlslangConverter::convertDataToDataBatch():", _state->inputVersion);
+    const OutputVersion outputVersion = parseOutputVersion("ShaderTools::GlslangConverter::convertDataToDataBatch():", Format::Spirv, _state->outputVersion);
+    if(!inputVersion.first() || !outputVersion.client) return {};
+
+    Int messages = 0;
+    glslang::SpvOptions spvOptions;
+    if(!spirvOptions("ShaderTools::GlslangConverter::convertDataToDataBatch():", _state->debugInfo, spvOptions, messages))
+        return {};
+
+    /* Everything below is only read from the worker threads, never
+       modified */
+    const TBuiltInResource resources = builtInResources(configuration());
+    const Containers::StringView cacheDirectory = configuration().value<Containers::StringView>("cacheDirectory");
+    IncludeCache* const includeCache = includeCacheFor(configuration(), _state->includeCache);
+
+    Containers::Array<BatchResult> out{ValueInit, jobs.size()};
+
+    /* Each thread picks the next job that wasn't taken yet until there's
+       none left. The glslang shader and program instances are created in
+       compileToSpirv(), i.e. on the thread that uses them. Nothing is
+       printed from the workers, failures are collected and reported on the
+       calling thread after all workers finish. */
+    std::atomic<std::size_t> nextJob{0};
+    std::atomic<bool> cacheWriteFailed{false};
+    auto worker = [&]() {
+        for(std::size_t i; (i = nextJob++) < jobs.size(); ) {
+            const BatchJob& job = jobs[i];
+            const EShLanguage stage = translateStage(job.stage);
+            const std::string definitions = definitionsPreamble(job.definitions);
+
+            /* Look into the cache first, if enabled, same as in
+               doConvertDataToData() */
+            Containers::String cacheFilename;
+            if(!cacheDirectory.isEmpty() && !Containers::StringView{job.data}.contains("#include"_s)) {
+                cacheFilename = Utility::Path::join(cacheDirectory, cacheKey(stage, _state->inputFormat, _state->inputVersion, _state->outputFormat, _state->outputVersion, definitions, _state->debugInfo, {}, configuration(), resources, job.data) + ".spv");
+                if(Containers::Optional<Containers::Array<char>> cached = readCache(cacheFilename)) {
+                    out[i].data = Utility::move(cached);
+                    continue;
+                }
+            }
+
+            CompilationResult result = compileToSpirv(stage, configuration(), resources, flags(), inputVersion, outputVersion, !_state->inputVersion.isEmpty(), definitions, {}, inputFileCallback(), inputFileCallbackUserData(), includeCache, job.data, messages, spvOptions);
+            out[i].log = "\n"_s.joinWithoutEmptyParts({result.shaderLog, result.programLog});
+            if(!result.success.first() || !result.success.second())
+                continue;
+
+            if(!cacheFilename.isEmpty() && !writeCache(cacheDirectory, cacheFilename, result.spirv))
+                cacheWriteFailed = true;
+            out[i].data = Utility::move(result.spirv);
+        }
+    };
+
+    /* The calling thread is one of the workers, so spawn one thread less.
+       Error and Warning redirection, used also by Utility::Path APIs called
+       from the workers, is only thread-local if Corrade is built with
+       CORRADE_BUILD_MULTITHREADED, so without it everything is done on the
+       calling thread. */
+    #ifdef CORRADE_BUILD_MULTITHREADED
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount)
+        threadCount = std::thread::hardware_concurrency();
+    threadCount = Math::max(Math::min(threadCount, UnsignedInt(jobs.size())), 1u);
+    #else
+    const UnsignedInt threadCount = 1;
+    #endif
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{worker};
+    worker();
+    for(std::thread& thread: threads)
+        thread.join();
+
+    if(cacheWriteFailed)
+        Warning{} << "ShaderTools::GlslangConverter::convertDataToDataBatch(): can't save the output to cache in" << cacheDirectory;
 
     /* GCC 4.8 needs extra help here */
     return Containers::optional(Utility::move(out));
@@ -30,7 +30,12 @@
  * @m_since_latest_{plugins}
  */
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/String.h>
 #include <Magnum/ShaderTools/AbstractConverter.h>
+#include <Magnum/ShaderTools/Stage.h>
 
 #include "MagnumPlugins/GlslangShaderConverter/configure.h"
 
@@ -205,6 +210,109 @@ file without a corresponding @ref InputFileCallbackPolicy::LoadTemporary in
 between. This means the user callbacks don't need to implement any kind of
 reference counting, that's handled on the plugin side.
 
+When compiling many shader variants that include the same common files, you
+can enable the @cb{.ini} cacheIncludes @ce
+@ref ShaderTools-GlslangConverter-configuration "configuration option". With
+it, contents of each included file are copied to memory the first time they're
+encountered, with the @ref InputFileCallbackPolicy::LoadTemporary being
+immediately followed by @ref InputFileCallbackPolicy::Close. All further
+includes of the same file, both in the current and in all subsequent
+validations and conversions done with the same converter instance, are then
+served from memory without going through the callback or the filesystem
+again. The cache is keyed on the resolved include path and its contents aren't
+invalidated when the file changes, setting the option back to
+@cpp false @ce drops them. The cache is shared also by jobs in
+@ref convertDataToDataBatch().
+
+@section ShaderTools-GlslangConverter-cache Compilation cache
+
+Setting the @cb{.ini} cacheDirectory @ce
+@ref ShaderTools-GlslangConverter-configuration "configuration option" to a
+non-empty path makes the plugin save the SPIR-V output of each successful
+conversion into given directory, with the filename being a SHA-1 hash of the
+input source together with everything else that affects the output --- the
+shader stage, preprocessor definitions, input and output format and version,
+debug info level, configured builtins and limits and the Glslang version. When
+the same combination is converted again, the cached SPIR-V is returned directly
+without invoking the compiler. The directory is created if it doesn't exist.
+
+Because the output is returned without compiling the source again, any
+warnings produced by the original compilation are not printed on a cache hit.
+With @ref ConverterFlag::Verbose enabled, the plugin prints a message every
+time a cached output is used. Sources containing @cpp #include @ce directives
+are never cached, as the set of included files isn't known without
+preprocessing the source first. Entries are never removed from the cache, it's
+up to the user to clean the directory when needed.
+
+@section ShaderTools-GlslangConverter-batch Batch conversion and thread safety
+
+Compiling many shader variants one by one through @ref convertDataToData() is
+serial. Glslang itself is safe to use from multiple threads as long as each
+thread uses its own shader and program instances, and the process-wide
+initialization done in @ref initialize() and @ref finalize() is handled by the
+plugin manager on plugin load and unload. The plugin thus provides
+@ref convertDataToDataBatch() that takes a list of jobs, each with a stage, a
+source and a set of preprocessor definitions, and compiles them concurrently
+on the number of threads given by the @cb{.ini} threads @ce
+@ref ShaderTools-GlslangConverter-configuration "configuration option". Each
+job gets its own SPIR-V output and a compilation log, and a failure in one job
+doesn't affect the others:
+
+@code{.cpp}
+PluginManager::Manager<ShaderTools::AbstractConverter> manager;
+Containers::Pointer<ShaderTools::AbstractConverter> converter =
+    manager.loadAndInstantiate("GlslangShaderConverter");
+converter->configuration().setValue("threads", 0);
+
+Containers::StringView source = …;
+const Containers::Pair<Containers::StringView, Containers::StringView> textured[]{
+    {"TEXTURED", ""}
+};
+const ShaderTools::GlslangConverter::BatchJob jobs[]{
+    {ShaderTools::Stage::Vertex, source, {}},
+    {ShaderTools::Stage::Vertex, source, textured},
+    …
+};
+
+Containers::Optional<Containers::Array<ShaderTools::GlslangConverter::BatchResult>>
+    results = static_cast<ShaderTools::GlslangConverter&>(*converter)
+        .convertDataToDataBatch(jobs);
+@endcode
+
+The function is virtual, which means it can be called through a cast plugin
+instance without having to link to the plugin library. Output format, version,
+debug info level and the configuration are taken from the converter instance
+same as with @ref convertDataToData(), including the
+@ref ShaderTools-GlslangConverter-cache "compilation cache", while the
+definitions set with @ref setDefinitions() are ignored in favor of the
+per-job ones. If an @ref ShaderTools-AbstractConverter-usage-callbacks "input file callback"
+is set, it may get called from multiple threads at once and thus has to be
+thread-safe. The converter instance itself is not thread-safe, use a separate
+instance if you need to call its other functions from another thread during
+the batch conversion.
+
+Messages from the compilation are returned in the per-job logs and a failure
+to save to the cache is reported once after all jobs finish, nothing is
+printed from the worker threads by the plugin itself. However, APIs it uses
+internally such as @ref Utility::Path may print errors on their own, which
+is only thread-safe if Corrade is built with
+@ref CORRADE_BUILD_MULTITHREADED enabled. Without it, the
+@cb{.ini} threads @ce option is ignored and the jobs are always processed
+serially on the calling thread.
+
+@subsection ShaderTools-GlslangConverter-batch-pthread Loading the plugin fails with undefined symbol: pthread_create
+
+On Linux it may happen that loading the plugin will fail with
+`undefined symbol: pthread_create`. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+plugin isn't linked to `pthread` and requires *the application* to link to it
+instead. With CMake it can be done like this:
+
+@code{.cmake}
+find_package(Threads REQUIRED)
+target_link_libraries(your-application PRIVATE Threads::Threads)
+@endcode
+
 @section ShaderTools-GlslangConverter-stages Shader stages
 
 When validating or converting files using @ref validateFile(),
@@ -338,6 +446,75 @@ class MAGNUM_GLSLANGSHADERCONVERTER_EXPORT GlslangConverter: public AbstractConv
         /** @brief Plugin manager constructor */
         explicit GlslangConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        /**
+         * @brief Batch conversion job
+         * @m_since_latest_{plugins}
+         *
+         * @see @ref convertDataToDataBatch()
+         */
+        struct BatchJob {
+            /**
+             * @brief Shader stage
+             *
+             * @ref Stage::Unspecified is treated the same as
+             * @ref Stage::Vertex.
+             */
+            Stage stage;
+
+            /** @brief Shader source */
+            Containers::ArrayView<const char> data;
+
+            /**
+             * @brief Preprocessor definitions
+             *
+             * Used instead of definitions set with @ref setDefinitions(), in
+             * the same format.
+             */
+            Containers::ArrayView<const Containers::Pair<Containers::StringView, Containers::StringView>> definitions;
+        };
+
+        /**
+         * @brief Batch conversion result
+         * @m_since_latest_{plugins}
+         *
+         * @see @ref convertDataToDataBatch()
+         */
+        struct BatchResult {
+            /**
+             * @brief SPIR-V output
+             *
+             * @relativeref{Corrade,Containers::NullOpt} if the compilation or
+             * linking failed.
+             */
+            Containers::Optional<Containers::Array<char>> data;
+
+            /**
+             * @brief Compilation and linking log
+             *
+             * Contains errors if @ref data is
+             * @relativeref{Corrade,Containers::NullOpt}, warnings otherwise.
+             * Empty if the output was taken from the
+             * @ref ShaderTools-GlslangConverter-cache "compilation cache".
+             */
+            Containers::String log;
+        };
+
+        /**
+         * @brief Convert multiple shaders concurrently
+         * @m_since_latest_{plugins}
+         *
+         * Compiles each of @p jobs to SPIR-V, distributing them across the
+         * number of threads given by the @cb{.ini} threads @ce
+         * @ref ShaderTools-GlslangConverter-configuration "configuration option",
+         * and returns a result for each job in the same order. Prints a
+         * message to @relativeref{Magnum,Error} and returns
+         * @relativeref{Corrade,Containers::NullOpt} if the input or output
+         * format, version or debug info level is invalid, failures in
+         * particular jobs are reported in @ref BatchResult::log instead. See
+         * @ref ShaderTools-GlslangConverter-batch for more information.
+         */
+        virtual Containers::Optional<Containers::Array<BatchResult>> convertDataToDataBatch(Containers::ArrayView<const BatchJob> jobs);
+
     private:
         MAGNUM_GLSLANGSHADERCONVERTER_LOCAL ConverterFeatures doFeatures() const override;
         MAGNUM_GLSLANGSHADERCONVERTER_LOCAL void doSetInputFormat(Format format, Containers::StringView version) override;
@@ -31,6 +31,7 @@
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
@@ -52,6 +53,8 @@
 #include <glslang/Include/revision.h>
 #endif
 
+#include "MagnumPlugins/GlslangShaderConverter/GlslangConverter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace ShaderTools { namespace Test { namespace {
@@ -62,6 +65,7 @@ struct GlslangConverterTest: TestSuite::Tester {
     void validate();
     void validateIncludes();
     void validateIncludesCallback();
+    void validateIncludesCallbackCache();
     void validateWrongInputFormat();
     void validateWrongInputVersion();
     void validateWrongOutputFormat();
@@ -87,6 +91,9 @@ struct GlslangConverterTest: TestSuite::Tester {
     void convertWrongOutputVersionTarget();
     void convertWrongOutputVersionLanguage();
     void convertWrongDebugInfoLevel();
+    void convertCache();
+    void convertBatch();
+    void convertBatchWrongOutputVersion();
     void convertFail();
     void convertFailWrongStage();
     void convertFailFileWrongStage();
@@ -333,12 +340,23 @@ const struct {
         VulkanNoExplicitLocationError},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} ConvertBatchData[]{
+    {"single thread", 1},
+    {"two threads", 2},
+    {"more threads than jobs", 16},
+    {"all cores", 0},
+};
+
 GlslangConverterTest::GlslangConverterTest() {
     addInstancedTests({&GlslangConverterTest::validate},
         Containers::arraySize(ValidateData));
 
     addTests({&GlslangConverterTest::validateIncludes,
               &GlslangConverterTest::validateIncludesCallback,
+              &GlslangConverterTest::validateIncludesCallbackCache,
               &GlslangConverterTest::validateWrongInputFormat,
               &GlslangConverterTest::validateWrongInputVersion,
               &GlslangConverterTest::validateWrongOutputFormat,
@@ -366,7 +384,13 @@ GlslangConverterTest::GlslangConverterTest() {
               &GlslangConverterTest::convertWrongOutputFormat,
               &GlslangConverterTest::convertWrongOutputVersionTarget,
               &GlslangConverterTest::convertWrongOutputVersionLanguage,
-              &GlslangConverterTest::convertWrongDebugInfoLevel});
+              &GlslangConverterTest::convertWrongDebugInfoLevel,
+              &GlslangConverterTest::convertCache});
+
+    addInstancedTests({&GlslangConverterTest::convertBatch},
+        Containers::arraySize(ConvertBatchData));
+
+    addTests({&GlslangConverterTest::convertBatchWrongOutputVersion});
 
     addInstancedTests({&GlslangConverterTest::convertFail},
         Containers::arraySize(ConvertFailData));
@@ -491,6 +515,83 @@ void GlslangConverterTest::validateIncludesCallback() {
         "Closing includes.vert\n");
 }
 
+void GlslangConverterTest::validateIncludesCallbackCache() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+
+    converter->configuration().setValue("cacheIncludes", true);
+
+    std::unordered_map<std::string, Containers::Array<char>> files;
+    converter->setInputFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, std::unordered_map<std::string, Containers::Array<char>>& files) -> Containers::Optional<Containers::ArrayView<const char>> {
+        auto found = files.find(filename);
+
+        /* Discard the loaded file, if not needed anymore */
+        if(policy == InputFileCallbackPolicy::Close) {
+            Debug{} << "Closing" << filename;
+
+            if(found != files.end()) files.erase(found);
+            return {};
+        }
+
+        Debug{} << "Loading" << filename;
+
+        if(found == files.end()) {
+            Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, filename));
+            CORRADE_VERIFY(file);
+
+            found = files.emplace(filename, *Utility::move(file)).first;
+        }
+
+        return Containers::ArrayView<const char>{found->second};
+    }, files);
+
+    /* With the cache enabled, each include is copied and closed right after
+       loading, and a file included repeatedly is loaded just once */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateFile({}, "includes.vert"),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_COMPARE(out.str(),
+            "Loading includes.vert\n"
+            "Loading sub/directory/basics.glsl\n"
+            "Closing sub/directory/basics.glsl\n"
+            "Loading sub/directory/definitions.glsl\n"
+            "Closing sub/directory/definitions.glsl\n"
+            "Loading sub/directory/../relative.glsl\n"
+            "Closing sub/directory/../relative.glsl\n"
+            "Closing includes.vert\n");
+    }
+
+    /* The cache is shared across subsequent validations and conversions, so
+       only the top-level file gets loaded */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateFile({}, "includes.vert"),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_VERIFY(converter->convertFileToData({}, "includes.vert"));
+        CORRADE_COMPARE(out.str(),
+            "Loading includes.vert\n"
+            "Closing includes.vert\n"
+            "Loading includes.vert\n"
+            "Closing includes.vert\n");
+    }
+
+    /* Disabling the cache drops its contents and everything is loaded through
+       the callback again */
+    converter->configuration().setValue("cacheIncludes", false);
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_COMPARE(converter->validateFile({}, "includes.vert"),
+            Containers::pair(true, Containers::String{}));
+        CORRADE_COMPARE_AS(out.str(),
+            "Loading includes.vert\n"
+            "Loading sub/directory/basics.glsl\n",
+            TestSuite::Compare::StringHasPrefix);
+    }
+}
+
 void GlslangConverterTest::validateWrongInputFormat() {
     Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
 
@@ -893,6 +994,148 @@ void GlslangConverterTest::convertWrongDebugInfoLevel() {
         "ShaderTools::GlslangConverter::convertDataToData(): debug info level should be 0, 1 or empty but got 2\n");
 }
 
+void GlslangConverterTest::convertCache() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+
+    /* Start with an empty cache */
+    const Containers::String cacheDirectory = Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_OUTPUT_DIR, "cache");
+    if(Utility::Path::exists(cacheDirectory)) {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDotAndDotDot|Utility::Path::ListFlag::SkipDirectories);
+        CORRADE_VERIFY(files);
+        for(const Containers::String& file: *files)
+            CORRADE_VERIFY(Utility::Path::remove(Utility::Path::join(cacheDirectory, file)));
+    }
+
+    converter->configuration().setValue("cacheDirectory", cacheDirectory);
+    converter->setFlags(ConverterFlag::Verbose);
+    converter->setDefinitions({
+        {"A_DEFINE", ""},
+        {"AN_UNDEFINE", "something awful!!"},
+        {"AN_UNDEFINE", nullptr}
+    });
+
+    const Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, "shader.vk.frag"));
+    CORRADE_VERIFY(file);
+
+    /* The first conversion compiles the shader and saves it to the cache */
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(converter->convertDataToData(Stage::Fragment, *file));
+        CORRADE_COMPARE(out.str(), "");
+    }
+
+    Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDotAndDotDot|Utility::Path::ListFlag::SkipDirectories);
+    CORRADE_VERIFY(files);
+    CORRADE_COMPARE(files->size(), 1);
+    CORRADE_VERIFY((*files)[0].hasSuffix(".spv"_s));
+
+    /* Replace the cached file with a different (valid) SPIR-V to verify it's
+       really picked up from there and not compiled again */
+    const Containers::Optional<Containers::Array<char>> different = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, "shader.gl.spv"));
+    CORRADE_VERIFY(different);
+    CORRADE_VERIFY(Utility::Path::write(Utility::Path::join(cacheDirectory, (*files)[0]), *different));
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        Containers::Optional<Containers::Array<char>> output = converter->convertDataToData(Stage::Fragment, *file);
+        CORRADE_VERIFY(output);
+        CORRADE_COMPARE(Containers::StringView{*output}, Containers::StringView{*different});
+        CORRADE_COMPARE(out.str(), Utility::formatString(
+            "ShaderTools::GlslangConverter::convertDataToData(): using cached {}\n", (*files)[0]));
+    }
+
+    /* Different definitions result in a different cache entry, so the
+       shader gets compiled again */
+    converter->setDefinitions({
+        {"A_DEFINE", ""}
+    });
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        Containers::Optional<Containers::Array<char>> output = converter->convertDataToData(Stage::Fragment, *file);
+        CORRADE_VERIFY(output);
+        CORRADE_COMPARE_AS(Containers::StringView{*output}, Containers::StringView{*different},
+            TestSuite::Compare::NotEqual);
+        CORRADE_COMPARE(out.str(), "");
+    }
+
+    files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDotAndDotDot|Utility::Path::ListFlag::SkipDirectories);
+    CORRADE_VERIFY(files);
+    CORRADE_COMPARE(files->size(), 2);
+}
+
+void GlslangConverterTest::convertBatch() {
+    auto&& data = ConvertBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+
+    const Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(GLSLANGSHADERCONVERTER_TEST_DIR, "shader.vk.frag"));
+    CORRADE_VERIFY(file);
+
+    /* Compile the reference outputs serially first */
+    const Containers::Pair<Containers::StringView, Containers::StringView> definitions[]{
+        {"A_DEFINE", ""},
+        {"AN_UNDEFINE", "something awful!!"},
+        {"AN_UNDEFINE", nullptr}
+    };
+    const Containers::Pair<Containers::StringView, Containers::StringView> definitionsNonSpirv[]{
+        {"A_DEFINE", ""},
+        {"VALIDATE_NON_SPIRV", ""}
+    };
+    converter->setDefinitions(definitions);
+    Containers::Optional<Containers::Array<char>> expected = converter->convertDataToData(Stage::Fragment, *file);
+    CORRADE_VERIFY(expected);
+
+    /* These get ignored by the batch conversion in favor of the per-job
+       definitions */
+    converter->setDefinitions(definitionsNonSpirv);
+
+    /* A file that fails to compile in between two that succeed, repeated
+       several times to have enough jobs for all threads */
+    const GlslangConverter::BatchJob jobs[]{
+        {Stage::Fragment, *file, definitions},
+        {Stage::Fragment, "#version 450\nvoid main() { nope = 1; }\n"_s, {}},
+        {Stage::Fragment, *file, definitions},
+        {Stage::Fragment, *file, definitions},
+        {Stage::Fragment, "#version 450\nvoid main() { nope = 1; }\n"_s, {}},
+        {Stage::Fragment, *file, definitions},
+    };
+
+    converter->configuration().setValue("threads", data.threads);
+    Containers::Optional<Containers::Array<GlslangConverter::BatchResult>> results = static_cast<GlslangConverter&>(*converter).convertDataToDataBatch(jobs);
+    CORRADE_VERIFY(results);
+    CORRADE_COMPARE(results->size(), Containers::arraySize(jobs));
+
+    for(std::size_t i: {0, 2, 3, 5}) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY((*results)[i].data);
+        CORRADE_COMPARE(Containers::StringView{*(*results)[i].data}, Containers::StringView{*expected});
+        CORRADE_COMPARE((*results)[i].log, "");
+    }
+
+    for(std::size_t i: {1, 4}) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(!(*results)[i].data);
+        CORRADE_COMPARE_AS((*results)[i].log,
+            "ERROR: 0:2: 'nope' : undeclared identifier",
+            TestSuite::Compare::StringHasPrefix);
+    }
+}
+
+void GlslangConverterTest::convertBatchWrongOutputVersion() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("GlslangShaderConverter");
+
+    converter->setOutputFormat({}, "vulkan1.0 spv2.0");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<GlslangConverter&>(*converter).convertDataToDataBatch({}));
+    CORRADE_COMPARE(out.str(),
+        "ShaderTools::GlslangConverter::convertDataToDataBatch(): output format version language should be spvX.Y but got spv2.0\n");
+}
+
 void GlslangConverterTest::convertFail() {
     auto&& data = ConvertFailData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -28,8 +28,12 @@
 #include "GltfImporter.h"
 
 #include <algorithm> /* std::stable_sort() */
+#include <atomic>
 #include <cctype>
 #include <unordered_map>
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include <thread>
+#endif
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayTuple.h>
 #include <Corrade/Containers/ArrayView.h>
@@ -92,8 +96,8 @@ using namespace Math::Literals;
 
 namespace {
 
-/* Data URI according to RFC 2397, used by loadUri() and
-   setupOrReuseImporterForImage() */
+/* Data URI according to RFC 2397, used by loadUri(), bufferLocation() and
+   openImageImporter() */
 inline bool isDataUri(const Containers::StringView uri) {
     return uri.hasPrefix("data:"_s);
 }
@@ -283,6 +287,36 @@ struct GltfImporter::Document {
 
     UnsignedInt imageImporterId = ~UnsignedInt{};
     Containers::Optional<AnyImageImporter> imageImporter;
+
+    /* Images decoded in prefetchImages() if the prefetchImages option is
+       enabled, indexed the same as imagesByDimension. Empty if the option
+       isn't enabled. Each level is handed out just once, importing it again
+       goes through imageImporter above. A zero levelCount means the image
+       wasn't prefetched at all. */
+    struct PrefetchedImage {
+        UnsignedInt levelCount;
+        Containers::Array<Containers::Optional<ImageData2D>> levels2D;
+        Containers::Array<Containers::Optional<ImageData3D>> levels3D;
+    };
+    Containers::Array<PrefetchedImage> prefetchedImages;
+};
+
+/* Output of parseMesh(), shared by doMesh() and meshLayout() */
+struct GltfImporter::ParsedMesh {
+    MeshPrimitive primitive;
+
+    /* Attributes point to the original buffer data and are all in the same
+       buffer, vertexData is the range spanning all of them */
+    Containers::Array<MeshAttributeData> attributeData;
+    UnsignedInt vertexCount;
+    UnsignedInt vertexBufferId;
+    Containers::ArrayView<const char> vertexData;
+
+    /* Index type is left at MeshIndexType{} for non-indexed meshes,
+       indexData points to the original buffer data */
+    MeshIndexType indexType{};
+    UnsignedInt indexBufferId = ~UnsignedInt{};
+    Containers::ArrayView<const char> indexData;
 };
 
 Containers::Optional<Containers::Array<char>> GltfImporter::loadUri(const char* const errorPrefix, const Containers::StringView uri) {
@@ -1522,6 +1556,11 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
     _d->accessors = Containers::Array<Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>>>{_d->gltfAccessors.size()};
     _d->samplers = Containers::Array<Containers::Optional<Document::Sampler>>{_d->gltfSamplers.size()};
 
+    /* Decode all images upfront, if requested. Opening the images needs the
+       plugin manager, without it image2D() / image3D() would assert anyway. */
+    if(configuration().value<bool>("prefetchImages") && manager())
+        prefetchImages();
+
     /* Name maps are lazy-loaded because these might not be needed every time */
 }
 
@@ -3256,14 +3295,14 @@ template<class T, class F, class G> std::size_t stableSortRemoveDuplicatesToPref
 
 }
 
-Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+Containers::Optional<GltfImporter::ParsedMesh> GltfImporter::parseMesh(const char* const errorPrefix, const UnsignedInt id) {
     const Utility::JsonToken& gltfPrimitive = _d->gltfMeshPrimitiveMap[id].second();
 
     /* Primitive is optional, defaulting to triangles */
     MeshPrimitive primitive = MeshPrimitive::Triangles;
     if(const Utility::JsonToken* gltfMode = gltfPrimitive.find("mode"_s)) {
         if(!_d->gltf->parseUnsignedInt(*gltfMode)) {
-            Error{} << "Trade::GltfImporter::mesh(): invalid primitive mode property";
+            Error{} << errorPrefix << "invalid primitive mode property";
             return {};
         }
         switch(gltfMode->asUnsignedInt()) {
@@ -3289,7 +3328,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
                 primitive = MeshPrimitive::TriangleFan;
                 break;
             default:
-                Error{} << "Trade::GltfImporter::mesh(): unrecognized primitive" << gltfMode->asUnsignedInt();
+                Error{} << errorPrefix << "unrecognized primitive" << gltfMode->asUnsignedInt();
                 return {};
         }
     }
@@ -3301,7 +3340,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
            custom attribute discovery, so we just use it directly. */
         for(Utility::JsonObjectItem gltfAttribute: gltfAttributes->asObject()) {
             if(!_d->gltf->parseUnsignedInt(gltfAttribute.value())) {
-                Error{} << "Trade::GltfImporter::mesh(): invalid attribute" << gltfAttribute.key();
+                Error{} << errorPrefix << "invalid attribute" << gltfAttribute.key();
                 return {};
             }
             /* Bounds check is done in parseAccessor() later, no need to do it
@@ -3316,7 +3355,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
        enabled. Not printing a warning if the strict option is disabled as
        Magnum can handle the attribute-less MeshData just fine. */
     if(attributeOrder.isEmpty() && configuration().value<bool>("strict")) {
-        Error{} << "Trade::GltfImporter::mesh(): strict mode enabled, disallowing a mesh with no attributes";
+        Error{} << errorPrefix << "strict mode enabled, disallowing a mesh with no attributes";
         return {};
     }
 
@@ -3328,7 +3367,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         for(Utility::JsonArrayItem gltfTarget: gltfTargets->asArray()) {
             for(Utility::JsonObjectItem gltfMorphAttribute: gltfTarget.value().asObject()) {
                 if(!_d->gltf->parseUnsignedInt(gltfMorphAttribute.value())) {
-                    Error{} << "Trade::GltfImporter::mesh(): invalid morph target attribute" << gltfMorphAttribute.key();
+                    Error{} << errorPrefix << "invalid morph target attribute" << gltfMorphAttribute.key();
                     return {};
                 }
 
@@ -3377,7 +3416,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
                 lastNumberedAttribute.second() = -1;
             const Int index = attributeNameNumber[2][0] - '0';
             if(index != lastNumberedAttribute.second() + 1 && !(flags() & ImporterFlag::Quiet)) {
-                Warning{} << "Trade::GltfImporter::mesh(): found attribute" << attribute.first() << "but expected" << attributeNameNumber[0] << Debug::nospace << "_" << Debug::nospace << lastNumberedAttribute.second() + 1;
+                Warning{} << errorPrefix << "found attribute" << attribute.first() << "but expected" << attributeNameNumber[0] << Debug::nospace << "_" << Debug::nospace << lastNumberedAttribute.second() + 1;
             }
 
             baseAttributeName = attributeNameNumber[0];
@@ -3392,7 +3431,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         }
 
         /* Get the accessor view */
-        Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor("Trade::GltfImporter::mesh():", attribute.second());
+        Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor(errorPrefix, attribute.second());
         if(!accessor) return {};
 
         /* From the builtin attributes can fire either for ObjectId or for
@@ -3400,7 +3439,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         if(configuration().value<bool>("strict") && vertexFormatComponentFormat(accessor->second()) == VertexFormat::UnsignedInt) {
             /** @todo for JOINTS this prints Vector4ui while the actual
                 imported attribute is then UnsignedInt[], fix this somehow? */
-            Error{} << "Trade::GltfImporter::mesh(): strict mode enabled, disallowing" << attribute.first() << "with a 32-bit integer vertex format" << Debug::packed << accessor->second();
+            Error{} << errorPrefix << "strict mode enabled, disallowing" << attribute.first() << "with a 32-bit integer vertex format" << Debug::packed << accessor->second();
             return {};
         }
 
@@ -3419,7 +3458,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
            attribute.first() == configuration().value<Containers::StringView>("objectIdAttribute"))
         ) {
             Error e;
-            e << "Trade::GltfImporter::mesh():";
+            e << errorPrefix;
             if(attribute.first() == configuration().value<Containers::StringView>("objectIdAttribute"))
                 e << "object ID attribute";
             e << attribute.first() << "is not allowed to be a morph target";
@@ -3521,7 +3560,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
                quiet output is requested. */
             if(configuration().value<bool>("strict") || !(flags() & ImporterFlag::Quiet)) {
                 Debug e = configuration().value<bool>("strict") ? static_cast<Debug&&>(Error{}) : static_cast<Debug&&>(Warning{});
-                e << "Trade::GltfImporter::mesh(): unsupported";
+                e << errorPrefix << "unsupported";
 
                 /* If the attribute is meant to be recognized as an object ID,
                    mention it as such to avoid confusion */
@@ -3562,7 +3601,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         } else {
             /* ... and probably never will be */
             if(bufferView.third() != bufferId) {
-                Error{} << "Trade::GltfImporter::mesh(): meshes spanning multiple buffers are not supported";
+                Error{} << errorPrefix << "meshes spanning multiple buffers are not supported";
                 return {};
             }
 
@@ -3570,7 +3609,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
 
             if(accessor->first().size()[0] != vertexCount) {
                 Error e;
-                e << "Trade::GltfImporter::mesh(): mismatched vertex count for attribute" << attribute.first();
+                e << errorPrefix << "mismatched vertex count for attribute" << attribute.first();
                 if(morphTargetId != -1)
                     e << "in morph target" << morphTargetId;
                 e << Debug::nospace << ", expected" << vertexCount << "but got" << accessor->first().size()[0];
@@ -3610,7 +3649,7 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
        a warning if the strict option is disabled as Magnum can handle the
        vertex-less MeshData just fine. */
     if(!vertexCount && configuration().value<bool>("strict")) {
-        Error{} << "Trade::GltfImporter::mesh(): strict mode enabled, disallowing a mesh with no vertices";
+        Error{} << errorPrefix << "strict mode enabled, disallowing a mesh with no vertices";
         return {};
     }
 
@@ -3619,18 +3658,67 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
        number of WEIGHTS_n attribute sets". Which aligns well with the
        assertion that's in MeshData itself. */
     if(jointIdAttributeCount != weightAttributeCount) {
-        Error{} << "Trade::GltfImporter::mesh(): the mesh has" << jointIdAttributeCount << "JOINTS_n attributes but" << weightAttributeCount << "WEIGHTS_n attributes";
+        Error{} << errorPrefix << "the mesh has" << jointIdAttributeCount << "JOINTS_n attributes but" << weightAttributeCount << "WEIGHTS_n attributes";
         return {};
     }
 
+    ParsedMesh out;
+    out.primitive = primitive;
+    out.attributeData = Utility::move(attributeData);
+    out.vertexCount = vertexCount;
+    out.vertexBufferId = bufferId;
+    out.vertexData = Containers::ArrayView<const char>{reinterpret_cast<const char*>(bufferRange.min()), bufferRange.size()};
+
+    /* Indices */
+    if(const Utility::JsonToken* gltfIndices = gltfPrimitive.find("indices"_s)) {
+        if(!_d->gltf->parseUnsignedInt(*gltfIndices)) {
+            Error{} << errorPrefix << "invalid indices property";
+            return {};
+        }
+        /* Bounds check is done in parseAccessor() below, no need to do it
+           here again */
+
+        Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor(errorPrefix, gltfIndices->asUnsignedInt());
+        if(!accessor) return {};
+
+        MeshIndexType type;
+        if(accessor->second() == VertexFormat::UnsignedByte)
+            type = MeshIndexType::UnsignedByte;
+        else if(accessor->second() == VertexFormat::UnsignedShort)
+            type = MeshIndexType::UnsignedShort;
+        else if(accessor->second() == VertexFormat::UnsignedInt)
+            type = MeshIndexType::UnsignedInt;
+        else {
+            /* Since we're abusing VertexFormat for all formats, print just the
+               enum value without the prefix to avoid cofusion */
+            Error{} << errorPrefix << "unsupported index type" << Debug::packed << accessor->second();
+            return {};
+        }
+
+        if(!accessor->first().isContiguous()) {
+            Error{} << errorPrefix << "index buffer view is not contiguous";
+            return {};
+        }
+
+        out.indexType = type;
+        out.indexBufferId = _d->bufferViews[accessor->third()]->third();
+        out.indexData = accessor->first().asContiguous();
+    }
+
+    return out;
+}
+
+Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+    Containers::Optional<ParsedMesh> mesh = parseMesh("Trade::GltfImporter::mesh():", id);
+    if(!mesh) return {};
+
     /* Allocate & copy vertex data, if any */
-    Containers::ArrayView<const char> inputVertexData{reinterpret_cast<const char*>(bufferRange.min()), bufferRange.size()};
-    Containers::Array<char> vertexData{NoInit, bufferRange.size()};
-    Utility::copy(inputVertexData, vertexData);
+    Containers::Array<char> vertexData{NoInit, mesh->vertexData.size()};
+    Utility::copy(mesh->vertexData, vertexData);
 
     /* Convert the attributes from relative to absolute, copy them to a
        non-growable array and do additional patching */
-    for(std::size_t i = 0; i != attributeData.size(); ++i) {
+    for(std::size_t i = 0; i != mesh->attributeData.size(); ++i) {
         /* glTF only requires buffer views to be large enough to fit the actual
            data, not to have the size large enough to fit `count*stride`
            elements. The StridedArrayView expects the latter, so we fake the
@@ -3642,23 +3730,23 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
             whole strides and the remainder (Math::div), then form the view
             with offset in whole strides and then "shift" the view by the
             remainder (once there's StridedArrayView::shift() or some such) */
-        Containers::StridedArrayView1D<char> data{{vertexData, vertexData.size() + attributeData[i].stride()},
-            vertexData + attributeData[i].offset(inputVertexData),
-            vertexCount, attributeData[i].stride()};
+        Containers::StridedArrayView1D<char> data{{vertexData, vertexData.size() + mesh->attributeData[i].stride()},
+            vertexData + mesh->attributeData[i].offset(mesh->vertexData),
+            mesh->vertexCount, mesh->attributeData[i].stride()};
 
-        attributeData[i] = MeshAttributeData{attributeData[i].name(),
-            attributeData[i].format(), data, attributeData[i].arraySize(), attributeData[i].morphTargetId()};
+        mesh->attributeData[i] = MeshAttributeData{mesh->attributeData[i].name(),
+            mesh->attributeData[i].format(), data, mesh->attributeData[i].arraySize(), mesh->attributeData[i].morphTargetId()};
 
         /* Flip Y axis of texture coordinates, unless it's done in the material
            instead */
-        if(attributeData[i].name() == MeshAttribute::TextureCoordinates && !_d->textureCoordinateYFlipInMaterial) {
-           if(attributeData[i].format() == VertexFormat::Vector2)
+        if(mesh->attributeData[i].name() == MeshAttribute::TextureCoordinates && !_d->textureCoordinateYFlipInMaterial) {
+           if(mesh->attributeData[i].format() == VertexFormat::Vector2)
                 for(auto& c: Containers::arrayCast<Vector2>(data))
                     c.y() = 1.0f - c.y();
-            else if(attributeData[i].format() == VertexFormat::Vector2ubNormalized)
+            else if(mesh->attributeData[i].format() == VertexFormat::Vector2ubNormalized)
                 for(auto& c: Containers::arrayCast<Vector2ub>(data))
                     c.y() = 255 - c.y();
-            else if(attributeData[i].format() == VertexFormat::Vector2usNormalized)
+            else if(mesh->attributeData[i].format() == VertexFormat::Vector2usNormalized)
                 for(auto& c: Containers::arrayCast<Vector2us>(data))
                     c.y() = 65535 - c.y();
             /* For these it's always done in the material texture transform as
@@ -3666,65 +3754,35 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
                the KHR_mesh_quantization formats and in that case the texture
                transform should be always present. */
             /* LCOV_EXCL_START */
-            else if(attributeData[i].format() != VertexFormat::Vector2bNormalized &&
-                    attributeData[i].format() != VertexFormat::Vector2sNormalized &&
-                    attributeData[i].format() != VertexFormat::Vector2ub &&
-                    attributeData[i].format() != VertexFormat::Vector2b &&
-                    attributeData[i].format() != VertexFormat::Vector2us &&
-                    attributeData[i].format() != VertexFormat::Vector2s)
+            else if(mesh->attributeData[i].format() != VertexFormat::Vector2bNormalized &&
+                    mesh->attributeData[i].format() != VertexFormat::Vector2sNormalized &&
+                    mesh->attributeData[i].format() != VertexFormat::Vector2ub &&
+                    mesh->attributeData[i].format() != VertexFormat::Vector2b &&
+                    mesh->attributeData[i].format() != VertexFormat::Vector2us &&
+                    mesh->attributeData[i].format() != VertexFormat::Vector2s)
                 CORRADE_INTERNAL_ASSERT_UNREACHABLE();
             /* LCOV_EXCL_STOP */
         }
     }
 
-    /* Indices */
+    /* Copy index data, if any */
     MeshIndexData indices;
     Containers::Array<char> indexData;
-    if(const Utility::JsonToken* gltfIndices = gltfPrimitive.find("indices"_s)) {
-        if(!_d->gltf->parseUnsignedInt(*gltfIndices)) {
-            Error{} << "Trade::GltfImporter::mesh(): invalid indices property";
-            return {};
-        }
-        /* Bounds check is done in parseAccessor() below, no need to do it
-           here again */
-
-        Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor("Trade::GltfImporter::mesh():", gltfIndices->asUnsignedInt());
-        if(!accessor) return {};
-
-        MeshIndexType type;
-        if(accessor->second() == VertexFormat::UnsignedByte)
-            type = MeshIndexType::UnsignedByte;
-        else if(accessor->second() == VertexFormat::UnsignedShort)
-            type = MeshIndexType::UnsignedShort;
-        else if(accessor->second() == VertexFormat::UnsignedInt)
-            type = MeshIndexType::UnsignedInt;
-        else {
-            /* Since we're abusing VertexFormat for all formats, print just the
-               enum value without the prefix to avoid cofusion */
-            Error{} << "Trade::GltfImporter::mesh(): unsupported index type" << Debug::packed << accessor->second();
-            return {};
-        }
-
-        if(!accessor->first().isContiguous()) {
-            Error{} << "Trade::GltfImporter::mesh(): index buffer view is not contiguous";
-            return {};
-        }
-
-        Containers::ArrayView<const char> srcContiguous = accessor->first().asContiguous();
-        indexData = Containers::Array<char>{NoInit, srcContiguous.size()};
-        Utility::copy(srcContiguous, indexData);
-        indices = MeshIndexData{type, indexData};
+    if(mesh->indexType != MeshIndexType{}) {
+        indexData = Containers::Array<char>{NoInit, mesh->indexData.size()};
+        Utility::copy(mesh->indexData, indexData);
+        indices = MeshIndexData{mesh->indexType, indexData};
     }
 
     /* If we have an index-less attribute-less mesh, glTF has no way to supply
        a vertex count, so return 0 */
-    if(!indices.data().size() && !attributeData.size())
-        return MeshData{primitive, 0};
+    if(!mesh->indexData.size() && !mesh->attributeData.size())
+        return MeshData{mesh->primitive, 0};
 
-    return MeshData{primitive,
+    return MeshData{mesh->primitive,
         Utility::move(indexData), indices,
-        Utility::move(vertexData), Utility::move(attributeData),
-        vertexCount, &gltfPrimitive};
+        Utility::move(vertexData), Utility::move(mesh->attributeData),
+        mesh->vertexCount, &_d->gltfMeshPrimitiveMap[id].second().get()};
 }
 
 MeshAttribute GltfImporter::doMeshAttributeForName(const Containers::StringView name) {
@@ -3736,6 +3794,98 @@ Containers::String GltfImporter::doMeshAttributeName(const MeshAttribute name) {
         _d->meshAttributeNames[meshAttributeCustom(name)] : ""_s;
 }
 
+Containers::Optional<GltfImporter::MeshLayout> GltfImporter::meshLayout(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::GltfImporter::meshLayout(): no file opened", {});
+    CORRADE_ASSERT(id < meshCount(), "Trade::GltfImporter::meshLayout(): index" << id << "out of range for" << meshCount() << "entries", {});
+
+    Containers::Optional<ParsedMesh> mesh = parseMesh("Trade::GltfImporter::meshLayout():", id);
+    if(!mesh) return {};
+
+    MeshLayout out;
+    out.primitive = mesh->primitive;
+    out.vertexCount = mesh->vertexCount;
+
+    /* Make the attributes offset-only, relative to the start of the buffer
+       they're in. The buffer was successfully parsed already in parseMesh(),
+       so this can't fail. */
+    out.attributes = Containers::Array<MeshAttributeData>{mesh->attributeData.size()};
+    if(!mesh->attributeData.isEmpty()) {
+        out.vertexBuffer = mesh->vertexBufferId;
+        const Containers::Optional<Containers::ArrayView<const char>> buffer = parseBuffer("", mesh->vertexBufferId);
+        CORRADE_INTERNAL_ASSERT(buffer);
+        for(std::size_t i = 0; i != mesh->attributeData.size(); ++i) {
+            const MeshAttributeData& attribute = mesh->attributeData[i];
+            out.attributes[i] = MeshAttributeData{attribute.name(),
+                attribute.format(), attribute.offset(*buffer),
+                mesh->vertexCount, attribute.stride(), attribute.arraySize(),
+                attribute.morphTargetId()};
+        }
+    }
+
+    if(mesh->indexType != MeshIndexType{}) {
+        const Containers::Optional<Containers::ArrayView<const char>> buffer = parseBuffer("", mesh->indexBufferId);
+        CORRADE_INTERNAL_ASSERT(buffer);
+        out.indexType = mesh->indexType;
+        out.indexBuffer = mesh->indexBufferId;
+        out.indexOffset = mesh->indexData.data() - buffer->data();
+        out.indexCount = mesh->indexData.size()/meshIndexTypeSize(mesh->indexType);
+    }
+
+    return out;
+}
+
+Containers::Optional<GltfImporter::BufferLocation> GltfImporter::bufferLocation(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::GltfImporter::bufferLocation(): no file opened", {});
+
+    if(id >= _d->gltfBuffers.size()) {
+        Error{} << "Trade::GltfImporter::bufferLocation(): buffer index" << id << "out of range for" << _d->gltfBuffers.size() << "buffers";
+        return {};
+    }
+
+    const Utility::JsonToken& gltfBuffer = _d->gltfBuffers[id];
+
+    const Utility::JsonToken* const gltfBufferByteLength = gltfBuffer.find("byteLength"_s);
+    if(!gltfBufferByteLength || !_d->gltf->parseSize(*gltfBufferByteLength)) {
+        Error{} << "Trade::GltfImporter::bufferLocation(): buffer" << id << "has missing or invalid byteLength property";
+        return {};
+    }
+
+    /* The GLB binary chunk, located in the file that was opened */
+    const Utility::JsonToken* const gltfBufferUri = gltfBuffer.find("uri"_s);
+    if(!gltfBufferUri && id == 0 && _d->binChunk) {
+        BufferLocation out;
+        if(_d->filename) out.filename = *_d->filename;
+        out.offset = _d->binChunk->data() - _d->fileData.data();
+        out.size = gltfBufferByteLength->asSize();
+        return out;
+    }
+
+    if(!gltfBufferUri) {
+        Error{} << "Trade::GltfImporter::bufferLocation(): buffer" << id << "has missing uri property";
+        return {};
+    }
+    if(!_d->gltf->parseString(*gltfBufferUri)) {
+        Error{} << "Trade::GltfImporter::bufferLocation(): buffer" << id << "has invalid uri property";
+        return {};
+    }
+    if(isDataUri(gltfBufferUri->asString())) {
+        Error{} << "Trade::GltfImporter::bufferLocation(): buffer" << id << "is embedded in a data URI";
+        return {};
+    }
+
+    /* External file, resolved the same way as in loadUri(). The file is
+       neither opened nor checked for existence. */
+    const Containers::Optional<Containers::String> decodedUri = decodeUri("Trade::GltfImporter::bufferLocation():", gltfBufferUri->asString());
+    if(!decodedUri)
+        return {};
+
+    BufferLocation out;
+    out.filename = Utility::Path::join(_d->filename ? Utility::Path::split(*_d->filename).first() : Containers::StringView{}, *decodedUri);
+    out.offset = 0;
+    out.size = gltfBufferByteLength->asSize();
+    return out;
+}
+
 UnsignedInt GltfImporter::doMaterialCount() const {
     return _d->gltfMaterials.size();
 }
@@ -4965,25 +5115,31 @@ AbstractImporter* GltfImporter::setupOrReuseImporterForImage(const char* const e
     AnyImageImporter importer{*manager()};
     importer.setFlags(flags());
     if(fileCallback()) importer.setFileCallback(fileCallback(), fileCallbackUserData());
+    if(!openImageImporter(errorPrefix, id, expectedDimensions, importer))
+        return nullptr;
+
+    return &_d->imageImporter.emplace(Utility::move(importer));
+}
 
+bool GltfImporter::openImageImporter(const char* const errorPrefix, const UnsignedInt id, const UnsignedInt expectedDimensions, AbstractImporter& importer) {
     const Utility::JsonToken& gltfImage = _d->gltfImages[id].first();
 
     const Utility::JsonToken* gltfUri = gltfImage.find("uri"_s);
     if(gltfUri && !_d->gltf->parseString(*gltfUri)) {
         Error{} << errorPrefix << "invalid uri property";
-        return {};
+        return false;
     }
 
     const Utility::JsonToken* gltfBufferView = gltfImage.find("bufferView"_s);
     if(gltfBufferView && !_d->gltf->parseUnsignedInt(*gltfBufferView)) {
         Error{} << errorPrefix << "invalid bufferView property";
-        return {};
+        return false;
     }
 
     /* Should have either an uri or a buffer view and not both */
     if(!!gltfUri == !!gltfBufferView) {
         Error{} << errorPrefix << "expected exactly one of uri or bufferView properties defined";
-        return {};
+        return false;
     }
 
     /* Load embedded image. Can either be a buffer view or a base64 payload.
@@ -4995,41 +5151,39 @@ AbstractImporter* GltfImporter::setupOrReuseImporterForImage(const char* const e
 
         if(gltfUri) {
             if(!(imageData = loadUri(errorPrefix, gltfUri->asString())))
-                return {};
+                return false;
             imageView = *imageData;
 
         } else if(gltfBufferView) {
             const Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>> bufferView = parseBufferView(errorPrefix, gltfBufferView->asUnsignedInt());
-            if(!bufferView) return {};
+            if(!bufferView) return false;
 
             /* 3.6.1.1. (Binary Data Storage § Buffers and Buffer Views §
                Overview) says "Buffer views with [non-vertex] types of data
                MUST NOT not define byteStride", which makes sense */
             if(bufferView->second()) {
                 Error{} << errorPrefix << "buffer view" << gltfBufferView->asUnsignedInt() << "is strided";
-                return {};
+                return false;
             }
 
             imageView = bufferView->first();
 
         } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 
-        if(!importer.openData(imageView))
-            return nullptr;
-        return &_d->imageImporter.emplace(Utility::move(importer));
+        return importer.openData(imageView);
     }
 
     /* Load external image */
     if(!_d->filename && !fileCallback()) {
         Error{} << errorPrefix << "external images can be imported only when opening files from the filesystem or if a file callback is present";
-        return nullptr;
+        return false;
     }
 
     const Containers::Optional<Containers::String> decodedUri = decodeUri(errorPrefix, gltfUri->asString());
     if(!decodedUri)
-        return nullptr;
+        return false;
     if(!importer.openFile(Utility::Path::join(_d->filename ? Utility::Path::split(*_d->filename).first() : ""_s, *decodedUri)))
-        return nullptr;
+        return false;
 
     UnsignedInt expectedDimensionsImageCount;
     const char* expectedDimensionsString;
@@ -5042,10 +5196,148 @@ AbstractImporter* GltfImporter::setupOrReuseImporterForImage(const char* const e
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
     if(expectedDimensionsImageCount != 1) {
         Error{} << errorPrefix << "expected exactly one" << expectedDimensionsString << "image in an image file but got" << expectedDimensionsImageCount;
-        return nullptr;
+        return false;
     }
 
-    return &_d->imageImporter.emplace(Utility::move(importer));
+    return true;
+}
+
+void GltfImporter::prefetchImages() {
+    const std::size_t imageCount = _d->imagesByDimension.size();
+    _d->prefetchedImages = Containers::Array<Document::PrefetchedImage>{ValueInit, imageCount};
+
+    const UnsignedInt levelLimit = configuration().value<UnsignedInt>("prefetchImageLevels");
+    const std::size_t memoryLimit = configuration().value<std::size_t>("prefetchImageMemoryLimit");
+
+    /* The calling thread is one of the workers, so spawn one thread less.
+       Error and Warning redirection, used to silence the workers, is only
+       thread-local if Corrade is built with CORRADE_BUILD_MULTITHREADED, so
+       without it everything is done serially on the calling thread. Same on
+       Emscripten. */
+    #if defined(CORRADE_BUILD_MULTITHREADED) && !defined(CORRADE_TARGET_EMSCRIPTEN)
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("prefetchImageThreads");
+    if(!threadCount)
+        threadCount = std::thread::hardware_concurrency();
+    threadCount = Math::max(Math::min(threadCount, UnsignedInt(imageCount)), 1u);
+    Containers::Array<std::thread> threads{threadCount - 1};
+    #else
+    const UnsignedInt threadCount = 1;
+    #endif
+
+    /* Opening the images goes through the JSON parser, the plugin manager and
+       the file callbacks, neither of which is safe to use from multiple
+       threads, so it's done serially on the calling thread. Most importers
+       only take a copy of the file in openData() anyway and decode in
+       image2D() / image3D(), which is what gets parallelized. To not have all
+       files in memory at once, the images are processed in windows of
+       threadCount images -- a window is opened, decoded in parallel and the
+       importers are destroyed again, together with their file copies, before
+       the next window is opened. Failures are silenced, a failing image isn't
+       cached and the regular path in image2D() / image3D() prints the message
+       once the image actually gets imported. */
+    Containers::Array<Containers::Optional<AnyImageImporter>> importers{threadCount};
+    std::size_t windowBegin = 0;
+    std::size_t windowEnd = 0;
+
+    /* Each thread picks the next image in the window that wasn't taken yet
+       until there's none left. Every importer instance is used by just one
+       thread, and every thread writes only to the cache entry of the image it
+       took. */
+    std::atomic<std::size_t> nextImage{0};
+    std::atomic<std::size_t> memoryUsed{0};
+    std::atomic<std::size_t> prefetchedCount{0};
+    auto worker = [&]() {
+        Error redirectError{nullptr};
+        Warning redirectWarning{nullptr};
+        for(std::size_t i; (i = nextImage++) < windowEnd; ) {
+            if(!importers[i - windowBegin]) continue;
+
+            AbstractImporter& importer = *importers[i - windowBegin];
+            Document::PrefetchedImage& prefetched = _d->prefetchedImages[i];
+            const bool is2D = i < _d->image2DCount;
+            const UnsignedInt levelCount = is2D ? importer.image2DLevelCount(0) : importer.image3DLevelCount(0);
+            const UnsignedInt prefetchLevelCount = levelLimit ? Math::min(levelCount, levelLimit) : levelCount;
+            if(is2D)
+                prefetched.levels2D = Containers::Array<Containers::Optional<ImageData2D>>{prefetchLevelCount};
+            else
+                prefetched.levels3D = Containers::Array<Containers::Optional<ImageData3D>>{prefetchLevelCount};
+
+            bool cached = false;
+            for(UnsignedInt level = 0; level != prefetchLevelCount; ++level) {
+                /* Don't bother decoding if the limit is already reached */
+                if(memoryLimit && memoryUsed >= memoryLimit) break;
+
+                /* Cache only images that own their data, a view on memory
+                   owned by the importer instance would dangle once it's
+                   destroyed at the end of the window. If the image doesn't
+                   fit into the limit, it's discarded together with all
+                   remaining levels. The size gets added before checking so
+                   concurrent threads never overshoot the limit, at worst
+                   they discard an image that would still fit. */
+                if(is2D) {
+                    Containers::Optional<ImageData2D> image = importer.image2D(0, level);
+                    if(!image || !(image->dataFlags() & DataFlag::Owned)) continue;
+                    const std::size_t used = memoryUsed.fetch_add(image->data().size()) + image->data().size();
+                    if(memoryLimit && used > memoryLimit) {
+                        memoryUsed -= image->data().size();
+                        break;
+                    }
+                    prefetched.levels2D[level] = Utility::move(image);
+                    cached = true;
+                } else {
+                    Containers::Optional<ImageData3D> image = importer.image3D(0, level);
+                    if(!image || !(image->dataFlags() & DataFlag::Owned)) continue;
+                    const std::size_t used = memoryUsed.fetch_add(image->data().size()) + image->data().size();
+                    if(memoryLimit && used > memoryLimit) {
+                        memoryUsed -= image->data().size();
+                        break;
+                    }
+                    prefetched.levels3D[level] = Utility::move(image);
+                    cached = true;
+                }
+            }
+
+            prefetched.levelCount = levelCount;
+            if(cached) ++prefetchedCount;
+        }
+    };
+
+    for(; windowBegin < imageCount; windowBegin = windowEnd) {
+        /* Don't bother opening any more files if the limit is already
+           reached, the remaining images aren't cached */
+        if(memoryLimit && memoryUsed >= memoryLimit) break;
+
+        windowEnd = Math::min(windowBegin + threadCount, imageCount);
+        {
+            Error redirectError{nullptr};
+            Warning redirectWarning{nullptr};
+            for(std::size_t i = windowBegin; i != windowEnd; ++i) {
+                AnyImageImporter importer{*manager()};
+                importer.setFlags((flags() & ~ImporterFlag::Verbose)|ImporterFlag::Quiet);
+                if(fileCallback()) importer.setFileCallback(fileCallback(), fileCallbackUserData());
+                if(openImageImporter("", _d->imagesByDimension[i], i < _d->image2DCount ? 2 : 3, importer))
+                    importers[i - windowBegin].emplace(Utility::move(importer));
+            }
+        }
+
+        nextImage = windowBegin;
+        #if defined(CORRADE_BUILD_MULTITHREADED) && !defined(CORRADE_TARGET_EMSCRIPTEN)
+        for(std::thread& thread: threads)
+            thread = std::thread{worker};
+        worker();
+        for(std::thread& thread: threads)
+            thread.join();
+        #else
+        worker();
+        #endif
+
+        /* Free the file data before opening the next window */
+        for(Containers::Optional<AnyImageImporter>& importer: importers)
+            importer = Containers::NullOpt;
+    }
+
+    if(flags() & ImporterFlag::Verbose)
+        Debug{} << "Trade::GltfImporter::openData(): prefetched" << std::size_t{prefetchedCount} << "out of" << imageCount << "images with" << threadCount << "threads," << std::size_t{memoryUsed} << "bytes cached";
 }
 
 UnsignedInt GltfImporter::doImage2DCount() const {
@@ -5072,6 +5364,10 @@ Containers::String GltfImporter::doImage2DName(const UnsignedInt id) {
 UnsignedInt GltfImporter::doImage2DLevelCount(const UnsignedInt id) {
     CORRADE_ASSERT(manager(), "Trade::GltfImporter::image2DLevelCount(): the plugin must be instantiated with access to plugin manager in order to open image files", {});
 
+    /* If the image was prefetched, the level count is known already */
+    if(!_d->prefetchedImages.isEmpty() && _d->prefetchedImages[id].levelCount)
+        return _d->prefetchedImages[id].levelCount;
+
     AbstractImporter* importer = setupOrReuseImporterForImage("Trade::GltfImporter::image2DLevelCount():", _d->imagesByDimension[id], 2);
     /* image2DLevelCount() isn't supposed to fail (image2D() is, instead), so
        report 1 on failure and expect image2D() to fail later */
@@ -5083,12 +5379,20 @@ UnsignedInt GltfImporter::doImage2DLevelCount(const UnsignedInt id) {
 Containers::Optional<ImageData2D> GltfImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
     CORRADE_ASSERT(manager(), "Trade::GltfImporter::image2D(): the plugin must be instantiated with access to plugin manager in order to load images", {});
 
-    AbstractImporter* importer = setupOrReuseImporterForImage("Trade::GltfImporter::image2D():", _d->imagesByDimension[id], 2);
-    if(!importer) return {};
+    /* If the level was prefetched, hand it out and forget it */
+    Containers::Optional<ImageData2D> imageData;
+    if(!_d->prefetchedImages.isEmpty() && level < _d->prefetchedImages[id].levels2D.size() && _d->prefetchedImages[id].levels2D[level]) {
+        imageData = Utility::move(_d->prefetchedImages[id].levels2D[level]);
+        _d->prefetchedImages[id].levels2D[level] = Containers::NullOpt;
+    } else {
+        AbstractImporter* importer = setupOrReuseImporterForImage("Trade::GltfImporter::image2D():", _d->imagesByDimension[id], 2);
+        if(!importer) return {};
+
+        imageData = importer->image2D(0, level);
+        if(!imageData) return Containers::NullOpt;
+    }
 
     /* Include a pointer to the glTF image in the result */
-    Containers::Optional<ImageData2D> imageData = importer->image2D(0, level);
-    if(!imageData) return Containers::NullOpt;
     return ImageData2D{Utility::move(*imageData), &*_d->gltfImages[id].first()};
 }
 
@@ -5116,6 +5420,10 @@ Containers::String GltfImporter::doImage3DName(const UnsignedInt id) {
 UnsignedInt GltfImporter::doImage3DLevelCount(const UnsignedInt id) {
     CORRADE_ASSERT(manager(), "Trade::GltfImporter::image3DLevelCount(): the plugin must be instantiated with access to plugin manager in order to open image files", {});
 
+    /* If the image was prefetched, the level count is known already */
+    if(!_d->prefetchedImages.isEmpty() && _d->prefetchedImages[_d->image2DCount + id].levelCount)
+        return _d->prefetchedImages[_d->image2DCount + id].levelCount;
+
     AbstractImporter* importer = setupOrReuseImporterForImage("Trade::GltfImporter::image3DLevelCount():", _d->imagesByDimension[_d->image2DCount + id], 3);
     /* image3DLevelCount() isn't supposed to fail (image3D() is, instead), so
        report 1 on failure and expect image3D() to fail later */
@@ -5127,6 +5435,16 @@ UnsignedInt GltfImporter::doImage3DLevelCount(const UnsignedInt id) {
 Containers::Optional<ImageData3D> GltfImporter::doImage3D(const UnsignedInt id, const UnsignedInt level) {
     CORRADE_ASSERT(manager(), "Trade::GltfImporter::image3D(): the plugin must be instantiated with access to plugin manager in order to load images", {});
 
+    /* If the level was prefetched, hand it out and forget it */
+    if(!_d->prefetchedImages.isEmpty()) {
+        Containers::Array<Containers::Optional<ImageData3D>>& levels = _d->prefetchedImages[_d->image2DCount + id].levels3D;
+        if(level < levels.size() && levels[level]) {
+            Containers::Optional<ImageData3D> imageData = Utility::move(levels[level]);
+            levels[level] = Containers::NullOpt;
+            return imageData;
+        }
+    }
+
     AbstractImporter* importer = setupOrReuseImporterForImage("Trade::GltfImporter::image3D():", _d->imagesByDimension[_d->image2DCount + id], 3);
     if(!importer) return {};
 
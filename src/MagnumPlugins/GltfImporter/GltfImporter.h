@@ -31,7 +31,12 @@
  * @m_since_latest_{plugins}
  */
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Magnum/Mesh.h>
 #include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/MeshData.h>
 
 #include "MagnumPlugins/GltfImporter/configure.h"
 
@@ -330,6 +335,52 @@ imported meshes as well. Their mapping to/from a string can be queried using
 unsupported types (such as non-normalized integer matrices) cause the import to
 fail.
 
+@subsection Trade-GltfImporter-behavior-meshes-layout Mesh data layout for direct upload
+
+@ref mesh() always copies the index and vertex data referenced by a mesh into
+a newly allocated @ref MeshData. If the data are meant to end up in a GPU
+buffer anyway, the copy can be avoided by querying just the data layout with
+@ref meshLayout(), and then uploading the ranges directly from the file, for
+example by memory-mapping it or reading into GPU staging memory:
+
+@code{.cpp}
+PluginManager::Manager<Trade::AbstractImporter> manager;
+Containers::Pointer<Trade::AbstractImporter> importer =
+    manager.loadAndInstantiate("GltfImporter");
+importer->openFile("scene.glb");
+
+auto& gltfImporter = static_cast<Trade::GltfImporter&>(*importer);
+Containers::Optional<Trade::GltfImporter::MeshLayout> layout =
+    gltfImporter.meshLayout(0);
+Containers::Optional<Trade::GltfImporter::BufferLocation> location =
+    gltfImporter.bufferLocation(layout->vertexBuffer);
+
+// Offset of the first position in location->filename
+std::size_t positionOffset = location->offset +
+    layout->attributes[0].offset(nullptr);
+@endcode
+
+The functions are virtual, which means they can be called through a cast
+plugin instance without having to link to the plugin library.
+@ref MeshLayout::attributes are *offset-only* @ref MeshAttributeData
+instances, with offsets relative to the start of the glTF buffer given by
+@ref MeshLayout::vertexBuffer. Similarly, @ref MeshLayout::indexOffset is
+relative to @ref MeshLayout::indexBuffer. The @ref bufferLocation() then gives
+the file a buffer is in and the offset of the buffer inside the file --- for
+the GLB binary chunk it's the file passed to @ref openFile() with the offset
+of the chunk data, for external buffers it's the buffer file with a zero
+offset. Buffers embedded in data URIs don't have a location in a file.
+
+The layout goes through the same validation as @ref mesh(), and in particular
+all attributes are in a single buffer. External buffers referenced by the mesh
+are still loaded for bounds checking, use a
+@ref Trade-AbstractImporter-usage-callbacks "file callback" that memory-maps
+the files to avoid reading them. The data is however described exactly as it
+is in the file, which means texture coordinates are not Y-flipped. Enable the
+@cb{.ini} textureCoordinateYFlipInMaterial @ce
+@ref Trade-GltfImporter-configuration "configuration option" to have the
+materials account for that instead.
+
 @subsection Trade-GltfImporter-behavior-materials Material import
 
 -   If present, builtin [metallic/roughness](https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#metallic-roughness-material) material is imported,
@@ -495,6 +546,60 @@ get adapted to eventual changes in the extension proposal:
     material will get a @ref MaterialAttribute::BaseColorTextureLayer as well,
     containing the value of the `layer` property.
 
+@subsection Trade-GltfImporter-behavior-textures-prefetch Image prefetching
+
+By default, images are opened and decoded only once requested through
+@ref image2D() or @ref image3D(), on the calling thread. If the
+@cb{.ini} prefetchImages @ce @ref Trade-GltfImporter-configuration "configuration option"
+is enabled, all images referenced by the file, no matter whether external,
+embedded in a buffer view or in a data URI, are decoded already during
+@ref openData() / @ref openFile(), using @cb{.ini} prefetchImageThreads @ce
+threads:
+
+-   The image files are opened serially on the calling thread, as that goes
+    through the plugin manager and the file callbacks, and only the decoding
+    is done in parallel, one image per thread at a time. Prefetching thus
+    helps the most with formats that are expensive to decode, such as PNG,
+    JPEG, WebP or Basis Universal.
+-   To avoid having all image files in memory at once, the images are
+    processed in windows of @cb{.ini} prefetchImageThreads @ce images. All
+    files in a window are opened, decoded and closed again before the next
+    window is opened, so at most that many files are in memory at the same
+    time in addition to the cached image data.
+-   Decoded image levels are cached and returned from @ref image2D() /
+    @ref image3D() without any further work. Each level is returned from the
+    cache only once, importing it again decodes it on the calling thread like
+    if prefetching wasn't enabled.
+-   Images that fail to be opened or decoded aren't cached and no message is
+    printed for them during prefetch. The failure is reported only once the
+    image is actually requested.
+-   Only the first @cb{.ini} prefetchImageLevels @ce levels of each image
+    are cached, if the option is non-zero. If the total size of the cached
+    image data would exceed @cb{.ini} prefetchImageMemoryLimit @ce bytes,
+    remaining images aren't cached and their files aren't opened at all. The
+    limit applies only to the decoded image data, not to the files opened for
+    the current window. Images that are a view on memory owned by the image
+    importer aren't cached either.
+-   Error and warning redirection, used to silence the prefetch, is
+    thread-safe only if Corrade is built with
+    @ref CORRADE_BUILD_MULTITHREADED enabled. Without it, and on
+    @ref CORRADE_TARGET_EMSCRIPTEN "Emscripten", the
+    @cb{.ini} prefetchImageThreads @ce option is ignored and the images are
+    always decoded serially on the calling thread.
+
+@subsection Trade-GltfImporter-behavior-loading Loading the plugin fails with undefined symbol: pthread_create
+
+On Linux it may happen that loading the plugin will fail with
+`undefined symbol: pthread_create`. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+plugin isn't linked to `pthread` and requires *the application* to link to it
+instead. With CMake it can be done like this:
+
+@code{.cmake}
+find_package(Threads REQUIRED)
+target_link_libraries(your-application PRIVATE Threads::Threads)
+@endcode
+
 @section Trade-GltfImporter-configuration Plugin-specific configuration
 
 It's possible to tune various output options through @ref configuration(). See
@@ -584,8 +689,118 @@ class MAGNUM_GLTFIMPORTER_EXPORT GltfImporter: public AbstractImporter {
             return static_cast<const Utility::Json*>(AbstractImporter::importerState());
         }
 
+        /**
+         * @brief Mesh data layout
+         * @m_since_latest_{plugins}
+         *
+         * @see @ref meshLayout()
+         */
+        struct MeshLayout {
+            /** @brief Primitive */
+            MeshPrimitive primitive;
+
+            /** @brief Vertex count */
+            UnsignedInt vertexCount;
+
+            /**
+             * @brief Vertex buffer ID
+             *
+             * Index of the glTF buffer all @ref attributes are in, pass it
+             * to @ref bufferLocation() to get its location in a file.
+             * @cpp 0xffffffffu @ce if there are no attributes.
+             */
+            UnsignedInt vertexBuffer = ~UnsignedInt{};
+
+            /**
+             * @brief Attributes
+             *
+             * Offset-only attributes, with offsets relative to the start of
+             * @ref vertexBuffer.
+             */
+            Containers::Array<MeshAttributeData> attributes;
+
+            /**
+             * @brief Index type
+             *
+             * @cpp MeshIndexType{} @ce if the mesh is not indexed.
+             */
+            MeshIndexType indexType{};
+
+            /**
+             * @brief Index buffer ID
+             *
+             * Index of the glTF buffer the indices are in, pass it to
+             * @ref bufferLocation() to get its location in a file.
+             * @cpp 0xffffffffu @ce if the mesh is not indexed.
+             */
+            UnsignedInt indexBuffer = ~UnsignedInt{};
+
+            /**
+             * @brief Index offset
+             *
+             * Relative to the start of @ref indexBuffer, the indices are
+             * always contiguous.
+             */
+            std::size_t indexOffset = 0;
+
+            /** @brief Index count */
+            UnsignedInt indexCount = 0;
+        };
+
+        /**
+         * @brief Buffer location in a file
+         * @m_since_latest_{plugins}
+         *
+         * @see @ref bufferLocation()
+         */
+        struct BufferLocation {
+            /**
+             * @brief File the buffer is in
+             *
+             * Empty if the buffer is the GLB binary chunk and the file was
+             * opened with @ref openData().
+             */
+            Containers::String filename;
+
+            /** @brief Offset of the buffer data in the file */
+            std::size_t offset;
+
+            /** @brief Buffer size */
+            std::size_t size;
+        };
+
+        /**
+         * @brief Mesh data layout
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened and @p id is less than
+         * @ref meshCount(). Performs the same validation as @ref mesh(),
+         * but instead of copying the index and vertex data returns their
+         * layout relative to the glTF buffers they're in. On failure prints
+         * a message to @relativeref{Magnum,Error} and returns
+         * @relativeref{Corrade,Containers::NullOpt}. See
+         * @ref Trade-GltfImporter-behavior-meshes-layout for more
+         * information.
+         */
+        virtual Containers::Optional<MeshLayout> meshLayout(UnsignedInt id);
+
+        /**
+         * @brief Buffer location in a file
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened. The file isn't opened or checked
+         * for existence. If @p id is out of range, the buffer is embedded in
+         * a data URI or its properties are invalid, prints a message to
+         * @relativeref{Magnum,Error} and returns
+         * @relativeref{Corrade,Containers::NullOpt}. See
+         * @ref Trade-GltfImporter-behavior-meshes-layout for more
+         * information.
+         */
+        virtual Containers::Optional<BufferLocation> bufferLocation(UnsignedInt id);
+
     private:
         struct Document;
+        struct ParsedMesh;
 
         MAGNUM_GLTFIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
 
@@ -631,6 +846,7 @@ class MAGNUM_GLTFIMPORTER_EXPORT GltfImporter: public AbstractImporter {
         MAGNUM_GLTFIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
         MAGNUM_GLTFIMPORTER_LOCAL Int doMeshForName(Containers::StringView name) override;
         MAGNUM_GLTFIMPORTER_LOCAL Containers::String doMeshName(UnsignedInt id) override;
+        MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<ParsedMesh> parseMesh(const char* errorPrefix, UnsignedInt id);
         MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
         MAGNUM_GLTFIMPORTER_LOCAL MeshAttribute doMeshAttributeForName(Containers::StringView name) override;
         MAGNUM_GLTFIMPORTER_LOCAL Containers::String doMeshAttributeName(MeshAttribute name) override;
@@ -646,6 +862,8 @@ class MAGNUM_GLTFIMPORTER_EXPORT GltfImporter: public AbstractImporter {
         MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<TextureData> doTexture(UnsignedInt id) override;
 
         MAGNUM_GLTFIMPORTER_LOCAL AbstractImporter* setupOrReuseImporterForImage(const char* errorPrefix, UnsignedInt id, UnsignedInt expectedDimensions);
+        MAGNUM_GLTFIMPORTER_LOCAL bool openImageImporter(const char* errorPrefix, UnsignedInt id, UnsignedInt expectedDimensions, AbstractImporter& importer);
+        MAGNUM_GLTFIMPORTER_LOCAL void prefetchImages();
 
         MAGNUM_GLTFIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_GLTFIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
@@ -77,6 +77,8 @@
 #include <emscripten/version.h>
 #endif
 
+#include "MagnumPlugins/GltfImporter/GltfImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -155,6 +157,9 @@ struct GltfImporterTest: TestSuite::Tester {
     void meshInvalidWholeFile();
     void meshInvalid();
     void meshInvalidBufferNotFound();
+    void meshLayout();
+    void meshLayoutNoIndices();
+    void bufferLocationInvalid();
 
     void materialPbrMetallicRoughness();
     void materialPbrSpecularGlossiness();
@@ -187,6 +192,8 @@ struct GltfImporterTest: TestSuite::Tester {
     void imageInvalid();
     void imageInvalidNotFound();
     void imagePropagateImporterFlags();
+    void imagePrefetch();
+    void imagePrefetchInvalid();
 
     void experimentalKhrTextureKtx2D();
     void experimentalKhrTextureKtx2DArray();
@@ -490,6 +497,16 @@ constexpr struct {
     {"binary embedded", "-embedded.glb"}
 };
 
+constexpr struct {
+    const char* name;
+    const char* suffix;
+    const char* bufferFilename;
+} MeshLayoutData[]{
+    {"ascii", ".gltf", "mesh.bin"},
+    {"binary", ".glb", "mesh.glb"},
+    {"binary embedded", "-embedded.glb", "mesh-embedded.glb"}
+};
+
 constexpr struct {
     const char* name;
     const char* message;
@@ -1469,6 +1486,24 @@ constexpr struct {
     {"embedded binary", "-embedded.glb"},
 };
 
+constexpr struct {
+    const char* name;
+    const char* suffix;
+    UnsignedInt threads;
+    std::size_t memoryLimit;
+    std::size_t expectedPrefetched;
+    UnsignedInt expectedThreads;
+    std::size_t expectedCachedSize;
+} ImagePrefetchData[]{
+    {"serial", ".gltf", 1, 0, 2, 1, 120},
+    {"multithreaded", ".gltf", 4, 0, 2, 2, 120},
+    {"multithreaded, embedded", "-embedded.gltf", 4, 0, 2, 2, 120},
+    {"multithreaded, buffer view", "-buffer-embedded.glb", 4, 0, 2, 2, 120},
+    /* With one thread it's deterministic which image goes first */
+    {"memory limit", ".gltf", 1, 100, 1, 1, 60},
+    {"memory limit too small", ".gltf", 1, 59, 0, 1, 0},
+};
+
 const struct {
     const char* name;
     const char* requiresPlugin;
@@ -1746,6 +1781,12 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::meshInvalidBufferNotFound},
         Containers::arraySize(MeshInvalidBufferNotFoundData));
 
+    addInstancedTests({&GltfImporterTest::meshLayout},
+        Containers::arraySize(MeshLayoutData));
+
+    addTests({&GltfImporterTest::meshLayoutNoIndices,
+              &GltfImporterTest::bufferLocationInvalid});
+
     addTests({&GltfImporterTest::materialPbrMetallicRoughness,
               &GltfImporterTest::materialPbrSpecularGlossiness,
               &GltfImporterTest::materialCommon,
@@ -1804,6 +1845,11 @@ GltfImporterTest::GltfImporterTest() {
 
     addTests({&GltfImporterTest::imagePropagateImporterFlags});
 
+    addInstancedTests({&GltfImporterTest::imagePrefetch},
+        Containers::arraySize(ImagePrefetchData));
+
+    addTests({&GltfImporterTest::imagePrefetchInvalid});
+
     addTests({&GltfImporterTest::experimentalKhrTextureKtx2D,
               &GltfImporterTest::experimentalKhrTextureKtx2DArray,
               &GltfImporterTest::experimentalKhrTextureKtxPhongFallback});
@@ -5174,6 +5220,109 @@ void GltfImporterTest::meshInvalidBufferNotFound() {
         TestSuite::Compare::StringHasSuffix);
 }
 
+void GltfImporterTest::meshLayout() {
+    auto&& data = MeshLayoutData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh"_s + data.suffix)));
+
+    auto& gltfImporter = static_cast<GltfImporter&>(*importer);
+    Containers::Optional<GltfImporter::MeshLayout> layout = gltfImporter.meshLayout(0);
+    CORRADE_VERIFY(layout);
+    CORRADE_COMPARE(layout->primitive, MeshPrimitive::Triangles);
+    CORRADE_COMPARE(layout->vertexCount, 3);
+
+    /* Attributes are sorted by name, same as in mesh(). Offsets are relative
+       to the buffer, not to the buffer view. */
+    CORRADE_COMPARE(layout->vertexBuffer, 0);
+    CORRADE_COMPARE(layout->attributes.size(), 5);
+    CORRADE_VERIFY(layout->attributes[0].isOffsetOnly());
+    CORRADE_COMPARE(layout->attributes[0].name(), MeshAttribute::Normal);
+    CORRADE_COMPARE(layout->attributes[0].format(), VertexFormat::Vector3);
+    CORRADE_COMPARE(layout->attributes[0].offset(nullptr), 16);
+    CORRADE_COMPARE(layout->attributes[0].stride(), 40);
+    CORRADE_COMPARE(layout->attributes[1].name(), MeshAttribute::Position);
+    CORRADE_COMPARE(layout->attributes[1].format(), VertexFormat::Vector3);
+    CORRADE_COMPARE(layout->attributes[1].offset(nullptr), 4);
+    CORRADE_COMPARE(layout->attributes[1].stride(), 40);
+    CORRADE_COMPARE(layout->attributes[2].name(), MeshAttribute::Tangent);
+    CORRADE_COMPARE(layout->attributes[2].format(), VertexFormat::Vector4);
+    CORRADE_COMPARE(layout->attributes[2].offset(nullptr), 28);
+    CORRADE_COMPARE(layout->attributes[2].stride(), 40);
+    CORRADE_COMPARE(layout->attributes[3].name(), MeshAttribute::TextureCoordinates);
+    CORRADE_COMPARE(layout->attributes[3].format(), VertexFormat::Vector2);
+    CORRADE_COMPARE(layout->attributes[3].offset(nullptr), 124);
+    CORRADE_COMPARE(layout->attributes[3].stride(), 8);
+    CORRADE_COMPARE(layout->attributes[4].name(), MeshAttribute::ObjectId);
+    CORRADE_COMPARE(layout->attributes[4].format(), VertexFormat::UnsignedShort);
+    CORRADE_COMPARE(layout->attributes[4].offset(nullptr), 148);
+    CORRADE_COMPARE(layout->attributes[4].stride(), 2);
+
+    CORRADE_COMPARE(layout->indexType, MeshIndexType::UnsignedByte);
+    CORRADE_COMPARE(layout->indexBuffer, 0);
+    CORRADE_COMPARE(layout->indexOffset, 0);
+    CORRADE_COMPARE(layout->indexCount, 3);
+
+    Containers::Optional<GltfImporter::BufferLocation> location = gltfImporter.bufferLocation(layout->vertexBuffer);
+    CORRADE_VERIFY(location);
+    CORRADE_COMPARE(location->filename, Utility::Path::join(GLTFIMPORTER_TEST_DIR, data.bufferFilename));
+    CORRADE_COMPARE(location->size, 154);
+
+    /* Reading the data straight from the file at given offsets should give
+       the same result as mesh() */
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(location->filename);
+    CORRADE_VERIFY(file);
+    CORRADE_COMPARE_AS(file->size(), location->offset + location->size,
+        TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE_AS((Containers::StridedArrayView1D<const Vector3>{Containers::arrayView(*file),
+        reinterpret_cast<const Vector3*>(file->data() + location->offset + layout->attributes[1].offset(nullptr)),
+        layout->vertexCount, layout->attributes[1].stride()}),
+        Containers::arrayView<Vector3>({
+            {1.5f, -1.0f, -0.5f},
+            {-0.5f, 2.5f, 0.75f},
+            {-2.0f, 1.0f, 0.3f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(Containers::arrayCast<const UnsignedByte>(file->sliceSize(location->offset + layout->indexOffset, layout->indexCount)),
+        Containers::arrayView<UnsignedByte>({0, 1, 2}),
+        TestSuite::Compare::Container);
+}
+
+void GltfImporterTest::meshLayoutNoIndices() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh.gltf")));
+
+    Containers::Optional<GltfImporter::MeshLayout> layout = static_cast<GltfImporter&>(*importer).meshLayout(1);
+    CORRADE_VERIFY(layout);
+    CORRADE_COMPARE(layout->vertexCount, 3);
+    CORRADE_COMPARE(layout->vertexBuffer, 0);
+    CORRADE_COMPARE(layout->attributes.size(), 1);
+    CORRADE_COMPARE(layout->attributes[0].name(), MeshAttribute::Position);
+    CORRADE_COMPARE(layout->attributes[0].offset(nullptr), 4);
+    CORRADE_COMPARE(layout->indexType, MeshIndexType{});
+    CORRADE_COMPARE(layout->indexBuffer, ~UnsignedInt{});
+    CORRADE_COMPARE(layout->indexCount, 0);
+}
+
+void GltfImporterTest::bufferLocationInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-embedded.gltf")));
+
+    auto& gltfImporter = static_cast<GltfImporter&>(*importer);
+
+    /* The layout itself works for data URIs, there's just no file to point
+       to */
+    CORRADE_VERIFY(gltfImporter.meshLayout(0));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!gltfImporter.bufferLocation(0));
+    CORRADE_VERIFY(!gltfImporter.bufferLocation(1));
+    CORRADE_COMPARE(out.str(),
+        "Trade::GltfImporter::bufferLocation(): buffer 0 is embedded in a data URI\n"
+        "Trade::GltfImporter::bufferLocation(): buffer index 1 out of range for 1 buffers\n");
+}
+
 void GltfImporterTest::materialPbrMetallicRoughness() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
 
@@ -6706,6 +6855,80 @@ void GltfImporterTest::imagePropagateImporterFlags() {
         "Trade::AnyImageImporter::openFile(): using PngImporter (provided by StbImageImporter)\n");
 }
 
+void GltfImporterTest::imagePrefetch() {
+    auto&& data = ImagePrefetchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    if(data.threads != 1)
+        CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
+    #endif
+    #ifdef CORRADE_TARGET_EMSCRIPTEN
+    if(data.threads != 1)
+        CORRADE_SKIP("Images are always prefetched serially on Emscripten.");
+    #endif
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->setFlags(ImporterFlag::Verbose);
+    importer->configuration().setValue("prefetchImages", true);
+    importer->configuration().setValue("prefetchImageThreads", data.threads);
+    importer->configuration().setValue("prefetchImageMemoryLimit", data.memoryLimit);
+
+    {
+        std::ostringstream out;
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image"_s + data.suffix)));
+        CORRADE_COMPARE(out.str(), Utility::formatString(
+            "Trade::GltfImporter::openData(): prefetched {} out of 2 images with {} threads, {} bytes cached\n", data.expectedPrefetched, data.expectedThreads, data.expectedCachedSize));
+    }
+
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+    CORRADE_COMPARE(importer->image2DLevelCount(1), 1);
+
+    /* The first import is served from the cache (if it fit), the second goes
+       through the regular path again, both should give the same result. The
+       regular path prints a verbose message from AnyImageImporter, silence
+       it. */
+    Debug redirectOutput{nullptr};
+    for(std::size_t i = 0; i != 2; ++i) {
+        CORRADE_ITERATION(i);
+
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(1);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), Vector2i(5, 3));
+        CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+        CORRADE_COMPARE_AS(image->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+
+        /* Importer state should give the glTF image object in both cases */
+        const auto* state = static_cast<const Utility::JsonToken*>(image->importerState());
+        CORRADE_VERIFY(state);
+        CORRADE_COMPARE((*state)["name"].asString(), "Image");
+    }
+}
+
+void GltfImporterTest::imagePrefetchInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("prefetchImages", true);
+
+    /* Failures during prefetch shouldn't be reported */
+    {
+        std::ostringstream out;
+        Warning redirectWarning{&out};
+        Error redirectError{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image-invalid-notfound.gltf")));
+        CORRADE_COMPARE(out.str(), "");
+    }
+
+    /* Only once the image is actually imported */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_VERIFY(!out.str().empty());
+}
+
 void GltfImporterTest::experimentalKhrTextureKtx2D() {
     if(_manager.loadState("KtxImporter") == PluginManager::LoadState::NotFound)
         CORRADE_SKIP("KtxImporter plugin not found, cannot test");
@@ -26,11 +26,16 @@
 
 #include "IcoImporter.h"
 
+#include <cstring>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/ConfigurationValue.h>
 #include <Magnum/Trade/ImageData.h>
 
 namespace Magnum { namespace Trade {
@@ -61,12 +66,46 @@ struct IconDirEntry {
     UnsignedInt imageDataOffset;
 };
 
+/* BITMAPINFOHEADER, the only header variant used by BMPs embedded in ICOs.
+   Unlike standalone BMP files there's no BITMAPFILEHEADER before it. */
+struct BitmapInfoHeader {
+    UnsignedInt headerSize;
+    Int width;
+    /* Twice the image height, as the XOR (color) bitmap is followed by an AND
+       (mask) bitmap of the same size */
+    Int height;
+    UnsignedShort colorPlanes;
+    UnsignedShort bitsPerPixel;
+    UnsignedInt compression;
+    UnsignedInt imageDataSize;
+    Int horizontalResolution;
+    Int verticalResolution;
+    UnsignedInt colorCount;
+    UnsignedInt importantColorCount;
+};
+
+static_assert(sizeof(BitmapInfoHeader) == 40, "improper size of BitmapInfoHeader");
+
+struct Level {
+    /* From the directory entry, used for picking the closest level and for
+       checking the BMP size */
+    Vector2i size;
+    UnsignedShort bitsPerPixel;
+    Containers::ArrayView<const char> data;
+};
+
 }
 
 struct IcoImporter::State {
-    Containers::Pointer<Trade::AbstractImporter> pngImporter;
     Containers::Array<char> data;
-    Containers::Array<Containers::ArrayView<const char>> levels;
+    Containers::Array<Level> levels;
+
+    /* The nested importer references data from the above array, so it has to
+       be destroyed before it */
+    Containers::Pointer<Trade::AbstractImporter> pngImporter;
+    /* Level the pngImporter currently has opened, to avoid reopening it when
+       importing the same level repeatedly */
+    UnsignedInt pngImporterLevel = ~UnsignedInt{};
 };
 
 IcoImporter::IcoImporter() = default;
@@ -97,7 +136,7 @@ void IcoImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
     Utility::Endianness::littleEndianInPlace(header.imageType, header.imageCount);
 
     Containers::Pointer<State> state{InPlaceInit};
-    state->levels = Containers::Array<Containers::ArrayView<const char>>{header.imageCount};
+    state->levels = Containers::Array<Level>{header.imageCount};
 
     /* Take over the existing array or copy the data if we can't */
     if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
@@ -115,9 +154,10 @@ void IcoImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
         }
 
         IconDirEntry iconDirEntry = *reinterpret_cast<const IconDirEntry*>(state->data.begin() + iconDirEntryOffset);
-        /* The other fields need endian swapping as well, but we don't use them
-           so it's not necessary */
+        /* The color planes field needs endian swapping as well, but we don't
+           use it so it's not necessary */
         Utility::Endianness::littleEndianInPlace(
+            iconDirEntry.bitsPerPixel,
             iconDirEntry.imageDataSize,
             iconDirEntry.imageDataOffset
         );
@@ -127,7 +167,45 @@ void IcoImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
             return;
         }
 
-        state->levels[i] = state->data.slice(iconDirEntry.imageDataOffset, iconDirEntry.imageDataOffset + iconDirEntry.imageDataSize);
+        /* Zero width or height means 256 */
+        state->levels[i].size = {
+            iconDirEntry.imageWidth ? iconDirEntry.imageWidth : 256,
+            iconDirEntry.imageHeight ? iconDirEntry.imageHeight : 256
+        };
+        state->levels[i].bitsPerPixel = iconDirEntry.bitsPerPixel;
+        state->levels[i].data = state->data.slice(iconDirEntry.imageDataOffset, iconDirEntry.imageDataOffset + iconDirEntry.imageDataSize);
+    }
+
+    /* If requested, keep just the level closest to given size. That's the
+       smallest level that's at least as large as the requested size in both
+       dimensions or, if there's none, the largest level. Between levels of
+       the same size the one with the most bits per pixel wins. */
+    const Vector2i closestSize = configuration().value<Vector2i>("closestSize");
+    if(closestSize.product() && !state->levels.isEmpty()) {
+        std::size_t closest = 0;
+        for(std::size_t i = 1; i != state->levels.size(); ++i) {
+            const Level& level = state->levels[i];
+            const Level& current = state->levels[closest];
+            const bool fits = (level.size >= closestSize).all();
+            const bool currentFits = (current.size >= closestSize).all();
+            if(fits != currentFits) {
+                if(fits) closest = i;
+                continue;
+            }
+
+            const Int area = level.size.product();
+            const Int currentArea = current.size.product();
+            if(area == currentArea ? level.bitsPerPixel > current.bitsPerPixel :
+               fits ? area < currentArea : area > currentArea)
+                closest = i;
+        }
+
+        if(flags() & ImporterFlag::Verbose)
+            Debug{} << "Trade::IcoImporter::openData(): picking a" << Debug::packed << state->levels[closest].size << "level" << closest << "out of" << state->levels.size();
+
+        const Level level = state->levels[closest];
+        state->levels = Containers::Array<Level>{1};
+        state->levels[0] = level;
     }
 
     /* All good, save the state */
@@ -138,24 +216,161 @@ UnsignedInt IcoImporter::doImage2DCount() const { return 1; }
 
 UnsignedInt IcoImporter::doImage2DLevelCount(UnsignedInt) { return _state->levels.size(); }
 
-Containers::Optional<ImageData2D> IcoImporter::doImage2D(UnsignedInt, UnsignedInt level) {
-    if(_state->levels[level].size() < sizeof(PngHeader) || std::memcmp(_state->levels[level].data(), PngHeader, sizeof(PngHeader)) != 0) {
-        Error{} << "Trade::IcoImporter::image2D(): only files with embedded PNGs are supported";
-        return Containers::NullOpt;
+namespace {
+
+Containers::Optional<ImageData2D> decodeBmp(const Containers::ArrayView<const char> data, const Vector2i& expectedSize) {
+    if(data.size() < sizeof(BitmapInfoHeader)) {
+        Error{} << "Trade::IcoImporter::image2D(): BMP header too short, expected at least" << sizeof(BitmapInfoHeader) << "bytes but got" << data.size();
+        return {};
+    }
+
+    BitmapInfoHeader header = *reinterpret_cast<const BitmapInfoHeader*>(data.data());
+    /* The remaining fields need endian swapping as well, but we don't use
+       them so it's not necessary */
+    Utility::Endianness::littleEndianInPlace(
+        header.headerSize,
+        header.width,
+        header.height,
+        header.bitsPerPixel,
+        header.compression,
+        header.colorCount
+    );
+
+    if(header.headerSize < sizeof(BitmapInfoHeader)) {
+        Error{} << "Trade::IcoImporter::image2D(): invalid BMP header size" << header.headerSize;
+        return {};
+    }
+
+    /* Only uncompressed BI_RGB, other variants are practically never used in
+       icons */
+    if(header.compression != 0) {
+        Error{} << "Trade::IcoImporter::image2D(): unsupported BMP compression" << header.compression;
+        return {};
+    }
+
+    /* Top-down bitmaps (with a negative height) aren't allowed in icons */
+    if(header.width <= 0 || header.height <= 0 || header.height % 2) {
+        Error{} << "Trade::IcoImporter::image2D(): invalid BMP size" << Debug::packed << Vector2i{header.width, header.height};
+        return {};
     }
 
-    /* just delegate actual image importing */
+    /* The height includes the AND mask, so it's twice the image height. The
+       size from the directory entry is at most 256x256, which also puts an
+       upper bound on the memory needed for the output and the sizes
+       calculated below. */
+    const Vector2i size{header.width, header.height/2};
+    if(size != expectedSize) {
+        Error{} << "Trade::IcoImporter::image2D(): BMP size" << Debug::packed << size << "doesn't match" << Debug::packed << expectedSize << "in the directory entry";
+        return {};
+    }
+
+    const UnsignedInt bitsPerPixel = header.bitsPerPixel;
+    if(bitsPerPixel != 1 && bitsPerPixel != 4 && bitsPerPixel != 8 && bitsPerPixel != 24 && bitsPerPixel != 32) {
+        Error{} << "Trade::IcoImporter::image2D(): unsupported BMP bit depth" << bitsPerPixel;
+        return {};
+    }
+
+    /* Zero color count means the full palette for given bit depth */
+    std::size_t colorCount = 0;
+    if(bitsPerPixel <= 8) {
+        colorCount = header.colorCount ? header.colorCount : 1u << bitsPerPixel;
+        if(colorCount > 1u << bitsPerPixel) {
+            Error{} << "Trade::IcoImporter::image2D(): BMP palette of" << colorCount << "colors too large for a" << bitsPerPixel << Debug::nospace << "-bit image";
+            return {};
+        }
+    }
+
+    /* Both the color and the mask rows are aligned to four bytes. The mask is
+       optional for 32-bit images, as those have the alpha channel already.
+       The header size can be up to 4 GB, so the offsets are calculated in 64
+       bits to not overflow on 32-bit platforms. */
+    const std::size_t colorStride = ((std::size_t(size.x())*bitsPerPixel + 31)/32)*4;
+    const std::size_t maskStride = ((std::size_t(size.x()) + 31)/32)*4;
+    const UnsignedLong paletteOffset = header.headerSize;
+    const UnsignedLong colorOffset = paletteOffset + colorCount*4;
+    const UnsignedLong maskOffset = colorOffset + UnsignedLong(colorStride)*size.y();
+    const UnsignedLong maskEnd = maskOffset + UnsignedLong(maskStride)*size.y();
+    const bool hasMask = data.size() >= maskEnd;
+    if(!hasMask && (bitsPerPixel != 32 || data.size() < maskOffset)) {
+        Error{} << "Trade::IcoImporter::image2D(): BMP data too short, expected at least" << (bitsPerPixel == 32 ? maskOffset : maskEnd) << "bytes but got" << data.size();
+        return {};
+    }
+
+    /* Palette entries are BGRX, indices outside of the palette are black */
+    Color3ub palette[256]{};
+    for(std::size_t i = 0; i != colorCount; ++i) {
+        const char* const entry = data.data() + paletteOffset + i*4;
+        palette[i] = {UnsignedByte(entry[2]), UnsignedByte(entry[1]), UnsignedByte(entry[0])};
+    }
+
+    /* Decode into RGBA8. BMP rows are bottom-up, which matches the Y-up
+       convention, so no flipping is needed. */
+    Containers::Array<char> out{NoInit, std::size_t(size.product())*4};
+    const Containers::ArrayView<Color4ub> pixels = Containers::arrayCast<Color4ub>(out);
+    bool hasAlpha = false;
+    for(std::size_t y = 0; y != std::size_t(size.y()); ++y) {
+        const UnsignedByte* const row = reinterpret_cast<const UnsignedByte*>(data.data() + colorOffset + y*colorStride);
+        Color4ub* const outRow = pixels.data() + y*size.x();
+
+        if(bitsPerPixel == 32) for(std::size_t x = 0; x != std::size_t(size.x()); ++x) {
+            outRow[x] = {row[x*4 + 2], row[x*4 + 1], row[x*4 + 0], row[x*4 + 3]};
+            hasAlpha = hasAlpha || row[x*4 + 3];
+        } else if(bitsPerPixel == 24) for(std::size_t x = 0; x != std::size_t(size.x()); ++x) {
+            outRow[x] = {row[x*3 + 2], row[x*3 + 1], row[x*3 + 0], 0xff};
+        } else for(std::size_t x = 0; x != std::size_t(size.x()); ++x) {
+            /* Most significant bits are the leftmost pixel */
+            const std::size_t bit = x*bitsPerPixel;
+            const UnsignedInt index = (row[bit/8] >> (8 - bitsPerPixel - bit%8)) & ((1u << bitsPerPixel) - 1);
+            outRow[x] = {palette[index], 0xff};
+        }
+    }
+
+    /* Apply the AND mask, where a set bit means a transparent pixel. For
+       32-bit images it's used only if the alpha channel is all zeros, which
+       is the case for icons made for systems that didn't support alpha. */
+    if(hasMask && !hasAlpha) for(std::size_t y = 0; y != std::size_t(size.y()); ++y) {
+        const UnsignedByte* const row = reinterpret_cast<const UnsignedByte*>(data.data() + maskOffset + y*maskStride);
+        Color4ub* const outRow = pixels.data() + y*size.x();
+        for(std::size_t x = 0; x != std::size_t(size.x()); ++x)
+            outRow[x].a() = (row[x/8] >> (7 - x%8)) & 1 ? 0x00 : 0xff;
+    } else if(!hasAlpha) for(Color4ub& pixel: pixels)
+        pixel.a() = 0xff;
+
+    /* Always four-byte aligned rows, so no need to adjust pixel storage */
+    return ImageData2D{PixelFormat::RGBA8Unorm, size, Utility::move(out)};
+}
+
+}
+
+Containers::Optional<ImageData2D> IcoImporter::doImage2D(UnsignedInt, UnsignedInt level) {
+    const Containers::ArrayView<const char> data = _state->levels[level].data;
+
+    /* Anything that isn't a PNG is a BMP, decode it directly */
+    if(data.size() < sizeof(PngHeader) || std::memcmp(data.data(), PngHeader, sizeof(PngHeader)) != 0)
+        return decodeBmp(data, _state->levels[level].size);
+
+    /* Delegate PNG importing. The importer instance is reused for all
+       levels. */
     if(!_state->pngImporter && !(_state->pngImporter = manager()->loadAndInstantiate("PngImporter"))) {
         Error{} << "Trade::IcoImporter::image2D(): PngImporter is not available";
         return Containers::NullOpt;
     }
 
-    /* Note: this is uncovered by the tests because neither StbImageImporter
-       nor PngImporter / DevIlImageImporter do any checks apart that could be
-       triggered here. In the best case openData() checks PNG header, but that
-       we do above already, so it can't be hit again here. */
-    if(!_state->pngImporter->openData(_state->levels[level]))
-        return Containers::NullOpt;
+    /* The data are owned by us for as long as the nested importer exists, so
+       open them as memory to avoid a copy, and only if a different level was
+       opened previously.
+
+       Note: the failure is uncovered by the tests because neither
+       StbImageImporter nor PngImporter / DevIlImageImporter do any checks
+       apart that could be triggered here. In the best case openData() checks
+       PNG header, but that we do above already, so it can't be hit again
+       here. */
+    if(_state->pngImporterLevel != level) {
+        _state->pngImporterLevel = ~UnsignedInt{};
+        if(!_state->pngImporter->openMemory(data))
+            return Containers::NullOpt;
+        _state->pngImporterLevel = level;
+    }
 
     return _state->pngImporter->image2D(0);
 }
@@ -58,7 +58,8 @@ namespace Magnum { namespace Trade {
 @brief ICO importer plugin
 @m_since_{plugins,2020,06}
 
-Loads Windows icon/cursor (`*.ico` / `*.cur`) files with embedded PNGs.
+Loads Windows icon/cursor (`*.ico` / `*.cur`) files with embedded PNGs and
+BMPs.
 
 @section Trade-IcoImporter-usage Usage
 
@@ -105,10 +106,39 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 
 The importer will report count of all icon sizes in @ref image2DLevelCount()
 and you can then import each using the second parameter of @ref image2D().
-Currently, only embedded PNGs are supported --- for them it will delegate
-loading to any plugin that provides `PngImporter`; for images that are BMPs,
-@ref image2D() will fail. You can use @ref DevIlImageImporter in that case
-instead, but please @ref Trade-DevIlImageImporter-behavior-ico "be aware of its limitations".
+Alternatively, the @cb{.ini} closestSize @ce
+@ref Trade-IcoImporter-configuration "configuration option" makes the importer
+expose only the level closest to given size, which is useful when just a single
+size is needed out of many --- the other levels are then not decoded at all.
+
+@subsection Trade-IcoImporter-behavior-png Embedded PNGs
+
+Loading of embedded PNGs is delegated to any plugin that provides
+`PngImporter`. A single instance of it is reused for all levels and the data
+are passed to it without a copy.
+
+@subsection Trade-IcoImporter-behavior-bmp Embedded BMPs
+
+Embedded BMPs are decoded directly by the plugin, always to
+@ref PixelFormat::RGBA8Unorm. Uncompressed 1-, 4- and 8-bit palettized images
+as well as 24- and 32-bit images are supported, with the AND mask used to
+produce the alpha channel. For 32-bit images the alpha channel is used
+instead, unless it's all zeros, in which case the mask is applied as well.
+Compressed and 16-bit BMPs are not supported. The BMP size is expected to
+match the size in the ICO directory entry, an import fails otherwise.
+
+The image is imported with default @ref PixelStorage parameters, as the
+row size is always aligned to four bytes.
+
+@section Trade-IcoImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration().
+See below for all options and their default values:
+
+@snippet MagnumPlugins/IcoImporter/IcoImporter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_ICOIMPORTER_EXPORT IcoImporter: public AbstractImporter {
     public:
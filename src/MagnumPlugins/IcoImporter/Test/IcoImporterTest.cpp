@@ -24,6 +24,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
@@ -32,11 +33,14 @@
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Endianness.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/ConfigurationValue.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
@@ -52,8 +56,13 @@ struct IcoImporterTest: TestSuite::Tester {
     void pngLoadFailed();
 
     void bmp();
+    void bmpBitDepth();
+    void bmp32NoMask();
+    void bmpInvalid();
     void png();
 
+    void closestSize();
+
     void openMemory();
     void openTwice();
     void importTwice();
@@ -75,6 +84,96 @@ const struct {
         "image too short, expected at least 974 bytes but got 973"}
 };
 
+using namespace Math::Literals;
+
+const struct {
+    const char* name;
+    UnsignedInt level;
+    Color4ub expected[6];
+} BmpBitDepthData[]{
+    /* See bmps2ico.py for how the file is generated. Bottom row first, the
+       last pixel is transparent in all cases. */
+    {"1-bit", 0, {
+        0xff0000ff_rgba, 0xffffffff_rgba, 0xff0000ff_rgba,
+        0xffffffff_rgba, 0xff0000ff_rgba, 0xffffff00_rgba}},
+    {"4-bit", 1, {
+        0xff0000ff_rgba, 0x00ff00ff_rgba, 0x0000ffff_rgba,
+        0xffffffff_rgba, 0xff0000ff_rgba, 0xffffff00_rgba}},
+    {"8-bit", 2, {
+        0xff0000ff_rgba, 0x00ff00ff_rgba, 0x0000ffff_rgba,
+        0xffffffff_rgba, 0xff0000ff_rgba, 0xffffff00_rgba}},
+    {"24-bit", 3, {
+        0xff0000ff_rgba, 0x00ff00ff_rgba, 0x0000ffff_rgba,
+        0xffffffff_rgba, 0xff0000ff_rgba, 0xffffff00_rgba}},
+    {"32-bit", 4, {
+        0xff0000ff_rgba, 0x00ff00ff_rgba, 0x0000ffff_rgba,
+        0xffffffff_rgba, 0xff000080_rgba, 0xffffff33_rgba}},
+    {"32-bit with zero alpha", 5, {
+        0xff0000ff_rgba, 0x00ff00ff_rgba, 0x0000ffff_rgba,
+        0xffffffff_rgba, 0xff0000ff_rgba, 0xffffff00_rgba}},
+};
+
+const struct {
+    const char* name;
+    std::size_t offset;
+    Int value;
+    const char* message;
+} BmpInvalidData[]{
+    /* Offsets are into bmps.ico, 14 is the data size of the first directory
+       entry, 102 is where the first (1-bit) BMP starts */
+    {"header too short", 14, 39,
+        "BMP header too short, expected at least 40 bytes but got 39"},
+    {"invalid header size", 102, 12,
+        "invalid BMP header size 12"},
+    {"negative height", 102 + 8, -4,
+        "invalid BMP size {3, -4}"},
+    {"odd height", 102 + 8, 3,
+        "invalid BMP size {3, 3}"},
+    {"width not matching the directory", 102 + 4, 4,
+        "BMP size {4, 2} doesn't match {3, 2} in the directory entry"},
+    {"height not matching the directory", 102 + 8, 6,
+        "BMP size {3, 3} doesn't match {3, 2} in the directory entry"},
+    /* Would overflow the output size calculation if not checked */
+    {"width too large", 102 + 4, 0x7fffffff,
+        "BMP size {2147483647, 2} doesn't match {3, 2} in the directory entry"},
+    {"height too large", 102 + 8, 0x7ffffffe,
+        "BMP size {3, 1073741823} doesn't match {3, 2} in the directory entry"},
+    {"16-bit", 102 + 14, 16,
+        "unsupported BMP bit depth 16"},
+    {"compressed", 102 + 16, 1,
+        "unsupported BMP compression 1"},
+    {"palette too large", 102 + 32, 3,
+        "BMP palette of 3 colors too large for a 1-bit image"},
+    {"data too short", 14, 63,
+        "BMP data too short, expected at least 64 bytes but got 63"},
+    /* Would overflow the offset calculation on 32-bit platforms if not done
+       in 64 bits */
+    {"header size too large", 102, Int(0xfffffff0),
+        "BMP data too short, expected at least 4294967304 bytes but got 64"},
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    Vector2i closestSize;
+    Vector2i expectedSize;
+    PixelFormat expectedFormat;
+    const char* message;
+} ClosestSizeData[]{
+    {"exact size", "pngs.ico", {16, 8}, {16, 8}, PixelFormat::RGB8Unorm,
+        "picking a {16, 8} level 0 out of 3"},
+    {"next larger", "pngs.ico", {24, 24}, {32, 64}, PixelFormat::RGB8Unorm,
+        "picking a {32, 64} level 2 out of 3"},
+    {"larger than all", "pngs.ico", {512, 512}, {256, 256}, PixelFormat::RGB8Unorm,
+        "picking a {256, 256} level 1 out of 3"},
+    {"smaller than all", "pngs.ico", {4, 4}, {16, 8}, PixelFormat::RGB8Unorm,
+        "picking a {16, 8} level 0 out of 3"},
+    {"BMP and PNG", "bmp+png.ico", {16, 16}, {256, 256}, PixelFormat::RGB8Unorm,
+        "picking a {256, 256} level 1 out of 2"},
+    {"highest bit depth", "bmps.ico", {3, 2}, {3, 2}, PixelFormat::RGBA8Unorm,
+        "picking a {3, 2} level 4 out of 6"},
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -98,8 +197,20 @@ IcoImporterTest::IcoImporterTest() {
     addTests({&IcoImporterTest::pngImporterNotFound,
               &IcoImporterTest::pngLoadFailed,
 
-              &IcoImporterTest::bmp,
-              &IcoImporterTest::png});
+              &IcoImporterTest::bmp});
+
+    addInstancedTests({&IcoImporterTest::bmpBitDepth},
+        Containers::arraySize(BmpBitDepthData));
+
+    addTests({&IcoImporterTest::bmp32NoMask});
+
+    addInstancedTests({&IcoImporterTest::bmpInvalid},
+        Containers::arraySize(BmpInvalidData));
+
+    addTests({&IcoImporterTest::png});
+
+    addInstancedTests({&IcoImporterTest::closestSize},
+        Containers::arraySize(ClosestSizeData));
 
     addInstancedTests({&IcoImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
@@ -117,8 +228,6 @@ IcoImporterTest::IcoImporterTest() {
     #endif
 }
 
-using namespace Math::Literals;
-
 void IcoImporterTest::tooShort() {
     auto&& data = TooShortData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -180,17 +289,16 @@ void IcoImporterTest::bmp() {
     CORRADE_COMPARE(importer->image2DCount(), 1);
     CORRADE_COMPARE(importer->image2DLevelCount(0), 2);
 
-    /* First is a BMP, should fail */
+    /* First is a BMP, decoded directly */
     {
-        std::ostringstream out;
-        {
-            Error redirectError{&out};
-            CORRADE_EXPECT_FAIL("IcoImporter does not support BMPs yet.");
-            CORRADE_VERIFY(importer->image2D(0, 0));
-        }
-        CORRADE_COMPARE(out.str(), "Trade::IcoImporter::image2D(): only files with embedded PNGs are supported\n");
-
-    /* Second is a PNG, should succeed */
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 0);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->flags(), ImageFlags2D{});
+        CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+        CORRADE_COMPARE(image->size(), (Vector2i{16, 8}));
+        CORRADE_COMPARE(image->pixels<Color4ub>()[0][0], 0x00ff00ff_rgba);
+
+    /* Second is a PNG, delegated to PngImporter */
     } {
         Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 1);
         CORRADE_VERIFY(image);
@@ -201,6 +309,66 @@ void IcoImporterTest::bmp() {
     }
 }
 
+void IcoImporterTest::bmpBitDepth() {
+    auto&& data = BmpBitDepthData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(ICOIMPORTER_TEST_DIR, "bmps.ico")));
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 6);
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, data.level);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->flags(), ImageFlags2D{});
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(image->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE_AS(Containers::arrayCast<const Color4ub>(image->data()),
+        Containers::arrayView(data.expected),
+        TestSuite::Compare::Container);
+}
+
+void IcoImporterTest::bmp32NoMask() {
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(ICOIMPORTER_TEST_DIR, "bmps.ico"));
+    CORRADE_VERIFY(file);
+
+    /* Cut the AND mask away from the last image, which has the alpha channel
+       all zeros. As there's no mask to use instead, it should be opaque. */
+    CORRADE_COMPARE(file->size(), 454 + 72);
+    const UnsignedInt size = Utility::Endianness::littleEndian(72u - 8u);
+    std::memcpy(file->data() + 6 + 5*16 + 8, &size, 4);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
+    CORRADE_VERIFY(importer->openData(*file));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 5);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(image->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE_AS(Containers::arrayCast<const Color4ub>(image->data()), Containers::arrayView<Color4ub>({
+        0xff0000ff_rgba, 0x00ff00ff_rgba, 0x0000ffff_rgba,
+        0xffffffff_rgba, 0xff0000ff_rgba, 0xffffffff_rgba
+    }), TestSuite::Compare::Container);
+}
+
+void IcoImporterTest::bmpInvalid() {
+    auto&& data = BmpInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(ICOIMPORTER_TEST_DIR, "bmps.ico"));
+    CORRADE_VERIFY(file);
+    CORRADE_COMPARE_AS(file->size(), data.offset + 4, TestSuite::Compare::Greater);
+    const Int value = Utility::Endianness::littleEndian(data.value);
+    std::memcpy(file->data() + data.offset, &value, 4);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
+    CORRADE_VERIFY(importer->openData(*file));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0, 0));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::IcoImporter::image2D(): {}\n", data.message));
+}
+
 void IcoImporterTest::png() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(ICOIMPORTER_TEST_DIR, "pngs.ico")));
@@ -232,6 +400,30 @@ void IcoImporterTest::png() {
     }
 }
 
+void IcoImporterTest::closestSize() {
+    auto&& data = ClosestSizeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
+    importer->setFlags(ImporterFlag::Verbose);
+    importer->configuration().setValue("closestSize", data.closestSize);
+
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(ICOIMPORTER_TEST_DIR, data.filename)));
+    }
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::IcoImporter::openData(): {}\n", data.message));
+
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 1);
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->format(), data.expectedFormat);
+    CORRADE_COMPARE(image->size(), data.expectedSize);
+}
+
 void IcoImporterTest::openMemory() {
     /* same as (a subset of) png() except that it uses openData() &
        openMemory() instead of openFile() to test data copying on import */
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# Generates an ICO with tiny 3x2 BMP images in all bit depths supported by
+# IcoImporter, each with an AND mask making the top right pixel transparent.
+# Rows are stored bottom-up, i.e. the first row is the bottom one. Usage:
+#
+#   ./bmps2ico.py bmps.ico
+
+import struct
+import sys
+
+RED = (0xff, 0x00, 0x00)
+GREEN = (0x00, 0xff, 0x00)
+BLUE = (0x00, 0x00, 0xff)
+WHITE = (0xff, 0xff, 0xff)
+
+WIDTH = 3
+HEIGHT = 2
+
+# Bottom row first. The last pixel of the second row is masked out.
+MASK = [[0, 0, 0], [0, 0, 1]]
+
+def pad(row: bytes) -> bytes:
+    return row + b'\x00'*((4 - len(row) % 4) % 4)
+
+def pack_bits(values, bits) -> bytes:
+    out = bytearray()
+    current = 0
+    used = 0
+    for value in values:
+        current = (current << bits) | value
+        used += bits
+        if used == 8:
+            out.append(current)
+            current = 0
+            used = 0
+    if used:
+        out.append(current << (8 - used))
+    return bytes(out)
+
+def bitmap(bits, palette, colors, alphas=None):
+    colors_used = len(palette) if palette and len(palette) != 1 << bits else 0
+    data = bytearray(struct.pack('<IiiHHIIiiII',
+        40, WIDTH, HEIGHT*2, 1, bits, 0, 0, 0, 0, colors_used, 0))
+    for color in palette:
+        data += bytes([color[2], color[1], color[0], 0])
+    for y, row in enumerate(colors):
+        if bits <= 8:
+            data += pad(pack_bits(row, bits))
+        else:
+            line = bytearray()
+            for x, color in enumerate(row):
+                line += bytes([color[2], color[1], color[0]])
+                if bits == 32:
+                    line.append(alphas[y][x])
+            data += pad(bytes(line))
+    for row in MASK:
+        data += pad(pack_bits(row, 1))
+    return bits, len(palette) if len(palette) < 256 else 0, bytes(data)
+
+images = [
+    bitmap(1, [RED, WHITE], [[0, 1, 0], [1, 0, 1]]),
+    bitmap(4, [RED, GREEN, BLUE, WHITE], [[0, 1, 2], [3, 0, 3]]),
+    bitmap(8, [RED, GREEN, BLUE, WHITE], [[0, 1, 2], [3, 0, 3]]),
+    bitmap(24, [], [[RED, GREEN, BLUE], [WHITE, RED, WHITE]]),
+    # Alpha channel is used, the mask is ignored
+    bitmap(32, [], [[RED, GREEN, BLUE], [WHITE, RED, WHITE]],
+        [[0xff, 0xff, 0xff], [0xff, 0x80, 0x33]]),
+    # Alpha channel is all zeros, the mask is used instead
+    bitmap(32, [], [[RED, GREEN, BLUE], [WHITE, RED, WHITE]],
+        [[0x00, 0x00, 0x00], [0x00, 0x00, 0x00]]),
+]
+
+with open(sys.argv[1], 'wb') as output:
+    output.write(struct.pack('<HHH', 0, 1, len(images)))
+    offset = 6 + 16*len(images)
+    for bits, color_count, data in images:
+        output.write(struct.pack('<BBBB HH II',
+            WIDTH, HEIGHT, color_count, 0, 1, bits, len(data), offset))
+        offset += len(data)
+    for _, _, data in images:
+        output.write(data)
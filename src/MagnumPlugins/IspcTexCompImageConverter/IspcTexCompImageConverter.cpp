@@ -0,0 +1,272 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "IspcTexCompImageConverter.h"
+
+#include <atomic>
+#include <thread>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Half.h>
+#include <Magnum/Math/Vector4.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include <ispc_texcomp.h>
+
+namespace Magnum { namespace Trade {
+
+using namespace Containers::Literals;
+
+IspcTexCompImageConverter::IspcTexCompImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter{manager, plugin} {}
+
+ImageConverterFeatures IspcTexCompImageConverter::doFeatures() const {
+    return ImageConverterFeature::Convert2D|ImageConverterFeature::Convert3D;
+}
+
+namespace {
+
+bool bc7Settings(const Containers::StringView quality, const bool alpha, bc7_enc_settings& settings) {
+    if(quality == "ultrafast"_s)
+        alpha ? GetProfile_alpha_ultrafast(&settings) : GetProfile_ultrafast(&settings);
+    else if(quality == "veryfast"_s)
+        alpha ? GetProfile_alpha_veryfast(&settings) : GetProfile_veryfast(&settings);
+    else if(quality == "fast"_s)
+        alpha ? GetProfile_alpha_fast(&settings) : GetProfile_fast(&settings);
+    else if(quality == "basic"_s)
+        alpha ? GetProfile_alpha_basic(&settings) : GetProfile_basic(&settings);
+    else if(quality == "slow"_s)
+        alpha ? GetProfile_alpha_slow(&settings) : GetProfile_slow(&settings);
+    else return false;
+    return true;
+}
+
+bool bc6hSettings(const Containers::StringView quality, bc6h_enc_settings& settings) {
+    if(quality == "veryfast"_s)
+        GetProfile_bc6h_veryfast(&settings);
+    else if(quality == "fast"_s)
+        GetProfile_bc6h_fast(&settings);
+    else if(quality == "basic"_s)
+        GetProfile_bc6h_basic(&settings);
+    else if(quality == "slow"_s)
+        GetProfile_bc6h_slow(&settings);
+    else if(quality == "veryslow"_s)
+        GetProfile_bc6h_veryslow(&settings);
+    else return false;
+    return true;
+}
+
+void compressBlocks(const rgba_surface& surface, UnsignedByte* const out, bc7_enc_settings& settings) {
+    CompressBlocksBC7(&surface, out, &settings);
+}
+
+void compressBlocks(const rgba_surface& surface, UnsignedByte* const out, bc6h_enc_settings& settings) {
+    CompressBlocksBC6H(&surface, out, &settings);
+}
+
+/* The encoders take RGBA8 for BC7 and RGBA16F for BC6H. BC6H is unsigned so
+   negative values are clamped to zero, alpha is ignored by it. */
+Half positive(const Half value) {
+    return value.data() & 0x8000 ? Half{UnsignedShort(0)} : value;
+}
+Vector4ub stagePixel(const Vector3ub& in) {
+    return {in, 255};
+}
+Vector4ub stagePixel(const Vector4ub& in) {
+    return in;
+}
+Vector4h stagePixel(const Vector3h& in) {
+    return {positive(in.x()), positive(in.y()), positive(in.z()), Half{1.0f}};
+}
+Vector4h stagePixel(const Vector4h& in) {
+    return stagePixel(in.xyz());
+}
+Vector4h stagePixel(const Vector3& in) {
+    return Vector4h{Vector4{Math::max(in, 0.0f), 1.0f}};
+}
+Vector4h stagePixel(const Vector4& in) {
+    return stagePixel(in.xyz());
+}
+
+template<class In, class Out, class Settings> void compress(const Containers::StridedArrayView4D<const char>& pixels, const Settings& settings, UnsignedInt threadCount, Containers::ArrayView<char> out) {
+    const Containers::StridedArrayView3D<const In> input = Containers::arrayCast<3, const In>(pixels);
+    const std::size_t height = input.size()[1];
+    const std::size_t width = input.size()[2];
+    const std::size_t blockCountX = (width + 3)/4;
+    const std::size_t blockCountY = (height + 3)/4;
+
+    /* Each row of blocks in each slice is a separate job. As the encoders
+       need whole blocks, each job first copies the four pixel rows to a
+       staging buffer in the format the encoder wants, repeating the edge
+       pixels to fill incomplete blocks. The calling thread is one of the
+       workers, so spawn one thread less. */
+    const std::size_t jobCount = input.size()[0]*blockCountY;
+    threadCount = Math::max(Math::min(threadCount, UnsignedInt(jobCount)), 1u);
+    std::atomic<std::size_t> nextJob{0};
+    const auto worker = [&]() {
+        /* The settings are taken through a mutable pointer, so give each
+           thread its own copy to be sure */
+        Settings threadSettings = settings;
+        Containers::Array<Out> staging{NoInit, blockCountX*4*4};
+        rgba_surface surface;
+        surface.ptr = reinterpret_cast<uint8_t*>(staging.data());
+        surface.width = blockCountX*4;
+        surface.height = 4;
+        surface.stride = blockCountX*4*sizeof(Out);
+
+        for(std::size_t i; (i = nextJob++) < jobCount; ) {
+            const Containers::StridedArrayView2D<const In> slice = input[i/blockCountY];
+            const std::size_t blockY = i%blockCountY;
+            for(std::size_t y = 0; y != 4; ++y) {
+                const Containers::StridedArrayView1D<const In> row = slice[Math::min(blockY*4 + y, height - 1)];
+                Out* const stagingRow = staging.data() + y*blockCountX*4;
+                for(std::size_t x = 0; x != blockCountX*4; ++x)
+                    stagingRow[x] = stagePixel(row[Math::min(x, width - 1)]);
+            }
+
+            /* Both BC7 and BC6H blocks are 16 bytes */
+            compressBlocks(surface, reinterpret_cast<UnsignedByte*>(out.data()) + i*blockCountX*16, threadSettings);
+        }
+    };
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{worker};
+    worker();
+    for(std::thread& thread: threads)
+        thread.join();
+}
+
+Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Utility::ConfigurationGroup& configuration) {
+    /* Decide on the output format and the compressor settings */
+    CompressedPixelFormat outputFormat;
+    bool bc6h;
+    switch(image.format()) {
+        case PixelFormat::RGB8Unorm:
+        case PixelFormat::RGBA8Unorm:
+            outputFormat = CompressedPixelFormat::Bc7RGBAUnorm;
+            bc6h = false;
+            break;
+        case PixelFormat::RGB8Srgb:
+        case PixelFormat::RGBA8Srgb:
+            outputFormat = CompressedPixelFormat::Bc7RGBASrgb;
+            bc6h = false;
+            break;
+        case PixelFormat::RGB16F:
+        case PixelFormat::RGBA16F:
+        case PixelFormat::RGB32F:
+        case PixelFormat::RGBA32F:
+            outputFormat = CompressedPixelFormat::Bc6hRGBUfloat;
+            bc6h = true;
+            break;
+        default:
+            Error{} << "Trade::IspcTexCompImageConverter::convert(): unsupported format" << image.format();
+            return {};
+    }
+
+    bc7_enc_settings bc7;
+    bc6h_enc_settings bc6;
+    if(!bc6h) {
+        const Containers::StringView quality = configuration.value<Containers::StringView>("bc7Quality");
+        if(!bc7Settings(quality, pixelFormatChannelCount(image.format()) == 4, bc7)) {
+            Error{} << "Trade::IspcTexCompImageConverter::convert(): expected bc7Quality to be one of ultrafast, veryfast, fast, basic or slow but got" << quality;
+            return {};
+        }
+    } else {
+        const Containers::StringView quality = configuration.value<Containers::StringView>("bc6hQuality");
+        if(!bc6hSettings(quality, bc6)) {
+            Error{} << "Trade::IspcTexCompImageConverter::convert(): expected bc6hQuality to be one of veryfast, fast, basic, slow or veryslow but got" << quality;
+            return {};
+        }
+    }
+
+    UnsignedInt threadCount = configuration.value<UnsignedInt>("threads");
+    if(!threadCount)
+        threadCount = std::thread::hardware_concurrency();
+
+    /** @todo use blocks() once the compressed image APIs are done */
+    const Vector2i blockCount = (image.size().xy() + Vector2i{3})/4;
+    Containers::Array<char> outputData{NoInit, std::size_t(blockCount.product()*image.size().z()*16)};
+
+    /* Nothing to do for an empty image, and the code below would underflow
+       when clamping to the last row or column */
+    if(outputData.isEmpty())
+        return ImageData3D{outputFormat, image.size(), Utility::move(outputData), image.flags()};
+
+    const Containers::StridedArrayView4D<const char> pixels = image.pixels();
+    switch(image.format()) {
+        case PixelFormat::RGB8Unorm:
+        case PixelFormat::RGB8Srgb:
+            compress<Vector3ub, Vector4ub>(pixels, bc7, threadCount, outputData);
+            break;
+        case PixelFormat::RGBA8Unorm:
+        case PixelFormat::RGBA8Srgb:
+            compress<Vector4ub, Vector4ub>(pixels, bc7, threadCount, outputData);
+            break;
+        case PixelFormat::RGB16F:
+            compress<Vector3h, Vector4h>(pixels, bc6, threadCount, outputData);
+            break;
+        case PixelFormat::RGBA16F:
+            compress<Vector4h, Vector4h>(pixels, bc6, threadCount, outputData);
+            break;
+        case PixelFormat::RGB32F:
+            compress<Vector3, Vector4h>(pixels, bc6, threadCount, outputData);
+            break;
+        case PixelFormat::RGBA32F:
+            compress<Vector4, Vector4h>(pixels, bc6, threadCount, outputData);
+            break;
+        default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    return ImageData3D{outputFormat, image.size(), Utility::move(outputData), image.flags()};
+}
+
+}
+
+Containers::Optional<ImageData2D> IspcTexCompImageConverter::doConvert(const ImageView2D& image) {
+    if(image.flags() & ImageFlag2D::Array) {
+        Error{} << "Trade::IspcTexCompImageConverter::convert(): 1D array images are not supported";
+        return {};
+    }
+
+    Containers::Optional<ImageData3D> out = convertInternal(image, configuration());
+    if(!out) return {};
+
+    CORRADE_INTERNAL_ASSERT(out->size().z() == 1);
+    const Vector2i size = out->size().xy();
+    return ImageData2D{out->compressedFormat(), size, out->release(), image.flags()};
+}
+
+Containers::Optional<ImageData3D> IspcTexCompImageConverter::doConvert(const ImageView3D& image) {
+    return convertInternal(image, configuration());
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(IspcTexCompImageConverter, Magnum::Trade::IspcTexCompImageConverter,
+    MAGNUM_TRADE_ABSTRACTIMAGECONVERTER_PLUGIN_INTERFACE)
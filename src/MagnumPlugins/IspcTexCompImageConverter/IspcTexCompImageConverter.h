@@ -0,0 +1,200 @@
+#ifndef Magnum_Trade_IspcTexCompImageConverter_h
+#define Magnum_Trade_IspcTexCompImageConverter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Trade::IspcTexCompImageConverter
+ * @m_since_latest_{plugins}
+ */
+
+#include <Magnum/Trade/AbstractImageConverter.h>
+
+#include "MagnumPlugins/IspcTexCompImageConverter/configure.h"
+
+#ifndef DOXYGEN_GENERATING_OUTPUT
+#ifndef MAGNUM_ISPCTEXCOMPIMAGECONVERTER_BUILD_STATIC
+    #ifdef IspcTexCompImageConverter_EXPORTS
+        #define MAGNUM_ISPCTEXCOMPIMAGECONVERTER_EXPORT CORRADE_VISIBILITY_EXPORT
+    #else
+        #define MAGNUM_ISPCTEXCOMPIMAGECONVERTER_EXPORT CORRADE_VISIBILITY_IMPORT
+    #endif
+#else
+    #define MAGNUM_ISPCTEXCOMPIMAGECONVERTER_EXPORT CORRADE_VISIBILITY_STATIC
+#endif
+#define MAGNUM_ISPCTEXCOMPIMAGECONVERTER_LOCAL CORRADE_VISIBILITY_LOCAL
+#else
+#define MAGNUM_ISPCTEXCOMPIMAGECONVERTER_EXPORT
+#define MAGNUM_ISPCTEXCOMPIMAGECONVERTER_LOCAL
+#endif
+
+namespace Magnum { namespace Trade {
+
+/**
+@brief BC7 and BC6H image compression using the ISPC Texture Compressor
+@m_since_latest_{plugins}
+
+Compresses 8-bit RGB and RGBA images to BC7 and half-float and float RGB and
+RGBA images to BC6H using the [Intel ISPC Texture Compressor](https://github.com/GameTechDev/ISPCTextureCompressor)
+library. Compared to the @ref StbDxtImageConverter, which produces BC1 and BC3
+output, the resulting images have considerably better quality at the same
+memory cost as BC3, at the expense of longer encoding times. See the
+@ref BcDecImageConverter for decoding the output back.
+
+@m_class{m-block m-success}
+
+@thirdparty This plugin makes use of the
+    [Intel ISPC Texture Compressor](https://github.com/GameTechDev/ISPCTextureCompressor)
+    library, licensed under @m_class{m-label m-success} **MIT**
+    ([license text](https://github.com/GameTechDev/ISPCTextureCompressor/blob/master/license.txt),
+    [choosealicense.com](https://choosealicense.com/licenses/mit/)).
+    It requires attribution for public use.
+
+@section Trade-IspcTexCompImageConverter-usage Usage
+
+@m_class{m-note m-success}
+
+@par
+    This class is a plugin that's meant to be dynamically loaded and used
+    via the base @ref AbstractImageConverter interface. See its documentation
+    for introduction and usage examples.
+
+This plugin depends on the @ref Trade library and the ISPC Texture Compressor
+library and is built if `MAGNUM_WITH_ISPCTEXCOMPIMAGECONVERTER` is enabled
+when building Magnum Plugins. To use as a dynamic plugin, load
+@cpp "IspcTexCompImageConverter" @ce via @ref Corrade::PluginManager::Manager.
+
+Additionally, if you're using Magnum as a CMake subproject, bundle the
+[magnum-plugins repository](https://github.com/mosra/magnum-plugins) and do the
+following. The ISPC Texture Compressor doesn't provide a CMake build, so you
+need to provide it as a system dependency and point `CMAKE_PREFIX_PATH` to its
+installation dir if necessary.
+
+@code{.cmake}
+set(MAGNUM_WITH_ISPCTEXCOMPIMAGECONVERTER ON CACHE BOOL "" FORCE)
+add_subdirectory(magnum-plugins EXCLUDE_FROM_ALL)
+
+# So the dynamically loaded plugin gets built implicitly
+add_dependencies(your-app MagnumPlugins::IspcTexCompImageConverter)
+@endcode
+
+To use as a static plugin or as a dependency of another plugin with CMake, put
+[FindMagnumPlugins.cmake](https://github.com/mosra/magnum-plugins/blob/master/modules/FindMagnumPlugins.cmake)
+and [FindIspcTexComp.cmake](https://github.com/mosra/magnum-plugins/blob/master/modules/FindIspcTexComp.cmake)
+into your `modules/` directory, request the `IspcTexCompImageConverter`
+component of the `MagnumPlugins` package and link to the
+`MagnumPlugins::IspcTexCompImageConverter` target:
+
+@code{.cmake}
+find_package(MagnumPlugins REQUIRED IspcTexCompImageConverter)
+
+# ...
+target_link_libraries(your-app PRIVATE MagnumPlugins::IspcTexCompImageConverter)
+@endcode
+
+See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
+information.
+
+@section Trade-IspcTexCompImageConverter-behavior Behavior and limitations
+
+The output format is picked based on the input as follows:
+
+-   @ref PixelFormat::RGB8Unorm / @relativeref{PixelFormat,RGBA8Unorm} is
+    compressed to @ref CompressedPixelFormat::Bc7RGBAUnorm
+-   @ref PixelFormat::RGB8Srgb / @relativeref{PixelFormat,RGBA8Srgb} is
+    compressed to @ref CompressedPixelFormat::Bc7RGBASrgb
+-   @ref PixelFormat::RGB16F / @relativeref{PixelFormat,RGBA16F} and
+    @ref PixelFormat::RGB32F / @relativeref{PixelFormat,RGBA32F} is
+    compressed to @ref CompressedPixelFormat::Bc6hRGBUfloat. The alpha
+    channel, if present, is ignored, as BC6H has no way to represent it.
+    Negative values are clamped to zero, 32-bit floats are converted to
+    half-floats first.
+
+RGB input is compressed with the opaque BC7 profiles, which leave the alpha
+fully opaque, RGBA input with the alpha-aware profiles. The speed and quality
+tradeoff can be chosen with the @cb{.ini} bc7Quality @ce and
+@cb{.ini} bc6hQuality @ce @ref Trade-IspcTexCompImageConverter-configuration "configuration options".
+
+Unlike with the @ref StbDxtImageConverter, the image size doesn't need to be
+divisible by four. Incomplete blocks at the right and bottom edge are padded
+by repeating the edge pixels, which minimizes the error introduced into the
+pixels that are actually used.
+
+Image flags are passed through unchanged. 3D images are compressed
+slice-by-slice, independently of whether @ref ImageFlag3D::Array and/or
+@ref ImageFlag3D::CubeMap or neither is set. On the other hand, if a 2D image
+with @ref ImageFlag2D::Array is passed, the conversion will fail as it's not
+possible to represent 1D array images without a significant loss in quality
+and layer cross-talk.
+
+Unlike image converters dealing with uncompressed pixel formats, the image
+* *isn't* Y-flipped on export due to the nontrivial amount of work involved
+with Y-flipping block-compressed data. This is in line with importers of
+compressed pixel formats such as @ref AstcImporter, @ref DdsImporter or
+@ref KtxImporter, which don't Y-flip compressed formats on import either.
+
+The encoding can be spread across multiple threads using the
+@cb{.ini} threads @ce @ref Trade-IspcTexCompImageConverter-configuration "configuration option".
+Threads are spawned for the duration of the conversion, each row of blocks in
+each slice is a separate work item and the threads pick them up until all are
+encoded. The output is the same regardless of the thread count.
+
+@subsection Trade-IspcTexCompImageConverter-behavior-loading Loading the plugin fails with undefined symbol: pthread_create
+
+On Linux it may happen that loading the plugin will fail with
+`undefined symbol: pthread_create`. Same as with
+@ref Trade-BasisImageConverter-behavior-loading "BasisImageConverter", the
+plugin isn't linked to `pthread` and requires *the application* to link to it
+instead. With CMake it can be done like this:
+
+@code{.cmake}
+find_package(Threads REQUIRED)
+target_link_libraries(your-application PRIVATE Threads::Threads)
+@endcode
+
+@section Trade-IspcTexCompImageConverter-configuration Plugin-specific configuration
+
+Various compressor options can be set through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/IspcTexCompImageConverter/IspcTexCompImageConverter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
+*/
+class MAGNUM_ISPCTEXCOMPIMAGECONVERTER_EXPORT IspcTexCompImageConverter: public AbstractImageConverter {
+    public:
+        /** @brief Plugin manager constructor */
+        explicit IspcTexCompImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
+
+    private:
+        MAGNUM_ISPCTEXCOMPIMAGECONVERTER_LOCAL ImageConverterFeatures doFeatures() const override;
+        MAGNUM_ISPCTEXCOMPIMAGECONVERTER_LOCAL Containers::Optional<ImageData2D> doConvert(const ImageView2D& image) override;
+        MAGNUM_ISPCTEXCOMPIMAGECONVERTER_LOCAL Containers::Optional<ImageData3D> doConvert(const ImageView3D& image) override;
+};
+
+}}
+
+#endif
@@ -0,0 +1,387 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Path.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/DebugTools/CompareImage.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Half.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct IspcTexCompImageConverterTest: TestSuite::Tester {
+    explicit IspcTexCompImageConverterTest();
+
+    void unsupportedFormat();
+    void invalidBc7Quality();
+    void invalidBc6hQuality();
+    void emptyImage();
+    void array1D();
+
+    void bc7();
+    void bc6h();
+    void threeDimensions();
+    void threads();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
+    PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
+};
+
+const struct {
+    const char* name;
+    const char* file;
+    Int channelCount;
+    Containers::Optional<PixelFormat> overrideInputFormat;
+    const char* quality;
+    CompressedPixelFormat expectedFormat;
+    Float maxThreshold, meanThreshold;
+} Bc7Data[] {
+    /* The thresholds are rather large for the JPEG as it has a lot of
+       high-frequency noise that doesn't compress well */
+    {"RGB", STBDXTIMAGECONVERTER_TEST_DIR "/ship.jpg", 3, {}, nullptr,
+        CompressedPixelFormat::Bc7RGBAUnorm, 34.0f, 1.5f},
+    {"RGB, sRGB", STBDXTIMAGECONVERTER_TEST_DIR "/ship.jpg", 3, PixelFormat::RGB8Srgb, nullptr,
+        CompressedPixelFormat::Bc7RGBASrgb, 34.0f, 1.5f},
+    {"RGB, ultrafast", STBDXTIMAGECONVERTER_TEST_DIR "/ship.jpg", 3, {}, "ultrafast",
+        CompressedPixelFormat::Bc7RGBAUnorm, 48.0f, 2.5f},
+    {"RGB, slow", STBDXTIMAGECONVERTER_TEST_DIR "/ship.jpg", 3, {}, "slow",
+        CompressedPixelFormat::Bc7RGBAUnorm, 34.0f, 1.5f},
+    {"RGBA", BASISIMPORTER_TEST_DIR "/rgba-64x32.png", 4, {}, nullptr,
+        CompressedPixelFormat::Bc7RGBAUnorm, 12.0f, 0.75f},
+    {"RGBA, sRGB", BASISIMPORTER_TEST_DIR "/rgba-64x32.png", 4, PixelFormat::RGBA8Srgb, nullptr,
+        CompressedPixelFormat::Bc7RGBASrgb, 12.0f, 0.75f},
+    {"RGBA, incomplete blocks", BASISIMPORTER_TEST_DIR "/rgba-63x27.png", 4, {}, nullptr,
+        CompressedPixelFormat::Bc7RGBAUnorm, 12.0f, 0.75f},
+    {"RGBA, veryfast", BASISIMPORTER_TEST_DIR "/rgba-64x32.png", 4, {}, "veryfast",
+        CompressedPixelFormat::Bc7RGBAUnorm, 16.0f, 1.0f},
+};
+
+const struct {
+    const char* name;
+    bool half;
+    bool alpha;
+    const char* quality;
+    Float maxThreshold, meanThreshold;
+} Bc6hData[] {
+    {"RGB32F", false, false, nullptr, 2.5f, 1.1f},
+    {"RGB16F", true, false, nullptr, 2.5f, 1.1f},
+    {"RGBA32F", false, true, nullptr, 2.5f, 1.1f},
+    {"RGB32F, veryfast", false, false, "veryfast", 3.0f, 1.3f},
+    {"RGB32F, veryslow", false, false, "veryslow", 2.5f, 1.1f},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} ThreadsData[] {
+    {"2 threads", 2},
+    /* More than there are block rows */
+    {"32 threads", 32},
+    {"all available threads", 0},
+};
+
+IspcTexCompImageConverterTest::IspcTexCompImageConverterTest() {
+    addTests({&IspcTexCompImageConverterTest::unsupportedFormat,
+              &IspcTexCompImageConverterTest::invalidBc7Quality,
+              &IspcTexCompImageConverterTest::invalidBc6hQuality,
+              &IspcTexCompImageConverterTest::emptyImage,
+              &IspcTexCompImageConverterTest::array1D});
+
+    addInstancedTests({&IspcTexCompImageConverterTest::bc7},
+        Containers::arraySize(Bc7Data));
+
+    addInstancedTests({&IspcTexCompImageConverterTest::bc6h},
+        Containers::arraySize(Bc6hData));
+
+    addTests({&IspcTexCompImageConverterTest::threeDimensions});
+
+    addInstancedTests({&IspcTexCompImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef ISPCTEXCOMPIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(ISPCTEXCOMPIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* The BcDecImageConverter and StbImageImporter are optional */
+    #ifdef BCDECIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(BCDECIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STBIMAGEIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(STBIMAGEIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void IspcTexCompImageConverterTest::unsupportedFormat() {
+    ImageView2D image{PixelFormat::RG8Unorm, {}, nullptr};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!_converterManager.instantiate("IspcTexCompImageConverter")->convert(image));
+    CORRADE_COMPARE(out.str(), "Trade::IspcTexCompImageConverter::convert(): unsupported format PixelFormat::RG8Unorm\n");
+}
+
+void IspcTexCompImageConverterTest::invalidBc7Quality() {
+    ImageView2D image{PixelFormat::RGBA8Unorm, {}, nullptr};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    /* BC6H quality should not be checked for BC7 */
+    converter->configuration().setValue("bc6hQuality", "ultrafast");
+    converter->configuration().setValue("bc7Quality", "veryslow");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(image));
+    CORRADE_COMPARE(out.str(), "Trade::IspcTexCompImageConverter::convert(): expected bc7Quality to be one of ultrafast, veryfast, fast, basic or slow but got veryslow\n");
+}
+
+void IspcTexCompImageConverterTest::invalidBc6hQuality() {
+    ImageView2D image{PixelFormat::RGB16F, {}, nullptr};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    /* BC7 quality should not be checked for BC6H */
+    converter->configuration().setValue("bc7Quality", "veryslow");
+    converter->configuration().setValue("bc6hQuality", "ultrafast");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(image));
+    CORRADE_COMPARE(out.str(), "Trade::IspcTexCompImageConverter::convert(): expected bc6hQuality to be one of veryfast, fast, basic, slow or veryslow but got ultrafast\n");
+}
+
+void IspcTexCompImageConverterTest::emptyImage() {
+    ImageView2D image{PixelFormat::RGBA8Unorm, {}, nullptr};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    Containers::Optional<Trade::ImageData2D> out = converter->convert(image);
+    CORRADE_VERIFY(out);
+    CORRADE_VERIFY(out->isCompressed());
+    CORRADE_COMPARE(out->size(), Vector2i{});
+    CORRADE_COMPARE(out->compressedFormat(), CompressedPixelFormat::Bc7RGBAUnorm);
+    CORRADE_COMPARE(out->data().size(), 0);
+}
+
+void IspcTexCompImageConverterTest::array1D() {
+    ImageView2D image{PixelFormat::RGBA8Unorm, {4, 4}, ImageFlag2D::Array};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!_converterManager.instantiate("IspcTexCompImageConverter")->convert(image));
+    CORRADE_COMPARE(out.str(), "Trade::IspcTexCompImageConverter::convert(): 1D array images are not supported\n");
+}
+
+void IspcTexCompImageConverterTest::bc7() {
+    auto&& data = Bc7Data[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    importer->configuration().setValue("forceChannelCount", data.channelCount);
+    CORRADE_VERIFY(importer->openFile(data.file));
+    Containers::Optional<Trade::ImageData2D> uncompressed = importer->image2D(0);
+    CORRADE_VERIFY(uncompressed);
+    CORRADE_COMPARE(pixelFormatChannelCount(uncompressed->format()), data.channelCount);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    if(data.quality)
+        converter->configuration().setValue("bc7Quality", data.quality);
+
+    Containers::Optional<Trade::ImageData2D> compressed;
+    if(data.overrideInputFormat) {
+        compressed = converter->convert(ImageView2D{uncompressed->storage(), *data.overrideInputFormat, uncompressed->size(), uncompressed->data()});
+    } else compressed = converter->convert(*uncompressed);
+    CORRADE_VERIFY(compressed);
+    CORRADE_VERIFY(compressed->isCompressed());
+    CORRADE_COMPARE(compressed->compressedFormat(), data.expectedFormat);
+    CORRADE_COMPARE(compressed->size(), uncompressed->size());
+    /* The data should be exactly the size of 4x4 128-bit blocks, including
+       incomplete ones */
+    /** @todo drop this and let the ImageData constructor take care of this? */
+    CORRADE_COMPARE(compressed->data().size(),
+        ((uncompressed->size() + Vector2i{3})/4).product()*16);
+
+    if(_converterManager.loadState("BcDecImageConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BcDecImageConverter plugin not found, cannot verify the output");
+
+    Containers::Optional<Trade::ImageData2D> decompressed = _converterManager.instantiate("BcDecImageConverter")->convert(*compressed);
+    CORRADE_VERIFY(decompressed);
+    CORRADE_COMPARE(decompressed->format(), data.expectedFormat == CompressedPixelFormat::Bc7RGBASrgb ? PixelFormat::RGBA8Srgb : PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(decompressed->size(), uncompressed->size());
+
+    /* Import the input again with an alpha channel for comparison, if it
+       doesn't have one already */
+    if(data.channelCount != 4) {
+        importer->configuration().setValue("forceChannelCount", 4);
+        CORRADE_VERIFY(importer->openFile(data.file));
+        uncompressed = importer->image2D(0);
+        CORRADE_VERIFY(uncompressed);
+    }
+    CORRADE_COMPARE_WITH(decompressed->pixels<Color4ub>(),
+        *uncompressed,
+        (DebugTools::CompareImage{data.maxThreshold, data.meanThreshold}));
+}
+
+void IspcTexCompImageConverterTest::bc6h() {
+    auto&& data = Bc6hData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBIMAGEIMPORTER_TEST_DIR, "rgb.hdr")));
+    Containers::Optional<Trade::ImageData2D> uncompressed = importer->image2D(0);
+    CORRADE_VERIFY(uncompressed);
+    CORRADE_COMPARE(uncompressed->format(), PixelFormat::RGB32F);
+    /* The image should have incomplete blocks to test the edge handling */
+    CORRADE_VERIFY(!(uncompressed->size() % 4).isZero());
+
+    /* Make a RGBA or half-float variant of the input if desired. The alpha
+       is ignored by BC6H, so it's set to something that would cause a
+       failure if it wasn't. */
+    Containers::Optional<Trade::ImageData2D> input;
+    if(data.alpha) {
+        input = Trade::ImageData2D{PixelFormat::RGBA32F, uncompressed->size(), Containers::Array<char>{NoInit, std::size_t(uncompressed->size().product()*16)}};
+        const Containers::StridedArrayView2D<const Color3> src = uncompressed->pixels<Color3>();
+        const Containers::StridedArrayView2D<Color4> dst = input->mutablePixels<Color4>();
+        for(std::size_t y = 0; y != src.size()[0]; ++y)
+            for(std::size_t x = 0; x != src.size()[1]; ++x)
+                dst[y][x] = {src[y][x], -1000.0f};
+    } else if(data.half) {
+        input = Trade::ImageData2D{PixelStorage{}.setAlignment(1), PixelFormat::RGB16F, uncompressed->size(), Containers::Array<char>{NoInit, std::size_t(uncompressed->size().product()*6)}};
+        const Containers::StridedArrayView2D<const Vector3> src = uncompressed->pixels<Vector3>();
+        const Containers::StridedArrayView2D<Vector3h> dst = input->mutablePixels<Vector3h>();
+        for(std::size_t y = 0; y != src.size()[0]; ++y)
+            for(std::size_t x = 0; x != src.size()[1]; ++x)
+                dst[y][x] = Vector3h{src[y][x]};
+    }
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    if(data.quality)
+        converter->configuration().setValue("bc6hQuality", data.quality);
+
+    Containers::Optional<Trade::ImageData2D> compressed = converter->convert(input ? *input : *uncompressed);
+    CORRADE_VERIFY(compressed);
+    CORRADE_VERIFY(compressed->isCompressed());
+    CORRADE_COMPARE(compressed->compressedFormat(), CompressedPixelFormat::Bc6hRGBUfloat);
+    CORRADE_COMPARE(compressed->size(), uncompressed->size());
+    CORRADE_COMPARE(compressed->data().size(),
+        ((uncompressed->size() + Vector2i{3})/4).product()*16);
+
+    if(_converterManager.loadState("BcDecImageConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BcDecImageConverter plugin not found, cannot verify the output");
+
+    Containers::Pointer<AbstractImageConverter> decoder = _converterManager.instantiate("BcDecImageConverter");
+    decoder->configuration().setValue("bc6hToFloat", true);
+    Containers::Optional<Trade::ImageData2D> decompressed = decoder->convert(*compressed);
+    CORRADE_VERIFY(decompressed);
+    CORRADE_COMPARE(decompressed->format(), PixelFormat::RGB32F);
+    CORRADE_COMPARE_WITH(*decompressed, *uncompressed,
+        (DebugTools::CompareImage{data.maxThreshold, data.meanThreshold}));
+}
+
+void IspcTexCompImageConverterTest::threeDimensions() {
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBDXTIMAGECONVERTER_TEST_DIR, "ship.jpg")));
+    Containers::Optional<Trade::ImageData2D> uncompressed = importer->image2D(0);
+    CORRADE_VERIFY(uncompressed);
+    CORRADE_COMPARE(uncompressed->format(), PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE(uncompressed->size(), (Vector2i{160, 96}));
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    converter->configuration().setValue("bc7Quality", "ultrafast");
+    Containers::Optional<Trade::ImageData2D> compressed2D = converter->convert(*uncompressed);
+    CORRADE_VERIFY(compressed2D);
+
+    /* Be lazy and just cut up the input 2D image to three horizontal slices,
+       forming a 3D input. Set also an array flag to verify it's passed
+       through unchanged. */
+    ImageView3D uncompressed3D{uncompressed->format(), {160, 32, 3}, uncompressed->data(), ImageFlag3D::Array|ImageFlag3D(0xdea0)};
+
+    Containers::Optional<Trade::ImageData3D> compressed = converter->convert(uncompressed3D);
+    CORRADE_VERIFY(compressed);
+    CORRADE_VERIFY(compressed->isCompressed());
+    CORRADE_COMPARE(compressed->flags(), ImageFlag3D::Array|ImageFlag3D(0xdea0));
+    CORRADE_COMPARE(compressed->compressedFormat(), CompressedPixelFormat::Bc7RGBAUnorm);
+    CORRADE_COMPARE(compressed->size(), (Vector3i{160, 32, 3}));
+
+    /* The output data should be exactly the same as for a 2D case, as it's
+       just the same input but in a different shape */
+    CORRADE_COMPARE(Containers::StringView{compressed->data()},
+        Containers::StringView{compressed2D->data()});
+}
+
+void IspcTexCompImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-63x27.png")));
+    Containers::Optional<Trade::ImageData2D> uncompressed = importer->image2D(0);
+    CORRADE_VERIFY(uncompressed);
+
+    /* Three slices to verify the jobs span across slices correctly */
+    ImageView3D uncompressed3D{uncompressed->format(), {63, 9, 3}, uncompressed->data()};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("IspcTexCompImageConverter");
+    converter->configuration().setValue("bc7Quality", "ultrafast");
+    Containers::Optional<Trade::ImageData3D> serial = converter->convert(uncompressed3D);
+    CORRADE_VERIFY(serial);
+
+    converter->configuration().setValue("threads", data.threads);
+    Containers::Optional<Trade::ImageData3D> threaded = converter->convert(uncompressed3D);
+    CORRADE_VERIFY(threaded);
+
+    /* The output should be the same regardless of the thread count */
+    CORRADE_COMPARE(threaded->size(), serial->size());
+    CORRADE_COMPARE(Containers::StringView{threaded->data()},
+        Containers::StringView{serial->data()});
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::IspcTexCompImageConverterTest)
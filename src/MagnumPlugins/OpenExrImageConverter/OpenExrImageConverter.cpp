@@ -28,6 +28,7 @@
 #include <thread> /* std::thread::hardware_concurrency(), sigh */
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -46,6 +47,7 @@
 #include <ImfIO.h>
 #include <ImfOutputFile.h>
 #include <ImfStandardAttributes.h>
+#include <ImfStdIO.h>
 #include <ImfTiledOutputFile.h>
 
 namespace Magnum { namespace Trade {
@@ -102,7 +104,7 @@ Containers::String OpenExrImageConverter::doMimeType() const {
 
 namespace {
 
-Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utility::ConfigurationGroup& configuration, const ImageConverterFlags flags, const PixelFormat format, const ImageFlags3D imageFlags, const Int levelCount, void(*const preparePixelsForLevel)(Int, const Containers::StridedArrayView3D<char>&, void*), const Containers::StridedArrayView3D<char>& pixels, void* const state) try {
+bool convertInternal(const Utility::ConfigurationGroup& configuration, const ImageConverterFlags flags, const char* const messagePrefix, const PixelFormat format, const ImageFlags3D imageFlags, const Vector2i& imageSize, const Int levelCount, Containers::StridedArrayView3D<const char>(*const pixelsForLevel)(Int, void*), void* const state, Containers::Array<char>* const data, const Containers::StringView filename) try {
     /* Figure out type and channel count */
     Imf::PixelType type;
     std::size_t channelCount;
@@ -127,7 +129,7 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
             type = Imf::UINT;
             break;
         default:
-            Error{} << "Trade::OpenExrImageConverter::convertToData(): unsupported format" << format << Debug::nospace << ", only *16F, *32F, *32UI and Depth32F formats supported";
+            Error{} << messagePrefix << "unsupported format" << format << Debug::nospace << ", only *16F, *32F, *32UI and Depth32F formats supported";
             return {};
     }
     switch(format) {
@@ -156,6 +158,31 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
         default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
     }
 
+    /* Channel type in the file. The framebuffer slices stay in the input
+       type, OpenEXR converts the data while compressing each scanline block or
+       tile so there's no need to make a converted copy of the whole image. */
+    Imf::PixelType channelType = type;
+    if(const Containers::StringView channelTypeString = configuration.value<Containers::StringView>("channelType")) {
+        if(channelTypeString == "FLOAT"_s)
+            channelType = Imf::PixelType::FLOAT;
+        else if(channelTypeString == "HALF"_s)
+            channelType = Imf::PixelType::HALF;
+        else if(channelTypeString == "UINT"_s)
+            channelType = Imf::PixelType::UINT;
+        else {
+            Error{} << messagePrefix << "channelType is expected to be FLOAT, HALF or UINT, got" << channelTypeString;
+            return {};
+        }
+
+        constexpr const char* PixelTypeName[] {
+            "UINT",
+            "HALF",
+            "FLOAT"
+        };
+        if(type != channelType && (flags & ImageConverterFlag::Verbose))
+            Debug{} << messagePrefix << "converting" << PixelTypeName[type] << "channels to" << PixelTypeName[channelType];
+    }
+
     /* Output compression. Using the same naming scheme as exrenvmap does,
        except for no compression: https://github.com/AcademySoftwareFoundation/openexr/blob/931618b9088fd03ed4fe30cade55664da94a5854/src/bin/exrenvmap/main.cpp#L138-L174 */
     const Containers::StringView compressionString = configuration.value<Containers::StringView>("compression");
@@ -183,12 +210,11 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
         compression = Imf::DWAB_COMPRESSION;
     /* LCOV_EXCL_STOP */
     else {
-        Error{} << "Trade::OpenExrImageConverter::convertToData(): unknown compression" << compressionString << Debug::nospace << ", allowed values are rle, zip, zips, piz, pxr24, b44, b44a, dwaa, dwab or empty for uncompressed output";
+        Error{} << messagePrefix << "unknown compression" << compressionString << Debug::nospace << ", allowed values are rle, zip, zips, piz, pxr24, b44, b44a, dwaa, dwab or empty for uncompressed output";
         return {};
     }
 
     /* Data window */
-    const Vector2i imageSize{Int(pixels.size()[1]), Int(pixels.size()[0])};
     const Vector2i dataOffsetMin = configuration.value<Vector2i>("dataOffset");
     const Vector2i dataOffsetMax = dataOffsetMin + imageSize - Vector2i{1};
     const Range2Di displayWindow = configuration.value("displayWindow").empty() ?
@@ -252,73 +278,107 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
         2, /* HALF */
         4  /* FLOAT */
     };
-    Imf::FrameBuffer framebuffer;
+    std::string channelNames[4];
     for(std::size_t i = 0; i != channelCount; ++i) {
         std::string name = configuration.value(ChannelOptions[i]);
         if(name.empty()) continue;
 
         name = layerPrefix + name;
 
-        /* OpenEXR uses a std::map inside the Imf::FrameBuffer, but doesn't
-           actually do any error checking on top, which means if we
-           accidentally supply the same channel twice, it'll get ignored ... or
-           maybe it overwrites the previous one. Not sure. Neither behavior
-           seems desirable, so let's fail on that. */
-        if(framebuffer.findSlice(name)) {
-            Error{} << "Trade::OpenExrImageConverter::convertToData(): duplicate mapping for channel" << name;
+        /* OpenEXR uses a std::map inside the Imf::ChannelList and
+           Imf::FrameBuffer, but doesn't actually do any error checking on top,
+           which means if we accidentally supply the same channel twice, it'll
+           get ignored ... or maybe it overwrites the previous one. Not sure.
+           Neither behavior seems desirable, so let's fail on that. */
+        if(header.channels().findChannel(name)) {
+            Error{} << messagePrefix << "duplicate mapping for channel" << name;
             return {};
         }
 
-        header.channels().insert(name, Imf::Channel{type});
-        framebuffer.insert(name, Imf::Slice{
-            type,
-            const_cast<char*>(static_cast<const char*>(pixels.data()))
-                /* For some strange reason I have to supply a pointer to the
-                   first pixel ever, not the first pixel inside the data
-                   window */
-                - dataOffsetMin.y()*std::size_t(pixels.stride()[0])
-                - dataOffsetMin.x()*std::size_t(pixels.stride()[1])
-                /* And an offset to this channel, as they're interleaved */
-                + i*ChannelSizes[type],
-            std::size_t(pixels.stride()[1]),
-            std::size_t(pixels.stride()[0])
-        });
+        header.channels().insert(name, Imf::Channel{channelType});
+        channelNames[i] = Utility::move(name);
     }
 
     /* There should be at least one channel written */
-    if(framebuffer.begin() == framebuffer.end()) {
-        Error{} << "Trade::OpenExrImageConverter::convertToData(): no channels assigned in plugin configuration";
+    if(header.channels().begin() == header.channels().end()) {
+        Error{} << messagePrefix << "no channels assigned in plugin configuration";
         return {};
     }
 
-    /* Increase global thread count if it's not enough. Value of 0 means single
-       thread, while we use 1 for the same (consistent with BasisImageConverter and potential other plugins). */
+    /* Framebuffer pointing to pixels of a particular level. It's set up anew
+       for each level so the pixels can point directly to the input views with
+       their own strides instead of having to be copied to a common scratch
+       memory first. */
+    const auto framebufferForPixels = [&](const Containers::StridedArrayView3D<const char>& pixels) {
+        Imf::FrameBuffer framebuffer;
+        for(std::size_t i = 0; i != channelCount; ++i) {
+            if(channelNames[i].empty()) continue;
+
+            framebuffer.insert(channelNames[i], Imf::Slice{
+                type,
+                const_cast<char*>(static_cast<const char*>(pixels.data()))
+                    /* For some strange reason I have to supply a pointer to
+                       the first pixel ever, not the first pixel inside the
+                       data window */
+                    - dataOffsetMin.y()*pixels.stride()[0]
+                    - dataOffsetMin.x()*pixels.stride()[1]
+                    /* And an offset to this channel, as they're
+                       interleaved */
+                    + i*ChannelSizes[type],
+                /* The strides are std::size_t, so a negative Y stride used
+                   for flipping wraps around. The library however only ever
+                   adds them to the base pointer so it works as expected. */
+                std::size_t(pixels.stride()[1]),
+                std::size_t(pixels.stride()[0])
+            });
+        }
+        return framebuffer;
+    };
+
+    /* Increase global thread count if it's not enough, unless disabled. Value
+       of 0 means single thread, while we use 1 for the same (consistent with
+       BasisImageConverter and potential other plugins). The thread count
+       passed to the file is what limits parallelism for this particular file,
+       the global pool is shared by everything in the process. */
     Int threadCount = configuration.value<Int>("threads");
     if(!threadCount) {
         threadCount = std::thread::hardware_concurrency();
         if(flags & ImageConverterFlag::Verbose)
-            Debug{} << "Trade::OpenExrImageConverter::convertToData(): autodetected hardware concurrency to" << threadCount << "threads";
+            Debug{} << messagePrefix << "autodetected hardware concurrency to" << threadCount << "threads";
     }
     if(Imf::globalThreadCount() < threadCount - 1) {
-        if(flags & ImageConverterFlag::Verbose)
-            Debug{} << "Trade::OpenExrImageConverter::convertToData(): increasing global OpenEXR thread pool from" << Imf::globalThreadCount() << "to" << threadCount - 1 << "extra worker threads";
-        Imf::setGlobalThreadCount(threadCount - 1);
+        if(configuration.value<bool>("growGlobalThreadPool")) {
+            if(flags & ImageConverterFlag::Verbose)
+                Debug{} << messagePrefix << "increasing global OpenEXR thread pool from" << Imf::globalThreadCount() << "to" << threadCount - 1 << "extra worker threads";
+            Imf::setGlobalThreadCount(threadCount - 1);
+        } else if(flags & ImageConverterFlag::Verbose)
+            Debug{} << messagePrefix << "not increasing global OpenEXR thread pool of" << Imf::globalThreadCount() << "extra worker threads to" << threadCount - 1 << "as growGlobalThreadPool is disabled";
     }
 
-    /* Play it safe and destruct everything before we touch the array */
-    Containers::Array<char> data;
+    /* For convertToData() the file is written into a growable array, for
+       convertToFile() it's streamed directly to the file as the scanlines or
+       tiles get compressed, without having the whole output in memory. The
+       file is opened only after all validation is done to not leave empty
+       files behind on error. Play it safe and destruct everything before we
+       touch the array. */
     {
-        MemoryOStream stream{data};
+        Containers::Pointer<Imf::OStream> stream;
+        if(data) stream.emplace<MemoryOStream>(*data);
+        else try {
+            stream.emplace<Imf::StdOFStream>(Containers::String::nullTerminatedView(filename).data());
+        } catch(const Iex::BaseExc&) {
+            Error{} << messagePrefix << "cannot write to file" << filename;
+            return {};
+        }
 
         /* Scanline output. Only if we have just one level and the output
            wasn't forced to be tiled. */
         if(levelCount == 1 && !configuration.value<bool>("forceTiledOutput")) {
-            Imf::OutputFile file{stream, header, threadCount - 1};
-            file.setFrameBuffer(framebuffer);
+            Imf::OutputFile file{*stream, header, threadCount - 1};
 
             /* For consistency, the pixels are assumed to be ready only after
-               the prepareLevel() is called also in the single-level case */
-            preparePixelsForLevel(0, pixels, state);
+               the pixelsForLevel() is called also in the single-level case */
+            file.setFrameBuffer(framebufferForPixels(pixelsForLevel(0, state)));
             file.writePixels(imageSize.y());
 
         /* Tiled output */
@@ -334,8 +394,7 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
                 levelCount == 1 ? Imf::ONE_LEVEL : Imf::MIPMAP_LEVELS,
                 Imf::ROUND_DOWN}); /** @todo configurable? can't use a >> 1 then */
 
-            Imf::TiledOutputFile file{stream, header, threadCount - 1};
-            file.setFrameBuffer(framebuffer);
+            Imf::TiledOutputFile file{*stream, header, threadCount - 1};
 
             /* There doesn't seem to be a way to set level count, it's
                implicitly from the base size and rounding mode. For sanity
@@ -345,12 +404,14 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
                marked as incomplete. */
             CORRADE_INTERNAL_ASSERT(file.numLevels() >= levelCount);
 
-            /* Generate pixels for each levels and write them. This implicitly
-               assumes that the first level is the largest and the remaining
-               levels are each 2x smaller with ROUND_DOWN, the callers are
-               checking for that to prevent garbled output. */
+            /* Get pixels for each level, point the framebuffer to them and
+               write them. This implicitly assumes that the first level is the
+               largest and the remaining levels are each 2x smaller with
+               ROUND_DOWN, the callers are checking for that to prevent garbled
+               output. The data window origin stays the same for all levels,
+               so the framebuffer base pointer calculation doesn't change. */
             for(Int level = 0; level != levelCount; ++level) {
-                preparePixelsForLevel(level, pixels, state);
+                file.setFrameBuffer(framebufferForPixels(pixelsForLevel(level, state)));
                 file.writeTiles(0, file.numXTiles(level) - 1, 0, file.numYTiles(level) - 1, level);
             }
         }
@@ -358,34 +419,31 @@ Containers::Optional<Containers::Array<char>> convertToDataInternal(const Utilit
 
     /* Convert the growable array back to a non-growable with the default
        deleter so we can return it */
-    arrayShrink(data);
+    if(data) arrayShrink(*data);
 
-    /* GCC 4.8 needs extra help here */
-    return Containers::optional(Utility::move(data));
+    return true;
 
 /* Good thing there are function try blocks, otherwise I would have to indent
    the whole thing. That would be awful. */
 } catch(const Iex::BaseExc& e) {
     /* e.message() is only since 2.3.0, use what() for compatibility */
-    Error{} << "Trade::OpenExrImageConverter::convertToData(): conversion error:" << e.what();
+    Error{} << messagePrefix << "conversion error:" << e.what();
     return {};
 }
 
-}
-
-Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertToData(const Containers::ArrayView<const ImageView2D> imageLevels) {
+bool convert2DInternal(const Utility::ConfigurationGroup& configuration, const ImageConverterFlags flags, const char* const messagePrefix, Containers::ArrayView<const ImageView2D> imageLevels, Containers::Array<char>* const data, const Containers::StringView filename) {
     /* Warn about lost metadata */
-    if((imageLevels[0].flags() & ImageFlag2D::Array) && !(flags() & ImageConverterFlag::Quiet)) {
-        Warning{} << "Trade::OpenExrImageConverter::convertToData(): 1D array images are unrepresentable in OpenEXR, saving as a regular 2D image";
+    if((imageLevels[0].flags() & ImageFlag2D::Array) && !(flags & ImageConverterFlag::Quiet)) {
+        Warning{} << messagePrefix << "1D array images are unrepresentable in OpenEXR, saving as a regular 2D image";
     }
 
-    if(configuration().value("envmap") == "latlong") {
+    if(configuration.value("envmap") == "latlong") {
         if(imageLevels[0].size().x() != 2*imageLevels[0].size().y()) {
-            Error{} << "Trade::OpenExrImageConverter::convertToData(): a lat/long environment map has to have a 2:1 aspect ratio, got" << imageLevels[0].size();
+            Error{} << messagePrefix << "a lat/long environment map has to have a 2:1 aspect ratio, got" << imageLevels[0].size();
             return {};
         }
-    } else if(!configuration().value("envmap").empty()) {
-        Error{} << "Trade::OpenExrImageConverter::convertToData(): unknown envmap option" << configuration().value("envmap") << "for a 2D image, expected either empty or latlong for 2D images and empty for 3D images";
+    } else if(!configuration.value("envmap").empty()) {
+        Error{} << messagePrefix << "unknown envmap option" << configuration.value("envmap") << "for a 2D image, expected either empty or latlong for 2D images and empty for 3D images";
         return {};
     }
 
@@ -396,63 +454,47 @@ Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertTo
     for(std::size_t i = 1; i != imageLevels.size(); ++i) {
         const Vector2i expectedSize = imageLevels[0].size() >> i;
         if(expectedSize.isZero()) {
-            Error{} << "Trade::OpenExrImageConverter::convertToData(): there can be only" << i << "levels with base image size" << imageLevels[0].size() << "but got" << imageLevels.size();
+            Error{} << messagePrefix << "there can be only" << i << "levels with base image size" << imageLevels[0].size() << "but got" << imageLevels.size();
             return {};
         }
         if(imageLevels[i].size() != Math::max(expectedSize, Vector2i{1})) {
-            Error{} << "Trade::OpenExrImageConverter::convertToData(): size of image at level" << i << "expected to be" << Math::max(expectedSize, Vector2i{1}) << "but got" << imageLevels[i].size();
+            Error{} << messagePrefix << "size of image at level" << i << "expected to be" << Math::max(expectedSize, Vector2i{1}) << "but got" << imageLevels[i].size();
             return {};
         }
     }
 
-    /* According to my tests, Y flip could be done during image writing the
-       same as when reading by supplying `std::size_t(-rowStride)`, as
-       described in OpenExrImporter::doImage2D(). However, again, although it
-       requires allocating a copy to perform the manual flip, I think it's the
-       saner approach after all. */
-    struct State {
-        Containers::ArrayView<const ImageView2D> imageLevels;
-        Containers::Array<char> flippedData;
-    } state{
-        imageLevels,
-        Containers::Array<char>{NoInit, std::size_t(imageLevels[0].size().product()*imageLevels[0].pixelSize())},
-    };
-    const Containers::StridedArrayView3D<char> flippedPixels{state.flippedData, {
-        std::size_t(imageLevels[0].size().y()),
-        std::size_t(imageLevels[0].size().x()),
-        /* pixels() returns a zero stride if the view is empty, do that here as
-           well to avoid hitting an assert inside copy() */
-        /** @todo why?! figure out and fix */
-        imageLevels[0].size().isZero() ? 0 : imageLevels[0].pixelSize()
-    }};
+    /* As described in OpenExrImporter::doImage2D(), Y flip can be done by
+       supplying `std::size_t(-rowStride)` together with a specially crafted
+       base pointer. While I opted for a manual flip when reading, here it
+       means we don't need to allocate a flipped copy of the whole image but
+       can point OpenEXR directly to the input, which matters especially when
+       streaming large images directly to a file. */
     /* Future-proofing and passing image flags even in case of 2D where
        currently nothing is taken into account. But e.g. Premultiplied might,
        eventually. */
-    return convertToDataInternal(configuration(), flags(), imageLevels[0].format(), ImageFlag3D(UnsignedShort(imageLevels[0].flags())), imageLevels.size(), [](Int level, const Containers::StridedArrayView3D<char>& flippedPixels, void* const data) {
-        State& state = *reinterpret_cast<State*>(data);
-        const Containers::StridedArrayView3D<const char> pixels = state.imageLevels[level].pixels();
-        const Containers::StridedArrayView3D<char> flippedPixelsForLevel = flippedPixels.prefix(pixels.size());
-        Utility::copy(pixels.flipped<0>(), flippedPixelsForLevel);
-    }, flippedPixels, &state);
+    return convertInternal(configuration, flags, messagePrefix, imageLevels[0].format(), ImageFlag3D(UnsignedShort(imageLevels[0].flags())), imageLevels[0].size(), imageLevels.size(), [](const Int level, void* const state) -> Containers::StridedArrayView3D<const char> {
+        const Containers::ArrayView<const ImageView2D>& imageLevels = *static_cast<const Containers::ArrayView<const ImageView2D>*>(state);
+        return imageLevels[level].pixels().flipped<0>();
+    }, &imageLevels, data, filename);
 }
 
-Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertToData(const Containers::ArrayView<const ImageView3D> imageLevels) {
+bool convert3DInternal(const Utility::ConfigurationGroup& configuration, const ImageConverterFlags flags, const char* const messagePrefix, const Containers::ArrayView<const ImageView3D> imageLevels, Containers::Array<char>* const data, const Containers::StringView filename) {
     /* Only cube map saving is supported right now, no deep data. If the
        CubeMap flag is present, it also means the images are square and have
        six faces, so we don't need to test that here again. */
     if(!(imageLevels[0].flags() & ImageFlag3D::CubeMap)) {
-        Error{} << "Trade::OpenExrImageConverter::convertToData(): arbitrary 3D image saving not implemented yet, only ImageFlag3D::CubeMap images can be saved";
+        Error{} << messagePrefix << "arbitrary 3D image saving not implemented yet, only ImageFlag3D::CubeMap images can be saved";
         return {};
     }
 
     /* Yes, it could work for arrays of size 1, but let's stay on the ground */
     if(imageLevels[0].flags() >= (ImageFlag3D::CubeMap|ImageFlag3D::Array)) {
-        Error{} << "Trade::OpenExrImageConverter::convertToData(): cube map arrays are not supported by OpenEXR, save each cube map separately";
+        Error{} << messagePrefix << "cube map arrays are not supported by OpenEXR, save each cube map separately";
         return {};
     }
 
-    if(!configuration().value("envmap").empty()) {
-        Error{} << "Trade::OpenExrImageConverter::convertToData(): unknown envmap option" << configuration().value("envmap") << "for a 3D image, expected either empty or latlong for 2D images and empty for 3D images";
+    if(!configuration.value("envmap").empty()) {
+        Error{} << messagePrefix << "unknown envmap option" << configuration.value("envmap") << "for a 3D image, expected either empty or latlong for 2D images and empty for 3D images";
         return {};
     }
 
@@ -464,11 +506,11 @@ Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertTo
     for(std::size_t i = 0; i != imageLevels.size(); ++i) {
         const Vector3i expectedSize{imageLevels[0].size().xy() >> i, 6};
         if(expectedSize.xy().isZero()) {
-            Error{} << "Trade::OpenExrImageConverter::convertToData(): there can be only" << i << "levels with base cubemap image size" << imageLevels[0].size() << "but got" << imageLevels.size();
+            Error{} << messagePrefix << "there can be only" << i << "levels with base cubemap image size" << imageLevels[0].size() << "but got" << imageLevels.size();
             return {};
         }
         if(imageLevels[i].size() != expectedSize) {
-            Error{} << "Trade::OpenExrImageConverter::convertToData(): size of cubemap image at level" << i << "expected to be" << expectedSize << "but got" << imageLevels[i].size();
+            Error{} << messagePrefix << "size of cubemap image at level" << i << "expected to be" << expectedSize << "but got" << imageLevels[i].size();
             return {};
         }
     }
@@ -503,28 +545,30 @@ Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertTo
     struct State {
         Containers::ArrayView<const ImageView3D> imageLevels;
         Containers::Array<char> flippedData;
+        /* A 2D framebuffer for OpenEXR. From this we have to recreate a 3D
+           view every time to access particular layers. Can't create a 3D
+           view upfront and slice it because it has to be contiguous in Y. */
+        Containers::StridedArrayView3D<char> flippedPixelsFlattened;
     } state{
         imageLevels,
-        Containers::Array<char>{NoInit, std::size_t(imageLevels[0].size().product()*imageLevels[0].pixelSize())}
+        Containers::Array<char>{NoInit, std::size_t(imageLevels[0].size().product()*imageLevels[0].pixelSize())},
+        {}
     };
-    /* A 2D framebuffer for OpenEXR. From this we have to recreate a 3D view
-       every time to access particular layers. Can't create a 3D view upfront
-       and slice it because it has to be contiguous in Y. */
-    Containers::StridedArrayView3D<char> flippedPixelsFlattened{state.flippedData, {
+    state.flippedPixelsFlattened = Containers::StridedArrayView3D<char>{state.flippedData, {
         std::size_t(imageLevels[0].size().z()*imageLevels[0].size().y()),
         std::size_t(imageLevels[0].size().x()),
         imageLevels[0].pixelSize()
     }};
-    return convertToDataInternal(configuration(), flags(), imageLevels[0].format(), imageLevels[0].flags(), imageLevels.size(), [](const Int level, const Containers::StridedArrayView3D<char>& flippedPixelsFlattened, void* const data) {
+    return convertInternal(configuration, flags, messagePrefix, imageLevels[0].format(), imageLevels[0].flags(), {imageLevels[0].size().x(), imageLevels[0].size().z()*imageLevels[0].size().y()}, imageLevels.size(), [](const Int level, void* const data) -> Containers::StridedArrayView3D<const char> {
         State& state = *reinterpret_cast<State*>(data);
         const Containers::StridedArrayView4D<const char> pixels = state.imageLevels[level].pixels();
         const Containers::StridedArrayView4D<char> flippedPixelsForLevel{
             state.flippedData,
             pixels.size(),
-            {flippedPixelsFlattened.stride()[0]*std::ptrdiff_t(pixels.size()[1]),
-             flippedPixelsFlattened.stride()[0],
-             flippedPixelsFlattened.stride()[1],
-             flippedPixelsFlattened.stride()[2]}
+            {state.flippedPixelsFlattened.stride()[0]*std::ptrdiff_t(pixels.size()[1]),
+             state.flippedPixelsFlattened.stride()[0],
+             state.flippedPixelsFlattened.stride()[1],
+             state.flippedPixelsFlattened.stride()[2]}
         };
         Utility::copy(pixels[0].flipped<1>(), flippedPixelsForLevel[0]);
         Utility::copy(pixels[1].flipped<1>(), flippedPixelsForLevel[1]);
@@ -532,7 +576,42 @@ Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertTo
         Utility::copy(pixels[3].flipped<0>(), flippedPixelsForLevel[3]);
         Utility::copy(pixels[4].flipped<1>(), flippedPixelsForLevel[4]);
         Utility::copy(pixels[5].flipped<1>(), flippedPixelsForLevel[5]);
-    }, flippedPixelsFlattened, &state);
+        /* All six faces of this level, keeping the row stride of the first
+           level */
+        return state.flippedPixelsFlattened.prefix({
+            pixels.size()[0]*pixels.size()[1],
+            pixels.size()[2],
+            pixels.size()[3]
+        });
+    }, &state, data, filename);
+}
+
+}
+
+Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertToData(const Containers::ArrayView<const ImageView2D> imageLevels) {
+    Containers::Array<char> data;
+    if(!convert2DInternal(configuration(), flags(), "Trade::OpenExrImageConverter::convertToData():", imageLevels, &data, {}))
+        return {};
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(data));
+}
+
+Containers::Optional<Containers::Array<char>> OpenExrImageConverter::doConvertToData(const Containers::ArrayView<const ImageView3D> imageLevels) {
+    Containers::Array<char> data;
+    if(!convert3DInternal(configuration(), flags(), "Trade::OpenExrImageConverter::convertToData():", imageLevels, &data, {}))
+        return {};
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(data));
+}
+
+bool OpenExrImageConverter::doConvertToFile(const Containers::ArrayView<const ImageView2D> imageLevels, const Containers::StringView filename) {
+    return convert2DInternal(configuration(), flags(), "Trade::OpenExrImageConverter::convertToFile():", imageLevels, nullptr, filename);
+}
+
+bool OpenExrImageConverter::doConvertToFile(const Containers::ArrayView<const ImageView3D> imageLevels, const Containers::StringView filename) {
+    return convert3DInternal(configuration(), flags(), "Trade::OpenExrImageConverter::convertToFile():", imageLevels, nullptr, filename);
 }
 
 }}
@@ -148,6 +148,19 @@ implicitly written to channels named `R`, `G`, `B` and `A`; images with
 If the default behavior is not sufficient, custom channel mapping can be
 supplied @ref Trade-OpenExrImageConverter-configuration "in the configuration".
 
+@subsection Trade-OpenExrImageConverter-behavior-channel-type Channel type conversion
+
+By default the channels are saved in the same type as the input format, i.e.
+`HALF` for @ref PixelFormat::RGBA16F and similar, `FLOAT` for
+@ref PixelFormat::RGBA32F and similar and `UINT` for
+@ref PixelFormat::RGBA32UI and similar. A different type can be chosen with the
+@cb{.ini} channelType @ce @ref Trade-OpenExrImageConverter-configuration "configuration option",
+for example to save 32-bit float data as `HALF` to halve the file size. The
+conversion is done by OpenEXR itself while compressing each scanline block or
+tile, so no converted copy of the whole image is made. With
+@ref ImageConverterFlag::Verbose enabled, the plugin prints a message when a
+conversion is performed.
+
 @subsection Trade-OpenExrImageConverter-behavior-multilayer-multipart Multilayer and multipart images, deep images
 
 Channels can be prefixed with a custom layer name by specifying the
@@ -189,6 +202,17 @@ the @cb{.ini} tileSize @ce @ref Trade-OpenExrImporter-configuration "configurati
 Single-level images are implicitly written as scanline files, you can override
 that with the @cpp forceTiledOutput @ce option.
 
+@subsection Trade-OpenExrImageConverter-behavior-file-output File output
+
+With @ref convertToFile(), the scanlines or tiles are streamed directly to the
+output file as they get compressed instead of being assembled in memory first.
+Together with 2D images being passed to OpenEXR directly without making a
+Y-flipped copy, this means memory use for large images stays bounded to a few
+scanlines or tiles on top of the input data. Cube map images are still copied
+to a temporary buffer first, as OpenEXR isn't capable of doing the X flips
+needed for some faces. If the conversion fails after the file was opened, a
+partially written file may be left behind.
+
 @section Trade-OpenExrImageConverter-configuration Plugin-specific configuration
 
 It's possible to tune various options mainly for channel mapping through
@@ -213,6 +237,16 @@ find_package(Threads REQUIRED)
 target_link_libraries(your-application PRIVATE Threads::Threads)
 @endcode
 
+The @cb{.ini} threads @ce option limits how many tasks for a particular file
+are processed in parallel, but the tasks themselves are executed by a global
+OpenEXR thread pool shared by everything in the process. By default, if the
+global pool has less than @cb{.ini} threads @ce minus one worker threads, it's
+enlarged and stays at that size. If the application wants to control the
+global pool itself, for example to avoid oversubscription with multiple
+concurrent conversions or to install a custom `IlmThread::ThreadPoolProvider`,
+disable the @cb{.ini} growGlobalThreadPool @ce option and the plugin won't
+touch the pool at all.
+
 */
 class MAGNUM_OPENEXRIMAGECONVERTER_EXPORT OpenExrImageConverter: public AbstractImageConverter {
     public:
@@ -226,6 +260,9 @@ class MAGNUM_OPENEXRIMAGECONVERTER_EXPORT OpenExrImageConverter: public Abstract
 
         MAGNUM_OPENEXRIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(Containers::ArrayView<const ImageView2D> imageLevels) override;
         MAGNUM_OPENEXRIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(Containers::ArrayView<const ImageView3D> imageLevels) override;
+
+        MAGNUM_OPENEXRIMAGECONVERTER_LOCAL bool doConvertToFile(Containers::ArrayView<const ImageView2D> imageLevels, Containers::StringView filename) override;
+        MAGNUM_OPENEXRIMAGECONVERTER_LOCAL bool doConvertToFile(Containers::ArrayView<const ImageView3D> imageLevels, Containers::StringView filename) override;
 };
 
 }}
@@ -30,6 +30,8 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/File.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
@@ -81,6 +83,9 @@ struct OpenExrImageConverterTest: TestSuite::Tester {
     void customChannelsDepth();
     void customChannelsDepthUnassigned();
 
+    void channelType();
+    void channelTypeInvalid();
+
     void customWindows();
     void customWindowsCubeMap();
 
@@ -100,6 +105,11 @@ struct OpenExrImageConverterTest: TestSuite::Tester {
 
     void threads();
 
+    void convertToFile();
+    void convertToFileLevels2D();
+    void convertToFileCubeMap();
+    void convertToFileFailed();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _manager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -244,21 +254,25 @@ const struct {
 const struct {
     const char* name;
     Int threads;
+    bool growGlobalThreadPool;
     bool verbose;
     const char* message;
 } ThreadsData[]{
-    {"default", 1, true,
+    {"default", 1, true, true,
         ""},
-    {"two, verbose", 2, true,
+    /* Has to be before the global pool gets increased for the first time */
+    {"two, global pool not grown, verbose", 2, false, true,
+        "Trade::OpenExrImageConverter::convertToData(): not increasing global OpenEXR thread pool of 0 extra worker threads to 1 as growGlobalThreadPool is disabled\n"},
+    {"two, verbose", 2, true, true,
         "Trade::OpenExrImageConverter::convertToData(): increasing global OpenEXR thread pool from 0 to 1 extra worker threads\n"},
-    {"three, quiet", 3, false,
+    {"three, quiet", 3, true, false,
         ""},
     /* This gets skipped if the detected thread count is not more than 3 as the
        second message won't get printed then */
-    {"all, verbose", 0, true,
+    {"all, verbose", 0, true, true,
         "Trade::OpenExrImageConverter::convertToData(): autodetected hardware concurrency to {} threads\n"
         "Trade::OpenExrImageConverter::convertToData(): increasing global OpenEXR thread pool from 2 to {} extra worker threads\n"},
-    {"all, quiet", 0, false,
+    {"all, quiet", 0, true, false,
         ""}
 };
 
@@ -289,6 +303,9 @@ OpenExrImageConverterTest::OpenExrImageConverterTest() {
               &OpenExrImageConverterTest::customChannelsDepth,
               &OpenExrImageConverterTest::customChannelsDepthUnassigned,
 
+              &OpenExrImageConverterTest::channelType,
+              &OpenExrImageConverterTest::channelTypeInvalid,
+
               &OpenExrImageConverterTest::customWindows,
               &OpenExrImageConverterTest::customWindowsCubeMap});
 
@@ -319,6 +336,13 @@ OpenExrImageConverterTest::OpenExrImageConverterTest() {
         disabled"? */
     addInstancedTests({&OpenExrImageConverterTest::threads}, Containers::arraySize(ThreadsData));
 
+    addInstancedTests({&OpenExrImageConverterTest::convertToFile},
+        Containers::arraySize(TiledData));
+
+    addTests({&OpenExrImageConverterTest::convertToFileLevels2D,
+              &OpenExrImageConverterTest::convertToFileCubeMap,
+              &OpenExrImageConverterTest::convertToFileFailed});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef OPENEXRIMAGECONVERTER_PLUGIN_FILENAME
@@ -328,6 +352,9 @@ OpenExrImageConverterTest::OpenExrImageConverterTest() {
     #ifdef OPENEXRIMPORTER_PLUGIN_FILENAME
     CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(OPENEXRIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
     #endif
+
+    /* Create the output directory if it doesn't exist yet */
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Utility::Path::make(OPENEXRIMAGECONVERTER_TEST_OUTPUT_DIR));
 }
 
 void OpenExrImageConverterTest::wrongFormat() {
@@ -752,6 +779,58 @@ void OpenExrImageConverterTest::customChannelsDepthUnassigned() {
     CORRADE_COMPARE(out.str(), "Trade::OpenExrImageConverter::convertToData(): no channels assigned in plugin configuration\n");
 }
 
+void OpenExrImageConverterTest::channelType() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("OpenExrImageConverter");
+    converter->configuration().setValue("channelType", "HALF");
+    converter->addFlags(ImageConverterFlag::Verbose);
+
+    std::ostringstream out;
+    Containers::Optional<Containers::Array<char>> data;
+    {
+        Debug redirectOutput{&out};
+        data = converter->convertToData(Rgba32f);
+    }
+    CORRADE_VERIFY(data);
+    CORRADE_COMPARE(out.str(), "Trade::OpenExrImageConverter::convertToData(): converting FLOAT channels to HALF\n");
+
+    /* The file should be smaller than with FLOAT channels */
+    converter->setFlags({});
+    converter->configuration().setValue("channelType", "");
+    Containers::Optional<Containers::Array<char>> dataFloat = converter->convertToData(Rgba32f);
+    CORRADE_VERIFY(dataFloat);
+    CORRADE_COMPARE_AS(data->size(), dataFloat->size(),
+        TestSuite::Compare::Less);
+
+    if(_importerManager.loadState("OpenExrImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("OpenExrImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("OpenExrImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+
+    /* The values are all representable as halves */
+    const Half expectedData[] {
+        0.0_h, 1.0_h, 2.0_h, 3.0_h,
+        4.0_h, 5.0_h, 6.0_h, 7.0_h,
+        8.0_h, 9.0_h, 10.0_h, 11.0_h
+    };
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA16F);
+    CORRADE_COMPARE_AS(*image,
+        (ImageView2D{PixelFormat::RGBA16F, {1, 3}, expectedData}),
+        DebugTools::CompareImage);
+}
+
+void OpenExrImageConverterTest::channelTypeInvalid() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("OpenExrImageConverter");
+    converter->configuration().setValue("channelType", "half");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(Rgba32f));
+    CORRADE_COMPARE(out.str(), "Trade::OpenExrImageConverter::convertToData(): channelType is expected to be FLOAT, HALF or UINT, got half\n");
+}
+
 void OpenExrImageConverterTest::customWindows() {
     Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("OpenExrImageConverter");
     converter->configuration().setValue("displayWindow", Vector4i{38, 56, 47, 72});
@@ -1351,6 +1430,8 @@ void OpenExrImageConverterTest::threads() {
     Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("OpenExrImageConverter");
     if(data.threads != 1)
         converter->configuration().setValue("threads", data.threads);
+    if(!data.growGlobalThreadPool)
+        converter->configuration().setValue("growGlobalThreadPool", false);
     if(data.verbose)
         converter->addFlags(ImageConverterFlag::Verbose);
 
@@ -1368,6 +1449,118 @@ void OpenExrImageConverterTest::threads() {
         std::thread::hardware_concurrency() - 1));
 }
 
+void OpenExrImageConverterTest::convertToFile() {
+    auto&& data = TiledData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("OpenExrImageConverter");
+    if(data.tiled)
+        converter->configuration().setValue("forceTiledOutput", true);
+
+    /* The file is streamed directly from the (Y-flipped) input view instead
+       of going through an in-memory copy, but the output should be exactly
+       the same as with convertToData() */
+    Containers::String filename = Utility::Path::join(OPENEXRIMAGECONVERTER_TEST_OUTPUT_DIR, data.filename);
+    if(Utility::Path::exists(filename))
+        CORRADE_VERIFY(Utility::Path::remove(filename));
+
+    CORRADE_VERIFY(converter->convertToFile(Rgb16f, filename));
+    CORRADE_COMPARE_AS(filename,
+        Utility::Path::join(OPENEXRIMPORTER_TEST_DIR, data.filename),
+        TestSuite::Compare::File);
+
+    if(_importerManager.loadState("OpenExrImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("OpenExrImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("OpenExrImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE_AS(*image, Rgb16f, DebugTools::CompareImage);
+}
+
+void OpenExrImageConverterTest::convertToFileLevels2D() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("OpenExrImageConverter");
+
+    /* Same as in levels2D(), except that the first level has a padded row
+       length to verify each level gets its own framebuffer setup */
+    const Half data0[] = {
+         0.0_h,  1.0_h,  2.0_h,  3.0_h,  4.0_h, {},
+         5.0_h,  6.0_h,  7.0_h,  8.0_h,  9.0_h, {},
+        10.0_h, 11.0_h, 12.0_h, 13.0_h, 14.0_h, {}
+    };
+    const Half data1[] = {
+        0.5_h, 2.5_h,
+    };
+    const Half data2[] = {
+        1.5_h
+    };
+    ImageView2D image0{PixelStorage{}.setAlignment(1).setRowLength(6), PixelFormat::R16F, {5, 3}, data0};
+    ImageView2D image1{PixelStorage{}.setAlignment(1), PixelFormat::R16F, {2, 1}, data1};
+    ImageView2D image2{PixelStorage{}.setAlignment(1), PixelFormat::R16F, {1, 1}, data2};
+
+    Containers::String filename = Utility::Path::join(OPENEXRIMAGECONVERTER_TEST_OUTPUT_DIR, "levels2D.exr");
+    if(Utility::Path::exists(filename))
+        CORRADE_VERIFY(Utility::Path::remove(filename));
+
+    CORRADE_VERIFY(converter->convertToFile({image0, image1, image2}, filename));
+    CORRADE_COMPARE_AS(filename,
+        Utility::Path::join(OPENEXRIMPORTER_TEST_DIR, "levels2D.exr"),
+        TestSuite::Compare::File);
+}
+
+void OpenExrImageConverterTest::convertToFileCubeMap() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("OpenExrImageConverter");
+
+    /* Reset ZIP compression level to 6 for consistency with versions before
+       3.1.3 (on those it's the hardcoded default) */
+    converter->configuration().setValue("zipCompressionLevel", 6);
+
+    Containers::String filename = Utility::Path::join(OPENEXRIMAGECONVERTER_TEST_OUTPUT_DIR, "envmap-cube.exr");
+    if(Utility::Path::exists(filename))
+        CORRADE_VERIFY(Utility::Path::remove(filename));
+
+    CORRADE_VERIFY(converter->convertToFile(CubeRg16f, filename));
+    #if OPENEXR_VERSION_MAJOR*10000 + OPENEXR_VERSION_MINOR*100 + OPENEXR_VERSION_PATCH >= 30200
+    CORRADE_COMPARE_AS(filename,
+        Utility::Path::join(OPENEXRIMPORTER_TEST_DIR, "envmap-cube.exr"),
+        TestSuite::Compare::File);
+    #else
+    CORRADE_COMPARE_AS(filename,
+        Utility::Path::join(OPENEXRIMAGECONVERTER_TEST_DIR, "envmap-cube-31.exr"),
+        TestSuite::Compare::File);
+    #endif
+}
+
+void OpenExrImageConverterTest::convertToFileFailed() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("OpenExrImageConverter");
+
+    /* Validation errors are reported with the convertToFile() prefix and no
+       file is created */
+    {
+        Containers::String filename = Utility::Path::join(OPENEXRIMAGECONVERTER_TEST_OUTPUT_DIR, "wrong-format.exr");
+        if(Utility::Path::exists(filename))
+            CORRADE_VERIFY(Utility::Path::remove(filename));
+
+        const char data[4]{};
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!converter->convertToFile(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, data}, filename));
+        CORRADE_COMPARE(out.str(), "Trade::OpenExrImageConverter::convertToFile(): unsupported format PixelFormat::RGBA8Unorm, only *16F, *32F, *32UI and Depth32F formats supported\n");
+        CORRADE_VERIFY(!Utility::Path::exists(filename));
+
+    /* The file can't be opened for writing */
+    } {
+        Containers::String filename = Utility::Path::join(OPENEXRIMAGECONVERTER_TEST_OUTPUT_DIR, "nonexistent/file.exr");
+
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!converter->convertToFile(Rgb16f, filename));
+        CORRADE_COMPARE(out.str(), Utility::formatString("Trade::OpenExrImageConverter::convertToFile(): cannot write to file {}\n", filename));
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::OpenExrImageConverterTest)
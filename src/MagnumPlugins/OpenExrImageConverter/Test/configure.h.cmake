@@ -27,3 +27,4 @@
 #cmakedefine OPENEXRIMPORTER_PLUGIN_FILENAME "${OPENEXRIMPORTER_PLUGIN_FILENAME}"
 #define OPENEXRIMAGECONVERTER_TEST_DIR "${OPENEXRIMAGECONVERTER_TEST_DIR}"
 #define OPENEXRIMPORTER_TEST_DIR "${OPENEXRIMPORTER_TEST_DIR}"
+#define OPENEXRIMAGECONVERTER_TEST_OUTPUT_DIR "${OPENEXRIMAGECONVERTER_TEST_OUTPUT_DIR}"
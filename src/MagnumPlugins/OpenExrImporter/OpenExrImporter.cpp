@@ -146,8 +146,11 @@ void OpenExrImporter::doOpenData(Containers::Array<char>&& data, const DataFlags
     /* Set up the input stream using the MemoryIStream class above */
     Containers::Pointer<State> state{InPlaceInit, Utility::move(dataCopy)};
 
-    /* Increase global thread count if it's not enough. Value of 0 means single
-       thread, while we use 1 for the same (consistent with BasisImageConverter and potential other plugins). */
+    /* Increase global thread count if it's not enough, unless disabled. Value
+       of 0 means single thread, while we use 1 for the same (consistent with
+       BasisImageConverter and potential other plugins). The thread count
+       passed to the file is what limits parallelism for this particular file,
+       the global pool is shared by everything in the process. */
     Int threadCount = configuration().value<Int>("threads");
     if(!threadCount) {
         threadCount = std::thread::hardware_concurrency();
@@ -155,9 +158,12 @@ void OpenExrImporter::doOpenData(Containers::Array<char>&& data, const DataFlags
             Debug{} << "Trade::OpenExrImporter::openData(): autodetected hardware concurrency to" << threadCount << "threads";
     }
     if(Imf::globalThreadCount() < threadCount - 1) {
-        if(flags() & ImporterFlag::Verbose)
-            Debug{} << "Trade::OpenExrImporter::openData(): increasing global OpenEXR thread pool from" << Imf::globalThreadCount() << "to" << threadCount - 1 << "extra worker threads";
-        Imf::setGlobalThreadCount(threadCount - 1);
+        if(configuration().value<bool>("growGlobalThreadPool")) {
+            if(flags() & ImporterFlag::Verbose)
+                Debug{} << "Trade::OpenExrImporter::openData(): increasing global OpenEXR thread pool from" << Imf::globalThreadCount() << "to" << threadCount - 1 << "extra worker threads";
+            Imf::setGlobalThreadCount(threadCount - 1);
+        } else if(flags() & ImporterFlag::Verbose)
+            Debug{} << "Trade::OpenExrImporter::openData(): not increasing global OpenEXR thread pool of" << Imf::globalThreadCount() << "extra worker threads to" << threadCount - 1 << "as growGlobalThreadPool is disabled";
     }
 
     /* Open the file. There's two kinds of files, scanline and tiled. Tiled
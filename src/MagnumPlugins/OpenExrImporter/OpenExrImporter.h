@@ -292,6 +292,16 @@ find_package(Threads REQUIRED)
 target_link_libraries(your-application PRIVATE Threads::Threads)
 @endcode
 
+The @cb{.ini} threads @ce option limits how many tasks for a particular file
+are processed in parallel, but the tasks themselves are executed by a global
+OpenEXR thread pool shared by everything in the process. By default, if the
+global pool has less than @cb{.ini} threads @ce minus one worker threads, it's
+enlarged and stays at that size. If the application wants to control the
+global pool itself, for example to avoid oversubscription with multiple
+concurrent conversions or to install a custom `IlmThread::ThreadPoolProvider`,
+disable the @cb{.ini} growGlobalThreadPool @ce option and the plugin won't
+touch the pool at all.
+
 */
 class MAGNUM_OPENEXRIMPORTER_EXPORT OpenExrImporter: public AbstractImporter {
     public:
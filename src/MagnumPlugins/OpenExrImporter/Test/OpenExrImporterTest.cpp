@@ -175,21 +175,25 @@ const struct {
 const struct {
     const char* name;
     Int threads;
+    bool growGlobalThreadPool;
     bool verbose;
     const char* message;
 } ThreadsData[]{
-    {"default", 1, true,
+    {"default", 1, true, true,
         ""},
-    {"two, verbose", 2, true,
+    /* Has to be before the global pool gets increased for the first time */
+    {"two, global pool not grown, verbose", 2, false, true,
+        "Trade::OpenExrImporter::openData(): not increasing global OpenEXR thread pool of 0 extra worker threads to 1 as growGlobalThreadPool is disabled\n"},
+    {"two, verbose", 2, true, true,
         "Trade::OpenExrImporter::openData(): increasing global OpenEXR thread pool from 0 to 1 extra worker threads\n"},
-    {"three, quiet", 3, false,
+    {"three, quiet", 3, true, false,
         ""},
     /* This gets skipped if the detected thread count is not more than 3 as the
        second message won't get printed then */
-    {"all, verbose", 0, true,
+    {"all, verbose", 0, true, true,
         "Trade::OpenExrImporter::openData(): autodetected hardware concurrency to {} threads\n"
         "Trade::OpenExrImporter::openData(): increasing global OpenEXR thread pool from 2 to {} extra worker threads\n"},
-    {"all, quiet", 0, false,
+    {"all, quiet", 0, true, false,
         ""}
 };
 
@@ -1066,6 +1070,8 @@ void OpenExrImporterTest::threads() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenExrImporter");
     if(data.threads != 1)
         importer->configuration().setValue("threads", data.threads);
+    if(!data.growGlobalThreadPool)
+        importer->configuration().setValue("growGlobalThreadPool", false);
     if(data.verbose)
         importer->addFlags(ImporterFlag::Verbose);
 
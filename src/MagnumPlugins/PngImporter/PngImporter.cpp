@@ -104,7 +104,6 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
     Containers::ScopeGuard pngStateGuard{&pngState, [](PngState* state) {
         png_destroy_read_struct(&state->file, &state->info, nullptr);
     }};
-    Containers::Array<png_bytep> rows;
     Containers::Array<char> data;
 
     /* Error handling routine. Since we're replacing the png_default_error()
@@ -127,6 +126,13 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
         }
     );
 
+    /* Use NEON-optimized filter implementations if libpng has them compiled
+       in but disabled by default. SSE and MIPS variants, if compiled in, are
+       used unconditionally. */
+    #if defined(PNG_SET_OPTION_SUPPORTED) && defined(PNG_ARM_NEON_API_SUPPORTED)
+    png_set_option(file, PNG_ARM_NEON, PNG_OPTION_ON);
+    #endif
+
     /* Set functions for reading */
     Containers::ArrayView<char> input = _in;
     png_set_read_fn(file, &input, [](const png_structp file, const png_bytep data, const png_size_t length) {
@@ -201,10 +207,8 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
         else if(channels == 4)
             colorType = PNG_COLOR_TYPE_RGBA;
         else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-        /* png_get_bit_depth(file, info); would return the original value
-           here (which can be < 8), expecting the png_set_*() function to give
-           back 8-bit channels */
-        bits = 8;
+        /* The bit depth is kept. Values < 8 were already expanded to 8 above,
+           16-bit images get a 16-bit alpha channel. */
     }
 
     /* Premultiply alpha, if desired */
@@ -291,21 +295,35 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
         }
     }
 
-    /* Initialize data array, align rows to four bytes */
-    CORRADE_INTERNAL_ASSERT(bits >= 8);
-    const std::size_t stride = ((size.x()*channels*bits/8 + 3)/4)*4;
-    data = Containers::Array<char>{stride*std::size_t(size.y())};
-
     /* Endianness correction for 16 bit depth */
     #ifndef CORRADE_TARGET_BIG_ENDIAN
     if(bits == 16) png_set_swap(file);
     #endif
 
-    /* Read image row by row */
-    rows = Containers::Array<png_bytep>{std::size_t(size.y())};
-    for(Int i = 0; i != size.y(); ++i)
-        rows[i] = reinterpret_cast<unsigned char*>(data.data()) + (size.y() - i - 1)*stride;
-    png_read_image(file, rows);
+    /* Enable deinterlacing, if needed, and apply all transformations set
+       above so the row size can be verified against our expectations */
+    const Int passCount = png_set_interlace_handling(file);
+    png_read_update_info(file, info);
+
+    /* Initialize data array, align rows to four bytes. The allocation isn't
+       zero-initialized as every row gets fully written below, only the
+       padding at the end of each row is cleared. */
+    CORRADE_INTERNAL_ASSERT(bits >= 8);
+    const std::size_t rowSize = std::size_t(size.x())*channels*bits/8;
+    const std::size_t stride = ((rowSize + 3)/4)*4;
+    CORRADE_INTERNAL_ASSERT(png_get_rowbytes(file, info) == rowSize);
+    data = Containers::Array<char>{NoInit, stride*std::size_t(size.y())};
+    if(stride != rowSize) for(std::size_t i = 0; i != std::size_t(size.y()); ++i)
+        std::memset(data.data() + i*stride + rowSize, 0, stride - rowSize);
+
+    /* Read the image row by row directly into the output, with the Y flip
+       done by writing the first row to the end. For interlaced images libpng
+       needs each row to be passed once for every pass, combining the new
+       pixels with the ones already present. */
+    for(Int pass = 0; pass != passCount; ++pass) {
+        for(std::size_t i = 0; i != std::size_t(size.y()); ++i)
+            png_read_row(file, reinterpret_cast<png_bytep>(data.data()) + (size.y() - i - 1)*stride, nullptr);
+    }
 
     /* 8-bit images */
     PixelFormat format;
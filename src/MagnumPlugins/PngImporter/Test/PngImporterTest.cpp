@@ -54,10 +54,12 @@ struct PngImporterTest: TestSuite::Tester {
 
     void gray();
     void gray16();
+    void gray16Trns();
     void grayAlpha();
     void grayAlphaBinaryAlpha();
     void rgb();
     void rgb16();
+    void rgb16Trns();
     void rgbPalette1bit();
     void rgba();
     void rgbaBinaryAlpha();
@@ -175,6 +177,9 @@ constexpr struct {
     {"RGB, premultiplied alpha", "rgb.png", true},
     /* convert rgb.png -define png:exclude-chunks=date png8:palette.png */
     {"palette", "rgb-palette.png", false},
+    /* Same as rgb.png, but Adam7-interlaced. All passes except the ones
+       entirely outside of the 3x2 image are non-empty. */
+    {"interlaced", "rgb-interlaced.png", false},
 };
 
 constexpr struct {
@@ -328,7 +333,8 @@ PngImporterTest::PngImporterTest() {
     addInstancedTests({&PngImporterTest::gray},
         Containers::arraySize(GrayData));
 
-    addTests({&PngImporterTest::gray16});
+    addTests({&PngImporterTest::gray16,
+              &PngImporterTest::gray16Trns});
 
     addInstancedTests({&PngImporterTest::grayAlpha},
         Containers::arraySize(GrayAlphaData));
@@ -340,6 +346,7 @@ PngImporterTest::PngImporterTest() {
         Containers::arraySize(RgbData));
 
     addTests({&PngImporterTest::rgb16,
+              &PngImporterTest::rgb16Trns,
               &PngImporterTest::rgbPalette1bit});
 
     addInstancedTests({&PngImporterTest::rgba},
@@ -449,6 +456,25 @@ void PngImporterTest::gray16() {
     }), TestSuite::Compare::Container);
 }
 
+void PngImporterTest::gray16Trns() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    /* Same as gray16.png but with a tRNS chunk, see png16-trns.py */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, "gray16-trns.png")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->flags(), ImageFlags2D{});
+    CORRADE_COMPARE(image->size(), Vector2i(2, 3));
+    /* The bit depth is kept, with a 16-bit alpha channel */
+    CORRADE_COMPARE(image->format(), PixelFormat::RG16Unorm);
+
+    CORRADE_COMPARE_AS(image->pixels<Vector2us>().asContiguous(), Containers::arrayView<Vector2us>({
+        {1000, 0xffff}, {2000, 0xffff},
+        {3000, 0x0000}, {4000, 0xffff},
+        {5000, 0xffff}, {6000, 0xffff}
+    }), TestSuite::Compare::Container);
+}
+
 void PngImporterTest::grayAlpha() {
     auto&& data = GrayAlphaData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -572,6 +598,25 @@ void PngImporterTest::rgb16() {
     }), TestSuite::Compare::Container);
 }
 
+void PngImporterTest::rgb16Trns() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    /* Same as rgb16.png but with a tRNS chunk, see png16-trns.py */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, "rgb16-trns.png")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->flags(), ImageFlags2D{});
+    CORRADE_COMPARE(image->size(), Vector2i(2, 3));
+    /* The bit depth is kept, with a 16-bit alpha channel */
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA16Unorm);
+
+    CORRADE_COMPARE_AS(image->pixels<Vector4us>().asContiguous(), Containers::arrayView<Vector4us>({
+        {1000, 2000, 3000, 0xffff}, {2000, 3000, 4000, 0xffff},
+        {3000, 4000, 5000, 0xffff}, {4000, 5000, 6000, 0x0000},
+        {5000, 6000, 7000, 0xffff}, {6000, 7000, 8000, 0xffff}
+    }), TestSuite::Compare::Container);
+}
+
 void PngImporterTest::rgbPalette1bit() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
 
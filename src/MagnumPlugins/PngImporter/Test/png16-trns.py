@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# Generates 16-bit grayscale and RGB PNGs with a tRNS chunk, with the same
+# pixel values as gray16.png and rgb16.png. The tRNS color matches exactly one
+# pixel, which then gets a zero alpha after import. Written by hand to have full
+# control over the tRNS chunk contents. Usage:
+#
+#   ./png16-trns.py gray16-trns.png rgb16-trns.png
+
+import struct
+import sys
+import zlib
+
+def chunk(type, data):
+    return (struct.pack('>I', len(data)) + type + data +
+            struct.pack('>I', zlib.crc32(type + data)))
+
+def png(filename, width, height, color_type, pixels, trns):
+    ihdr = struct.pack('>IIBBBBB', width, height, 16, color_type, 0, 0, 0)
+    rows = b''
+    for y in range(height):
+        # Filter type 0 (none) for each row
+        rows += b'\x00'
+        for x in range(width):
+            rows += struct.pack('>' + 'H'*len(pixels[y*width + x]), *pixels[y*width + x])
+
+    with open(filename, 'wb') as f:
+        f.write(b'\x89PNG\r\n\x1a\n')
+        f.write(chunk(b'IHDR', ihdr))
+        f.write(chunk(b'tRNS', struct.pack('>' + 'H'*len(trns), *trns)))
+        f.write(chunk(b'IDAT', zlib.compress(rows, 9)))
+        f.write(chunk(b'IEND', b''))
+
+# Color type 0, grayscale, the 3000 pixel is transparent
+png(sys.argv[1], 2, 3, 0, [
+    (5000,), (6000,),
+    (3000,), (4000,),
+    (1000,), (2000,)
+], (3000,))
+
+# Color type 2, RGB, the {4000, 5000, 6000} pixel is transparent
+png(sys.argv[2], 2, 3, 2, [
+    (5000, 6000, 7000), (6000, 7000, 8000),
+    (3000, 4000, 5000), (4000, 5000, 6000),
+    (1000, 2000, 3000), (2000, 3000, 4000)
+], (4000, 5000, 6000))
@@ -0,0 +1,206 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "QoiImageConverter.h"
+
+#include <cstring>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+
+#include "MagnumPlugins/QoiImporter/QoiHeader.h"
+
+namespace Magnum { namespace Trade {
+
+using namespace Containers::Literals;
+
+namespace {
+
+/* Encodes the pixels after the header, returns pointer to the end of the
+   written data */
+template<std::size_t channelCount> UnsignedByte* encode(const Containers::StridedArrayView3D<const char>& pixels, UnsignedByte* out) {
+    using namespace Implementation;
+
+    Vector4ub index[64]{};
+    Vector4ub previous{0, 0, 0, 255};
+    Vector4ub pixel = previous;
+    UnsignedInt run = 0;
+    const std::size_t height = pixels.size()[0];
+    const std::size_t width = pixels.size()[1];
+    for(std::size_t y = 0; y != height; ++y) {
+        /* Write rows in reverse order, as the file is stored top-down. While
+           the rows may have some padding after, the actual pixels in the row
+           are contiguous. */
+        const UnsignedByte* row = static_cast<const UnsignedByte*>(pixels[height - y - 1].data());
+        for(std::size_t x = 0; x != width; ++x, row += channelCount) {
+            /* For RGB images the alpha stays at 255 */
+            std::memcpy(pixel.data(), row, channelCount);
+
+            if(pixel == previous) {
+                ++run;
+                if(run == QoiMaxRun || (y == height - 1 && x == width - 1)) {
+                    *out++ = QoiOpRun|(run - 1);
+                    run = 0;
+                }
+                continue;
+            }
+
+            if(run) {
+                *out++ = QoiOpRun|(run - 1);
+                run = 0;
+            }
+
+            const UnsignedInt hash = qoiHash(pixel);
+            if(index[hash] == pixel) {
+                *out++ = QoiOpIndex|hash;
+            } else {
+                index[hash] = pixel;
+
+                if(pixel.w() == previous.w()) {
+                    /* Differences with wraparound */
+                    const Int red = Byte(pixel.x() - previous.x());
+                    const Int green = Byte(pixel.y() - previous.y());
+                    const Int blue = Byte(pixel.z() - previous.z());
+                    const Int redGreen = red - green;
+                    const Int blueGreen = blue - green;
+
+                    if(red >= -2 && red <= 1 &&
+                       green >= -2 && green <= 1 &&
+                       blue >= -2 && blue <= 1) {
+                        *out++ = QoiOpDiff|(red + 2) << 4|(green + 2) << 2|(blue + 2);
+                    } else if(redGreen >= -8 && redGreen <= 7 &&
+                              green >= -32 && green <= 31 &&
+                              blueGreen >= -8 && blueGreen <= 7) {
+                        *out++ = QoiOpLuma|(green + 32);
+                        *out++ = (redGreen + 8) << 4|(blueGreen + 8);
+                    } else {
+                        *out++ = QoiOpRgb;
+                        *out++ = pixel.x();
+                        *out++ = pixel.y();
+                        *out++ = pixel.z();
+                    }
+                } else {
+                    *out++ = QoiOpRgba;
+                    *out++ = pixel.x();
+                    *out++ = pixel.y();
+                    *out++ = pixel.z();
+                    *out++ = pixel.w();
+                }
+            }
+
+            previous = pixel;
+        }
+    }
+
+    return out;
+}
+
+}
+
+QoiImageConverter::QoiImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter{manager, plugin} {}
+
+ImageConverterFeatures QoiImageConverter::doFeatures() const { return ImageConverterFeature::Convert2DToData; }
+
+Containers::String QoiImageConverter::doExtension() const { return "qoi"_s; }
+
+Containers::String QoiImageConverter::doMimeType() const {
+    return "image/qoi"_s;
+}
+
+Containers::Optional<Containers::Array<char>> QoiImageConverter::doConvertToData(const ImageView2D& image) {
+    using namespace Implementation;
+
+    UnsignedByte channelCount;
+    UnsignedByte colorspace;
+    switch(image.format()) {
+        case PixelFormat::RGB8Unorm:
+            channelCount = 3;
+            colorspace = QoiColorspaceLinear;
+            break;
+        case PixelFormat::RGB8Srgb:
+            channelCount = 3;
+            colorspace = QoiColorspaceSrgb;
+            break;
+        case PixelFormat::RGBA8Unorm:
+            channelCount = 4;
+            colorspace = QoiColorspaceLinear;
+            break;
+        case PixelFormat::RGBA8Srgb:
+            channelCount = 4;
+            colorspace = QoiColorspaceSrgb;
+            break;
+        default:
+            Error{} << "Trade::QoiImageConverter::convertToData(): unsupported pixel format" << image.format();
+            return {};
+    }
+
+    if(!image.size().product()) {
+        Error{} << "Trade::QoiImageConverter::convertToData(): can't encode an image with zero size";
+        return {};
+    }
+
+    /* Warn about lost metadata */
+    if((image.flags() & ImageFlag2D::Array) && !(flags() & ImageConverterFlag::Quiet)) {
+        Warning{} << "Trade::QoiImageConverter::convertToData(): 1D array images are unrepresentable in QOI, saving as a regular 2D image";
+    }
+
+    /* Allocate for the worst case where every pixel is a QoiOpRgb or
+       QoiOpRgba, and copy to an exactly-sized array after. That's a lot
+       cheaper than growing the output while encoding. */
+    Containers::Array<char> data{NoInit, QoiHeaderSize + std::size_t(image.size().product())*(channelCount + 1) + QoiEndMarkerSize};
+
+    /* Header */
+    const Containers::StridedArrayView3D<const char> pixels = image.pixels();
+    CORRADE_INTERNAL_ASSERT(pixels.isContiguous<1>());
+    std::memcpy(data.data(), "qoif", 4);
+    const UnsignedInt width = Utility::Endianness::bigEndian(UnsignedInt(image.size().x()));
+    const UnsignedInt height = Utility::Endianness::bigEndian(UnsignedInt(image.size().y()));
+    std::memcpy(data.data() + QoiHeaderWidthOffset, &width, 4);
+    std::memcpy(data.data() + QoiHeaderHeightOffset, &height, 4);
+    data[QoiHeaderChannelsOffset] = channelCount;
+    data[QoiHeaderColorspaceOffset] = colorspace;
+
+    /* Pixel data and the end marker */
+    UnsignedByte* const begin = reinterpret_cast<UnsignedByte*>(data.data() + QoiHeaderSize);
+    UnsignedByte* const end = channelCount == 3 ?
+        encode<3>(pixels, begin) :
+        encode<4>(pixels, begin);
+    std::memcpy(end, "\0\0\0\0\0\0\0\x01", QoiEndMarkerSize);
+
+    Containers::Array<char> out{NoInit, QoiHeaderSize + std::size_t(end - begin) + QoiEndMarkerSize};
+    Utility::copy(data.prefix(out.size()), out);
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(QoiImageConverter, Magnum::Trade::QoiImageConverter,
+    MAGNUM_TRADE_ABSTRACTIMAGECONVERTER_PLUGIN_INTERFACE)
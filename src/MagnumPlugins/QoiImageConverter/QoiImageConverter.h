@@ -0,0 +1,136 @@
+#ifndef Magnum_Trade_QoiImageConverter_h
+#define Magnum_Trade_QoiImageConverter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Trade::QoiImageConverter
+ * @m_since_latest_{plugins}
+ */
+
+#include <Magnum/Trade/AbstractImageConverter.h>
+
+#include "MagnumPlugins/QoiImageConverter/configure.h"
+
+#ifndef DOXYGEN_GENERATING_OUTPUT
+#ifndef MAGNUM_QOIIMAGECONVERTER_BUILD_STATIC
+    #ifdef QoiImageConverter_EXPORTS
+        #define MAGNUM_QOIIMAGECONVERTER_EXPORT CORRADE_VISIBILITY_EXPORT
+    #else
+        #define MAGNUM_QOIIMAGECONVERTER_EXPORT CORRADE_VISIBILITY_IMPORT
+    #endif
+#else
+    #define MAGNUM_QOIIMAGECONVERTER_EXPORT CORRADE_VISIBILITY_STATIC
+#endif
+#define MAGNUM_QOIIMAGECONVERTER_LOCAL CORRADE_VISIBILITY_LOCAL
+#else
+#define MAGNUM_QOIIMAGECONVERTER_EXPORT
+#define MAGNUM_QOIIMAGECONVERTER_LOCAL
+#endif
+
+namespace Magnum { namespace Trade {
+
+/**
+@brief QOI image converter plugin
+@m_since_latest_{plugins}
+
+Creates Quite OK Image Format (`*.qoi`) files. The format is lossless like
+PNG, with comparable file sizes for typical images, but encoding is an order
+of magnitude faster. You can use @ref QoiImporter to import images in this
+format.
+
+@section Trade-QoiImageConverter-usage Usage
+
+@m_class{m-note m-success}
+
+@par
+    This class is a plugin that's meant to be dynamically loaded and used
+    via the base @ref AbstractImageConverter interface. See its documentation
+    for introduction and usage examples.
+
+This plugin depends on the @ref Trade library and is built if
+`MAGNUM_WITH_QOIIMAGECONVERTER` is enabled when building Magnum Plugins. To use
+as a dynamic plugin, load @cpp "QoiImageConverter" @ce via
+@ref Corrade::PluginManager::Manager.
+
+Additionally, if you're using Magnum as a CMake subproject, bundle the
+[magnum-plugins repository](https://github.com/mosra/magnum-plugins) and do the
+following:
+
+@code{.cmake}
+set(MAGNUM_WITH_QOIIMAGECONVERTER ON CACHE BOOL "" FORCE)
+add_subdirectory(magnum-plugins EXCLUDE_FROM_ALL)
+
+# So the dynamically loaded plugin gets built implicitly
+add_dependencies(your-app MagnumPlugins::QoiImageConverter)
+@endcode
+
+To use as a static plugin or as a dependency of another plugin with CMake, put
+[FindMagnumPlugins.cmake](https://github.com/mosra/magnum-plugins/blob/master/modules/FindMagnumPlugins.cmake)
+into your `modules/` directory, request the `QoiImageConverter` component
+of the `MagnumPlugins` package and link to the
+`MagnumPlugins::QoiImageConverter` target:
+
+@code{.cmake}
+find_package(MagnumPlugins REQUIRED QoiImageConverter)
+
+# ...
+target_link_libraries(your-app PRIVATE MagnumPlugins::QoiImageConverter)
+@endcode
+
+See @ref building-plugins, @ref cmake-plugins, @ref plugins and
+@ref file-formats for more information.
+
+@section Trade-QoiImageConverter-behavior Behavior and limitations
+
+Accepts 2D images in @ref PixelFormat::RGB8Unorm, @ref PixelFormat::RGB8Srgb,
+@ref PixelFormat::RGBA8Unorm and @ref PixelFormat::RGBA8Srgb. The colorspace
+field in the file header is set to linear for the `*Unorm` formats and to sRGB
+for the `*Srgb` formats. Empty images can't be represented in the format and
+are rejected.
+
+The QOI file format doesn't have a way to distinguish between 2D and 1D array
+images. If an image has @ref ImageFlag2D::Array set, a warning is printed and
+the file is saved as a regular 2D image.
+
+The plugin recognizes @ref ImageConverterFlag::Quiet, which will cause all
+conversion warnings to be suppressed.
+*/
+class MAGNUM_QOIIMAGECONVERTER_EXPORT QoiImageConverter: public AbstractImageConverter {
+    public:
+        /** @brief Plugin manager constructor */
+        explicit QoiImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
+
+    private:
+        MAGNUM_QOIIMAGECONVERTER_LOCAL ImageConverterFeatures doFeatures() const override;
+        MAGNUM_QOIIMAGECONVERTER_LOCAL Containers::String doExtension() const override;
+        MAGNUM_QOIIMAGECONVERTER_LOCAL Containers::String doMimeType() const override;
+
+        MAGNUM_QOIIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(const ImageView2D& image) override;
+};
+
+}}
+
+#endif
@@ -0,0 +1,262 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct QoiImageConverterTest: TestSuite::Tester {
+    explicit QoiImageConverterTest();
+
+    void wrongFormat();
+    void zeroSize();
+
+    void rgba();
+    void header();
+    void longRun();
+
+    void roundtrip();
+
+    void unsupportedMetadata();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
+    PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
+};
+
+using namespace Containers::Literals;
+
+const struct {
+    const char* name;
+    PixelFormat format;
+    char expectedChannelCount, expectedColorspace;
+} FormatData[]{
+    {"RGB8Unorm", PixelFormat::RGB8Unorm, 3, 1},
+    {"RGB8Srgb", PixelFormat::RGB8Srgb, 3, 0},
+    {"RGBA8Unorm", PixelFormat::RGBA8Unorm, 4, 1},
+    {"RGBA8Srgb", PixelFormat::RGBA8Srgb, 4, 0},
+};
+
+const struct {
+    const char* name;
+    ImageConverterFlags converterFlags;
+    ImageFlags2D imageFlags;
+    const char* message;
+} UnsupportedMetadataData[]{
+    {"1D array", {}, ImageFlag2D::Array,
+        "1D array images are unrepresentable in QOI, saving as a regular 2D image"},
+    {"1D array, quiet", ImageConverterFlag::Quiet, ImageFlag2D::Array,
+        nullptr},
+};
+
+/* Bottom row first, as in Magnum */
+constexpr Color4ub RgbaData[]{
+    {100, 150, 200, 128}, {10, 20, 30, 255}, {10, 20, 30, 255},
+    {10, 20, 30, 255}, {11, 19, 30, 255}, {18, 29, 42, 255}
+};
+
+/* With the default four-byte alignment, each row is padded to 12 bytes */
+constexpr Color3ub RgbData[]{
+    {100, 150, 200}, {10, 20, 30}, {10, 20, 30}, {},
+    {10, 20, 30}, {11, 19, 30}, {18, 29, 42}, {}
+};
+
+/* Same as AllOpcodes in QoiImporterTest, see there for details */
+constexpr Containers::StringView RgbaQoi =
+    "qoif" "\0\0\0\x03" "\0\0\0\x02" "\x04" "\x01"
+    "\xfe" "\x0a\x14\x1e"
+    "\x76"
+    "\xaa" "\x5a"
+    "\xff" "\x64\x96\xc8\x80"
+    "\x09"
+    "\xc0"
+    "\0\0\0\0\0\0\0\x01"_s;
+
+QoiImageConverterTest::QoiImageConverterTest() {
+    addTests({&QoiImageConverterTest::wrongFormat,
+              &QoiImageConverterTest::zeroSize,
+
+              &QoiImageConverterTest::rgba});
+
+    addInstancedTests({&QoiImageConverterTest::header},
+        Containers::arraySize(FormatData));
+
+    addTests({&QoiImageConverterTest::longRun});
+
+    addInstancedTests({&QoiImageConverterTest::roundtrip},
+        Containers::arraySize(FormatData));
+
+    addInstancedTests({&QoiImageConverterTest::unsupportedMetadata},
+        Containers::arraySize(UnsupportedMetadataData));
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef QOIIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(QOIIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* The QoiImporter is optional */
+    #ifdef QOIIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(QOIIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void QoiImageConverterTest::wrongFormat() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("QoiImageConverter");
+
+    const char data[4]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RG16Unorm, {1, 1}, data}));
+    CORRADE_COMPARE(out.str(), "Trade::QoiImageConverter::convertToData(): unsupported pixel format PixelFormat::RG16Unorm\n");
+}
+
+void QoiImageConverterTest::zeroSize() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("QoiImageConverter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {4, 0}, nullptr}));
+    CORRADE_COMPARE(out.str(), "Trade::QoiImageConverter::convertToData(): can't encode an image with zero size\n");
+}
+
+void QoiImageConverterTest::rgba() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("QoiImageConverter");
+    CORRADE_COMPARE(converter->extension(), "qoi");
+    CORRADE_COMPARE(converter->mimeType(), "image/qoi");
+
+    /* The output should be exactly the same as the reference encoder gives,
+       going through all opcodes */
+    Containers::Optional<Containers::Array<char>> data = converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {3, 2}, RgbaData});
+    CORRADE_VERIFY(data);
+    CORRADE_COMPARE(Containers::StringView{*data}, RgbaQoi);
+}
+
+void QoiImageConverterTest::header() {
+    auto&& data = FormatData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("QoiImageConverter");
+
+    const char imageData[4*2]{};
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(ImageView2D{PixelStorage{}.setAlignment(1), data.format, {2, 1}, imageData});
+    CORRADE_VERIFY(out);
+    CORRADE_VERIFY(out->size() >= 14);
+    CORRADE_COMPARE(Containers::StringView{out->prefix(12)},
+        "qoif" "\0\0\0\x02" "\0\0\0\x01"_s);
+    CORRADE_COMPARE(Int((*out)[12]), Int(data.expectedChannelCount));
+    CORRADE_COMPARE(Int((*out)[13]), Int(data.expectedColorspace));
+}
+
+void QoiImageConverterTest::longRun() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("QoiImageConverter");
+
+    /* All pixels are the same as the initial {0, 0, 0, 255}, so it's just
+       runs. The longest run is 62 pixels, which means the 100 pixels get
+       split into a 62- and a 38-pixel run, the latter flushed at the end of
+       the image. */
+    Color3ub imageData[50*2];
+    for(Color3ub& i: imageData) i = {0, 0, 0};
+    Containers::Optional<Containers::Array<char>> data = converter->convertToData(ImageView2D{PixelStorage{}.setAlignment(1), PixelFormat::RGB8Unorm, {50, 2}, imageData});
+    CORRADE_VERIFY(data);
+    CORRADE_COMPARE(Containers::StringView{*data},
+        "qoif" "\0\0\0\x32" "\0\0\0\x02" "\x03" "\x01"
+        "\xfd" "\xe5"
+        "\0\0\0\0\0\0\0\x01"_s);
+}
+
+void QoiImageConverterTest::roundtrip() {
+    auto&& data = FormatData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("QoiImageConverter");
+
+    const bool rgb = data.expectedChannelCount == 3;
+    const ImageView2D image = rgb ?
+        ImageView2D{data.format, {3, 2}, RgbData} :
+        ImageView2D{data.format, {3, 2}, RgbaData};
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(image);
+    CORRADE_VERIFY(out);
+
+    if(_importerManager.loadState("QoiImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("QoiImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("QoiImporter");
+    CORRADE_VERIFY(importer->openData(*out));
+    Containers::Optional<ImageData2D> imported = importer->image2D(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE(imported->format(), data.format);
+    if(rgb) {
+        Color3ub expected[]{
+            RgbData[0], RgbData[1], RgbData[2],
+            RgbData[4], RgbData[5], RgbData[6]
+        };
+        CORRADE_COMPARE_AS(imported->pixels<Color3ub>().asContiguous(),
+            Containers::arrayView(expected),
+            TestSuite::Compare::Container);
+    } else {
+        CORRADE_COMPARE_AS(imported->pixels<Color4ub>().asContiguous(),
+            Containers::arrayView(RgbaData),
+            TestSuite::Compare::Container);
+    }
+}
+
+void QoiImageConverterTest::unsupportedMetadata() {
+    auto&& data = UnsupportedMetadataData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("QoiImageConverter");
+    converter->addFlags(data.converterFlags);
+
+    const char imageData[4]{};
+    ImageView2D image{PixelFormat::RGBA8Unorm, {1, 1}, imageData, data.imageFlags};
+
+    std::ostringstream out;
+    Warning redirectWarning{&out};
+    CORRADE_VERIFY(converter->convertToData(image));
+    if(!data.message)
+        CORRADE_COMPARE(out.str(), "");
+    else
+        CORRADE_COMPARE(out.str(), Utility::formatString("Trade::QoiImageConverter::convertToData(): {}\n", data.message));
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::QoiImageConverterTest)
@@ -0,0 +1,75 @@
+#ifndef Magnum_Trade_QoiHeader_h
+#define Magnum_Trade_QoiHeader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector4.h>
+
+/* Used by both QoiImporter and QoiImageConverter, which is why it isn't
+   directly inside QoiImporter.cpp. OTOH it doesn't need to be exposed
+   publicly, which is why it has no docblocks. The format is described in
+   https://qoiformat.org/qoi-specification.pdf. */
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+/* The header is 14 bytes, which would get padded to 16 as a struct, so it's
+   read and written field-by-field. Width and height are big-endian. */
+enum: std::size_t {
+    QoiHeaderSize = 14,
+    QoiHeaderWidthOffset = 4,
+    QoiHeaderHeightOffset = 8,
+    QoiHeaderChannelsOffset = 12,
+    QoiHeaderColorspaceOffset = 13,
+    /* Seven zero bytes and a one */
+    QoiEndMarkerSize = 8
+};
+
+enum: UnsignedByte {
+    QoiColorspaceSrgb = 0,
+    QoiColorspaceLinear = 1
+};
+
+/* The 8-bit tags take precedence over the 2-bit ones */
+enum: UnsignedByte {
+    QoiOpIndex = 0x00,
+    QoiOpDiff = 0x40,
+    QoiOpLuma = 0x80,
+    QoiOpRun = 0xc0,
+    QoiOpRgb = 0xfe,
+    QoiOpRgba = 0xff,
+    QoiOpMask = 0xc0
+};
+
+/* Longest run a QoiOpRun can encode, as 63 and 64 would collide with
+   QoiOpRgb and QoiOpRgba */
+constexpr UnsignedInt QoiMaxRun = 62;
+
+inline UnsignedInt qoiHash(const Vector4ub& pixel) {
+    return (pixel.x()*3 + pixel.y()*5 + pixel.z()*7 + pixel.w()*11) % 64;
+}
+
+}}}
+
+#endif
@@ -0,0 +1,219 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "QoiImporter.h"
+
+#include <cstring>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "MagnumPlugins/QoiImporter/QoiHeader.h"
+
+namespace Magnum { namespace Trade {
+
+using namespace Containers::Literals;
+
+namespace {
+
+/* Decodes the pixel stream following the header. Returns false if the data
+   end prematurely. */
+template<std::size_t channelCount> bool decode(const Containers::ArrayView<const UnsignedByte> in, const Vector2i& size, char* const out) {
+    using namespace Implementation;
+
+    Vector4ub index[64]{};
+    Vector4ub pixel{0, 0, 0, 255};
+    UnsignedInt run = 0;
+    std::size_t i = 0;
+    const std::size_t rowSize = size.x()*channelCount;
+    for(Int y = 0; y != size.y(); ++y) {
+        /* Rows are stored top-down in the file, Y up in the output */
+        char* row = out + (size.y() - y - 1)*rowSize;
+        for(Int x = 0; x != size.x(); ++x, row += channelCount) {
+            if(run) {
+                --run;
+            } else {
+                if(i >= in.size()) return false;
+                const UnsignedByte op = in[i++];
+                if(op == QoiOpRgb) {
+                    if(i + 3 > in.size()) return false;
+                    pixel.x() = in[i + 0];
+                    pixel.y() = in[i + 1];
+                    pixel.z() = in[i + 2];
+                    i += 3;
+                } else if(op == QoiOpRgba) {
+                    if(i + 4 > in.size()) return false;
+                    pixel = {in[i + 0], in[i + 1], in[i + 2], in[i + 3]};
+                    i += 4;
+                } else switch(op & QoiOpMask) {
+                    case QoiOpIndex:
+                        pixel = index[op];
+                        break;
+                    case QoiOpDiff:
+                        pixel.x() = UnsignedByte(pixel.x() + ((op >> 4) & 0x03) - 2);
+                        pixel.y() = UnsignedByte(pixel.y() + ((op >> 2) & 0x03) - 2);
+                        pixel.z() = UnsignedByte(pixel.z() + (op & 0x03) - 2);
+                        break;
+                    case QoiOpLuma: {
+                        if(i >= in.size()) return false;
+                        const UnsignedByte redBlue = in[i++];
+                        const Int green = (op & 0x3f) - 32;
+                        pixel.x() = UnsignedByte(pixel.x() + green - 8 + (redBlue >> 4));
+                        pixel.y() = UnsignedByte(pixel.y() + green);
+                        pixel.z() = UnsignedByte(pixel.z() + green - 8 + (redBlue & 0x0f));
+                    } break;
+                    case QoiOpRun:
+                        /* This pixel is the first of the run */
+                        run = op & 0x3f;
+                        break;
+                }
+
+                index[qoiHash(pixel)] = pixel;
+            }
+
+            std::memcpy(row, pixel.data(), channelCount);
+        }
+    }
+
+    return true;
+}
+
+}
+
+struct QoiImporter::State {
+    Vector2i size;
+    PixelFormat format;
+    Containers::Array<char> data;
+};
+
+QoiImporter::QoiImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
+
+QoiImporter::~QoiImporter() = default;
+
+ImporterFeatures QoiImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool QoiImporter::doIsOpened() const { return !!_state; }
+
+void QoiImporter::doClose() { _state = nullptr; }
+
+void QoiImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    using namespace Implementation;
+
+    /* There should be at least the header and the end marker */
+    if(data.size() < QoiHeaderSize + QoiEndMarkerSize) {
+        Error{} << "Trade::QoiImporter::openData(): file too short, expected at least" << QoiHeaderSize + QoiEndMarkerSize << "bytes but got" << data.size();
+        return;
+    }
+
+    const Containers::StringView signature{data.data(), 4};
+    if(signature != "qoif"_s) {
+        Error{} << "Trade::QoiImporter::openData(): invalid file signature" << signature;
+        return;
+    }
+
+    const UnsignedByte channelCount = data[QoiHeaderChannelsOffset];
+    const UnsignedByte colorspace = data[QoiHeaderColorspaceOffset];
+    PixelFormat format;
+    if(channelCount == 3 && colorspace == QoiColorspaceSrgb)
+        format = PixelFormat::RGB8Srgb;
+    else if(channelCount == 3 && colorspace == QoiColorspaceLinear)
+        format = PixelFormat::RGB8Unorm;
+    else if(channelCount == 4 && colorspace == QoiColorspaceSrgb)
+        format = PixelFormat::RGBA8Srgb;
+    else if(channelCount == 4 && colorspace == QoiColorspaceLinear)
+        format = PixelFormat::RGBA8Unorm;
+    else if(channelCount != 3 && channelCount != 4) {
+        Error{} << "Trade::QoiImporter::openData(): invalid channel count" << channelCount;
+        return;
+    } else {
+        Error{} << "Trade::QoiImporter::openData(): invalid colorspace" << colorspace;
+        return;
+    }
+
+    UnsignedInt width, height;
+    std::memcpy(&width, data.data() + QoiHeaderWidthOffset, 4);
+    std::memcpy(&height, data.data() + QoiHeaderHeightOffset, 4);
+    Utility::Endianness::bigEndianInPlace(width, height);
+    if(!width || !height || width > 0x7fffffffu || height > 0x7fffffffu) {
+        Error{} << "Trade::QoiImporter::openData(): invalid image size" << Debug::packed << Vector2ui{width, height};
+        return;
+    }
+
+    /* A single byte can encode at most a run of QoiMaxRun pixels. Checking
+       this prevents a small corrupted file from causing a huge allocation in
+       image2D(). */
+    if(std::size_t(width)*height > (data.size() - QoiHeaderSize - QoiEndMarkerSize)*QoiMaxRun) {
+        Error{} << "Trade::QoiImporter::openData(): file too short for a" << Debug::packed << Vector2ui{width, height} << "image";
+        return;
+    }
+
+    /* All good now, let's save everything */
+    _state.emplace();
+    _state->size = Vector2i{Vector2ui{width, height}};
+    _state->format = format;
+
+    /* Take over the existing array or copy the data if we can't */
+    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
+        _state->data = Utility::move(data);
+    } else {
+        _state->data = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, _state->data);
+    }
+}
+
+UnsignedInt QoiImporter::doImage2DCount() const { return 1; }
+
+Containers::Optional<ImageData2D> QoiImporter::doImage2D(UnsignedInt, UnsignedInt) {
+    const UnsignedInt channelCount = pixelFormatSize(_state->format);
+
+    /* Rows of RGB images are not four-byte aligned in general, decode them
+       tightly packed instead of having to deal with padding */
+    PixelStorage storage;
+    if((_state->size.x()*channelCount) % 4 != 0)
+        storage.setAlignment(1);
+
+    Containers::Array<char> out{NoInit, std::size_t(_state->size.product())*channelCount};
+    /* The end marker isn't treated as a part of the pixel stream, same as in
+       the reference implementation */
+    const Containers::ArrayView<const UnsignedByte> in = Containers::arrayCast<const UnsignedByte>(_state->data.slice(Implementation::QoiHeaderSize, _state->data.size() - Implementation::QoiEndMarkerSize));
+    if(!(channelCount == 3 ?
+        decode<3>(in, _state->size, out) :
+        decode<4>(in, _state->size, out)))
+    {
+        Error{} << "Trade::QoiImporter::image2D(): file too short";
+        return {};
+    }
+
+    return ImageData2D{storage, _state->format, _state->size, Utility::move(out)};
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(QoiImporter, Magnum::Trade::QoiImporter,
+    MAGNUM_TRADE_ABSTRACTIMPORTER_PLUGIN_INTERFACE)
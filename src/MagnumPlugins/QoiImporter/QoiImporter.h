@@ -0,0 +1,142 @@
+#ifndef Magnum_Trade_QoiImporter_h
+#define Magnum_Trade_QoiImporter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Trade::QoiImporter
+ * @m_since_latest_{plugins}
+ */
+
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+#include "MagnumPlugins/QoiImporter/configure.h"
+
+#ifndef DOXYGEN_GENERATING_OUTPUT
+#ifndef MAGNUM_QOIIMPORTER_BUILD_STATIC
+    #ifdef QoiImporter_EXPORTS
+        #define MAGNUM_QOIIMPORTER_EXPORT CORRADE_VISIBILITY_EXPORT
+    #else
+        #define MAGNUM_QOIIMPORTER_EXPORT CORRADE_VISIBILITY_IMPORT
+    #endif
+#else
+    #define MAGNUM_QOIIMPORTER_EXPORT CORRADE_VISIBILITY_STATIC
+#endif
+#define MAGNUM_QOIIMPORTER_LOCAL CORRADE_VISIBILITY_LOCAL
+#else
+#define MAGNUM_QOIIMPORTER_EXPORT
+#define MAGNUM_QOIIMPORTER_LOCAL
+#endif
+
+namespace Magnum { namespace Trade {
+
+/**
+@brief QOI importer plugin
+@m_since_latest_{plugins}
+
+Imports Quite OK Image Format (`*.qoi`) files. The format is lossless like
+PNG, but both encoding and decoding is many times faster, which makes it
+suitable for example for intermediate files in asset pipelines. You can use
+@ref QoiImageConverter to encode images into this format.
+
+@section Trade-QoiImporter-usage Usage
+
+@m_class{m-note m-success}
+
+@par
+    This class is a plugin that's meant to be dynamically loaded and used
+    through the base @ref AbstractImporter interface. See its documentation for
+    introduction and usage examples.
+
+This plugin depends on the @ref Trade library and is built if
+`MAGNUM_WITH_QOIIMPORTER` is enabled when building Magnum Plugins. To use as a
+dynamic plugin, load @cpp "QoiImporter" @ce via
+@ref Corrade::PluginManager::Manager.
+
+Additionally, if you're using Magnum as a CMake subproject, bundle the
+[magnum-plugins repository](https://github.com/mosra/magnum-plugins) and do the
+following:
+
+@code{.cmake}
+set(MAGNUM_WITH_QOIIMPORTER ON CACHE BOOL "" FORCE)
+add_subdirectory(magnum-plugins EXCLUDE_FROM_ALL)
+
+# So the dynamically loaded plugin gets built implicitly
+add_dependencies(your-app MagnumPlugins::QoiImporter)
+@endcode
+
+To use as a static plugin or as a dependency of another plugin with CMake, put
+[FindMagnumPlugins.cmake](https://github.com/mosra/magnum-plugins/blob/master/modules/FindMagnumPlugins.cmake)
+into your `modules/` directory, request the `QoiImporter` component of the
+`MagnumPlugins` package in CMake and link to the `MagnumPlugins::QoiImporter`
+target:
+
+@code{.cmake}
+find_package(MagnumPlugins REQUIRED QoiImporter)
+
+# ...
+target_link_libraries(your-app PRIVATE MagnumPlugins::QoiImporter)
+@endcode
+
+See @ref building-plugins, @ref cmake-plugins, @ref plugins and
+@ref file-formats for more information.
+
+@section Trade-QoiImporter-behavior Behavior and limitations
+
+Three-channel files are imported as @ref PixelFormat::RGB8Srgb or
+@ref PixelFormat::RGB8Unorm, four-channel files as
+@ref PixelFormat::RGBA8Srgb or @ref PixelFormat::RGBA8Unorm, depending on
+whether the colorspace field in the file header says sRGB or linear. Rows of
+RGB images that aren't four-byte aligned have @ref PixelStorage::alignment()
+set to @cpp 1 @ce.
+
+The file is only validated in @ref openData() and decoded on each
+@ref image2D() call. The format has no orientation metadata and stores rows
+top-down, the image is flipped on import to have Y up.
+*/
+class MAGNUM_QOIIMPORTER_EXPORT QoiImporter: public AbstractImporter {
+    public:
+        /** @brief Plugin manager constructor */
+        explicit QoiImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
+
+        ~QoiImporter();
+
+    private:
+        MAGNUM_QOIIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
+        MAGNUM_QOIIMPORTER_LOCAL bool doIsOpened() const override;
+        MAGNUM_QOIIMPORTER_LOCAL void doClose() override;
+        MAGNUM_QOIIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
+
+        MAGNUM_QOIIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
+        MAGNUM_QOIIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -0,0 +1,318 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+using namespace Containers::Literals;
+
+struct QoiImporterTest: TestSuite::Tester {
+    explicit QoiImporterTest();
+
+    void invalid();
+
+    void rgbRgba();
+    void runAcrossRows();
+    void fileTooShort();
+
+    void openMemory();
+    void openTwice();
+    void importTwice();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+};
+
+/* A 3x2 image going through all opcodes, in order:
+    - QOI_OP_RGB with {10, 20, 30}, alpha stays 255 from the initial pixel
+    - QOI_OP_DIFF with {+1, -1, 0}, giving {11, 19, 30, 255}
+    - QOI_OP_LUMA with green +10, red -3 and blue +2 relative to green,
+      giving {18, 29, 42, 255}
+    - QOI_OP_RGBA with {100, 150, 200, 128}
+    - QOI_OP_INDEX 9, which is the hash of {10, 20, 30, 255}
+    - QOI_OP_RUN of length 1
+   The channel count and colorspace bytes get replaced in the test. */
+constexpr Containers::StringView AllOpcodes =
+    "qoif" "\0\0\0\x03" "\0\0\0\x02" "\x04" "\x01"
+    "\xfe" "\x0a\x14\x1e"
+    "\x76"
+    "\xaa" "\x5a"
+    "\xff" "\x64\x96\xc8\x80"
+    "\x09"
+    "\xc0"
+    "\0\0\0\0\0\0\0\x01"_s;
+
+const struct {
+    const char* name;
+    Containers::StringView data;
+    const char* message;
+} InvalidData[]{
+    {"file too short",
+        "qoif" "\0\0\0\x01" "\0\0\0\x01" "\x04" "\x01" "\0\0\0\0\0\0\0"_s,
+        "file too short, expected at least 22 bytes but got 21"},
+    {"invalid signature",
+        "qoiF" "\0\0\0\x01" "\0\0\0\x01" "\x04" "\x01" "\0\0\0\0\0\0\0\x01"_s,
+        "invalid file signature qoiF"},
+    {"invalid channel count",
+        "qoif" "\0\0\0\x01" "\0\0\0\x01" "\x02" "\x01" "\0\0\0\0\0\0\0\x01"_s,
+        "invalid channel count 2"},
+    {"invalid colorspace",
+        "qoif" "\0\0\0\x01" "\0\0\0\x01" "\x03" "\x02" "\0\0\0\0\0\0\0\x01"_s,
+        "invalid colorspace 2"},
+    {"zero width",
+        "qoif" "\0\0\0\0" "\0\0\0\x02" "\x04" "\x01" "\0\0\0\0\0\0\0\x01"_s,
+        "invalid image size {0, 2}"},
+    {"width too large",
+        "qoif" "\x80\0\0\0" "\0\0\0\x02" "\x04" "\x01" "\0\0\0\0\0\0\0\x01"_s,
+        "invalid image size {2147483648, 2}"},
+    {"too many pixels for the file size",
+        "qoif" "\0\0\0\x3f" "\0\0\0\x01" "\x04" "\x01" "\xfe" "\0\0\0\0\0\0\0\x01"_s,
+        "file too short for a {63, 1} image"},
+};
+
+const struct {
+    const char* name;
+    char channelCount, colorspace;
+    PixelFormat expectedFormat;
+} RgbRgbaData[]{
+    {"RGB, sRGB", 3, 0, PixelFormat::RGB8Srgb},
+    {"RGB, linear", 3, 1, PixelFormat::RGB8Unorm},
+    {"RGBA, sRGB", 4, 0, PixelFormat::RGBA8Srgb},
+    {"RGBA, linear", 4, 1, PixelFormat::RGBA8Unorm},
+};
+
+const struct {
+    const char* name;
+    Containers::StringView data;
+} FileTooShortData[]{
+    {"missing pixels",
+        "qoif" "\0\0\0\x03" "\0\0\0\x02" "\x04" "\x01"
+        "\xfe" "\x0a\x14\x1e"
+        "\x76"
+        "\0\0\0\0\0\0\0\x01"_s},
+    {"incomplete QOI_OP_RGB",
+        "qoif" "\0\0\0\x03" "\0\0\0\x02" "\x04" "\x01"
+        "\xfe" "\x0a\x14"
+        "\0\0\0\0\0\0\0\x01"_s},
+    {"incomplete QOI_OP_RGBA",
+        "qoif" "\0\0\0\x03" "\0\0\0\x02" "\x04" "\x01"
+        "\xff" "\x0a\x14\x1e"
+        "\0\0\0\0\0\0\0\x01"_s},
+    {"incomplete QOI_OP_LUMA",
+        "qoif" "\0\0\0\x03" "\0\0\0\x02" "\x04" "\x01"
+        "\xaa"
+        "\0\0\0\0\0\0\0\x01"_s},
+};
+
+/* Shared among all plugins that implement data copying optimizations */
+const struct {
+    const char* name;
+    bool(*open)(AbstractImporter&, Containers::ArrayView<const void>);
+} OpenMemoryData[]{
+    {"data", [](AbstractImporter& importer, Containers::ArrayView<const void> data) {
+        /* Copy to ensure the original memory isn't referenced */
+        Containers::Array<char> copy{NoInit, data.size()};
+        Utility::copy(Containers::arrayCast<const char>(data), copy);
+        return importer.openData(copy);
+    }},
+    {"memory", [](AbstractImporter& importer, Containers::ArrayView<const void> data) {
+        return importer.openMemory(data);
+    }},
+};
+
+QoiImporterTest::QoiImporterTest() {
+    addInstancedTests({&QoiImporterTest::invalid},
+        Containers::arraySize(InvalidData));
+
+    addInstancedTests({&QoiImporterTest::rgbRgba},
+        Containers::arraySize(RgbRgbaData));
+
+    addTests({&QoiImporterTest::runAcrossRows});
+
+    addInstancedTests({&QoiImporterTest::fileTooShort},
+        Containers::arraySize(FileTooShortData));
+
+    addInstancedTests({&QoiImporterTest::openMemory},
+        Containers::arraySize(OpenMemoryData));
+
+    addTests({&QoiImporterTest::openTwice,
+              &QoiImporterTest::importTwice});
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef QOIIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(QOIIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void QoiImporterTest::invalid() {
+    auto&& data = InvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("QoiImporter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openData(data.data));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::QoiImporter::openData(): {}\n", data.message));
+}
+
+void QoiImporterTest::rgbRgba() {
+    auto&& data = RgbRgbaData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Array<char> file{NoInit, AllOpcodes.size()};
+    Utility::copy(Containers::ArrayView<const char>{AllOpcodes}, file);
+    file[12] = data.channelCount;
+    file[13] = data.colorspace;
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("QoiImporter");
+    CORRADE_VERIFY(importer->openData(file));
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+
+    Containers::Optional<ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(!image->isCompressed());
+    CORRADE_COMPARE(image->flags(), ImageFlags2D{});
+    CORRADE_COMPARE(image->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE(image->format(), data.expectedFormat);
+
+    /* The file is top-down, the image is Y up */
+    const Color4ub expected[]{
+        {100, 150, 200, 128}, {10, 20, 30, 255}, {10, 20, 30, 255},
+        {10, 20, 30, 255}, {11, 19, 30, 255}, {18, 29, 42, 255}
+    };
+    if(data.channelCount == 4) {
+        CORRADE_COMPARE(image->storage().alignment(), 4);
+        CORRADE_COMPARE_AS(image->pixels<Color4ub>().asContiguous(),
+            Containers::arrayView(expected),
+            TestSuite::Compare::Container);
+    } else {
+        /* Rows are 9 bytes, so they're not four-byte aligned */
+        CORRADE_COMPARE(image->storage().alignment(), 1);
+        Color3ub expectedRgb[Containers::arraySize(expected)];
+        for(std::size_t i = 0; i != Containers::arraySize(expected); ++i)
+            expectedRgb[i] = expected[i].rgb();
+        CORRADE_COMPARE_AS(image->pixels<Color3ub>().asContiguous(),
+            Containers::arrayView(expectedRgb),
+            TestSuite::Compare::Container);
+    }
+}
+
+void QoiImporterTest::runAcrossRows() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("QoiImporter");
+    /* A QOI_OP_RGB followed by a run of the same pixel, spanning both rows */
+    CORRADE_VERIFY(importer->openData(
+        "qoif" "\0\0\0\x02" "\0\0\0\x02" "\x04" "\x01"
+        "\xfe" "\x0a\x14\x1e"
+        "\xc2"
+        "\0\0\0\0\0\0\0\x01"_s));
+
+    Containers::Optional<ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Vector2i{2, 2}));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image->pixels<Color4ub>().asContiguous(), Containers::arrayView<Color4ub>({
+        {10, 20, 30, 255}, {10, 20, 30, 255},
+        {10, 20, 30, 255}, {10, 20, 30, 255}
+    }), TestSuite::Compare::Container);
+}
+
+void QoiImporterTest::fileTooShort() {
+    auto&& data = FileTooShortData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("QoiImporter");
+    CORRADE_VERIFY(importer->openData(data.data));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), "Trade::QoiImporter::image2D(): file too short\n");
+}
+
+void QoiImporterTest::openMemory() {
+    /* same as (a subset of) rgbRgba() except that it uses openData() &
+       openMemory() instead of openFile() to test data copying on import */
+
+    auto&& data = OpenMemoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("QoiImporter");
+    CORRADE_VERIFY(data.open(*importer, AllOpcodes));
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(image->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE(image->pixels<Color4ub>()[1][2], (Color4ub{18, 29, 42, 255}));
+}
+
+void QoiImporterTest::openTwice() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("QoiImporter");
+
+    CORRADE_VERIFY(importer->openData(AllOpcodes));
+    CORRADE_VERIFY(importer->openData(AllOpcodes));
+
+    /* Shouldn't crash, leak or anything */
+}
+
+void QoiImporterTest::importTwice() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("QoiImporter");
+    CORRADE_VERIFY(importer->openData(AllOpcodes));
+
+    /* Verify that everything is working the same way on second use */
+    {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), (Vector2i{3, 2}));
+        CORRADE_COMPARE(image->pixels<Color4ub>()[0][0], (Color4ub{100, 150, 200, 128}));
+    } {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), (Vector2i{3, 2}));
+        CORRADE_COMPARE(image->pixels<Color4ub>()[0][0], (Color4ub{100, 150, 200, 128}));
+    }
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::QoiImporterTest)
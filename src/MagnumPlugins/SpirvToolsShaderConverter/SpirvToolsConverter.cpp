@@ -25,18 +25,24 @@
 
 #include "SpirvToolsConverter.h"
 
+#include <chrono>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
 
 #include "spirv-tools/libspirv.h"
 /* Unfortunately the C optimizer interface is so minimal that it's useless. No
    way to set any optimization preset, even. */
 #include "spirv-tools/optimizer.hpp"
+#include "spirv-tools/linker.hpp"
 #include "MagnumPlugins/SpirvToolsShaderConverter/configureInternal.h"
 
 namespace Magnum { namespace ShaderTools {
@@ -49,6 +55,8 @@ struct SpirvToolsConverter::State {
     Containers::String inputVersion, outputVersion;
 
     Containers::String inputFilename, outputFilename;
+    /* Set only by the doLinkFilesTo*() intercepts */
+    Containers::Array<Containers::String> linkInputFilenames;
 
     Containers::String optimizationLevel;
 };
@@ -78,9 +86,9 @@ SpirvToolsConverter::SpirvToolsConverter(PluginManager::AbstractManager& manager
     maybe? */
 
 ConverterFeatures SpirvToolsConverter::doFeatures() const {
-    return ConverterFeature::ValidateData|ConverterFeature::ConvertData|ConverterFeature::Optimize|
+    return ConverterFeature::ValidateData|ConverterFeature::ConvertData|ConverterFeature::LinkData|ConverterFeature::Optimize|
         /* We actually don't, but without this set the doValidateFile() /
-           doConvertFileTo*() intercepts don't get called when the input is
+           doConvertFileTo*() / doLinkFilesTo*() intercepts don't get called when the input is
            specified through callbacks. And since we delegate to the base
            implementation, the callbacks *do* work. */
         ConverterFeature::InputFileCallback;
@@ -208,6 +216,300 @@ void setValidationOptions(spv_validator_options& options, const Utility::Configu
     #endif
 }
 
+/* Prints optimizer and linker messages using our own APIs. The operation is
+   either "optimization" or "link". */
+spvtools::MessageConsumer messageConsumer(const char* const prefix, const char* const operation) {
+    return [prefix, operation](spv_message_level_t level, const char* file, const spv_position_t& position, const char* message) {
+        std::ostream* output{};
+        const char* severity{};
+        const char* type{};
+        switch(level) {
+            /* LCOV_EXCL_START */
+            case SPV_MSG_FATAL:
+                output = Error::output();
+                severity = "fatal";
+                type = "error:";
+                break;
+            case SPV_MSG_INTERNAL_ERROR:
+                output = Error::output();
+                severity = "internal";
+                type = "error:";
+                break;
+            case SPV_MSG_ERROR:
+                output = Error::output();
+                type = "error:";
+                break;
+            case SPV_MSG_WARNING:
+                output = Warning::output();
+                type = "warning:";
+                break;
+            case SPV_MSG_INFO:
+                output = Debug::output();
+                type = "info";
+                break;
+            case SPV_MSG_DEBUG:
+                output = Debug::output();
+                type = "debug info";
+                break;
+            /* LCOV_EXCL_STOP */
+        }
+        /* output can be nullptr in case Debug/Warning/Error is silenced */
+        CORRADE_INTERNAL_ASSERT(type);
+
+        Debug out{output};
+        out << prefix;
+        if(severity) out << severity;
+        out << operation << type << Debug::newline;
+        spv_diagnostic_t diag{position, const_cast<char*>(message), false};
+        printDiagnostic(out, file, &diag);
+    };
+}
+
+enum class OptimizationStep {
+    Preset,
+    Pass,
+    EliminateDeadCode
+};
+
+bool registerOptimizationStep(spvtools::Optimizer& optimizer, const OptimizationStep step, const Containers::StringView value, const char* const prefix) {
+    switch(step) {
+        case OptimizationStep::Preset:
+            if(value == "1"_s)
+                optimizer.RegisterPerformancePasses();
+            else if(value == "s"_s)
+                optimizer.RegisterSizePasses();
+            else if(value == "legalizeHlsl"_s)
+                optimizer.RegisterLegalizationPasses();
+            else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            return true;
+
+        case OptimizationStep::Pass:
+            /* spirv-opt wants the pass names with a leading --, allow the
+               users to omit it */
+            if(!optimizer.RegisterPassFromFlag(value.hasPrefix("--"_s) ? std::string{value} : "--" + std::string{value})) {
+                Error{} << prefix << "unrecognized optimization pass" << value;
+                return false;
+            }
+            return true;
+
+        /* Strip everything that's no longer referenced after linking, i.e.
+           functions and globals exported by the libraries but not used by any
+           entry point, and compact the ID space afterwards. A subset of what
+           RegisterSizePasses() does, so cheap to run even when that was
+           already registered above. */
+        case OptimizationStep::EliminateDeadCode:
+            optimizer.RegisterPass(spvtools::CreateEliminateDeadFunctionsPass());
+            optimizer.RegisterPass(spvtools::CreateDeadVariableEliminationPass());
+            optimizer.RegisterPass(spvtools::CreateEliminateDeadConstantPass());
+            optimizer.RegisterPass(spvtools::CreateCompactIdsPass());
+            return true;
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+/* Used by doConvertDataToData() and doLinkDataToData(). Does nothing if the
+   optimization level is empty or 0, no custom passes are set and dead code
+   elimination isn't requested, otherwise runs the optimizer and makes
+   `binary` point to `outputStorage`. */
+bool optimize(const spv_target_env env, const Utility::ConfigurationGroup& configuration, const Containers::StringView level, const bool eliminateDeadCode, const char* const prefix, spv_binary_t& binaryStorage, spv_binary& binary, Containers::ScopeGuard& binaryDestroy, std::vector<UnsignedInt>& outputStorage) {
+    /* Gather what to run. The preset first, then custom passes in the order
+       they're listed, then dead code elimination */
+    Containers::Array<Containers::Pair<OptimizationStep, Containers::String>> steps;
+    if(!level.isEmpty() && level != "0"_s) {
+        if(level != "1"_s && level != "s"_s && level != "legalizeHlsl"_s) {
+            Error{} << prefix << "optimization level should be 0, 1, s, legalizeHlsl or empty but got" << level;
+            return false;
+        }
+        arrayAppend(steps, InPlaceInit, OptimizationStep::Preset, level);
+    }
+    for(const Containers::StringView pass: configuration.value<Containers::StringView>("optimizationPasses").splitOnWhitespaceWithoutEmptyParts())
+        arrayAppend(steps, InPlaceInit, OptimizationStep::Pass, pass);
+    if(eliminateDeadCode)
+        arrayAppend(steps, InPlaceInit, OptimizationStep::EliminateDeadCode, Containers::String{});
+    if(steps.isEmpty())
+        return true;
+
+    /* With the pass report enabled, each step is run with a dedicated
+       optimizer instance in order to measure its duration and size
+       difference. Otherwise everything is registered in a single instance.
+       The preset and dead code elimination steps are measured as a whole --
+       recreating the passes they consist of from their names would lose
+       parameters the presets configure, and the report would then describe
+       a different pipeline than what's run without it. */
+    const bool passReport = configuration.value<bool>("optimizerPassReport");
+    const Containers::StringView passReportFile = configuration.value<Containers::StringView>("optimizerPassReportFile");
+    const bool measurePasses = passReport || !passReportFile.isEmpty();
+
+    /* Validator options and limits. Same as in doValidateData(). */
+    spv_validator_options validatorOptions = spvValidatorOptionsCreate();
+    Containers::ScopeGuard validatorOptionsDestroy{validatorOptions, spvValidatorOptionsDestroy};
+    setValidationOptions(validatorOptions, configuration);
+
+    /* Optimizer options */
+    spv_optimizer_options optimizerOptions = spvOptimizerOptionsCreate();
+    Containers::ScopeGuard optimizerOptionsDestroy{optimizerOptions, spvOptimizerOptionsDestroy};
+    spvOptimizerOptionsSetValidatorOptions(optimizerOptions,
+        validatorOptions);
+    spvOptimizerOptionsSetMaxIdBound(optimizerOptions,
+        configuration.value<UnsignedInt>("maxIdBound"));
+    #if SPIRVTOOLS_VERSION >= 201904
+    spvOptimizerOptionsSetPreserveBindings(optimizerOptions,
+        configuration.value<UnsignedInt>("preserveBindings"));
+    spvOptimizerOptionsSetPreserveSpecConstants(optimizerOptions,
+        configuration.value<UnsignedInt>("preserveSpecializationConstants"));
+    #endif
+
+    const std::size_t sizeBefore = binary->wordCount*4;
+    std::chrono::steady_clock::duration durationTotal{};
+    Containers::Array<Containers::String> report;
+    Containers::Array<char> reportFileContents;
+    for(std::size_t i = 0; i != steps.size(); ) {
+        const std::size_t end = measurePasses ? i + 1 : steps.size();
+
+        /* The message consumer is set only after registering the passes, as
+           RegisterPassFromFlag() prints its own not very useful message on
+           failure */
+        spvtools::Optimizer optimizer{env};
+        for(std::size_t j = i; j != end; ++j)
+            if(!registerOptimizationStep(optimizer, steps[j].first(), steps[j].second(), prefix))
+                return false;
+        optimizer.SetMessageConsumer(messageConsumer(prefix, "optimization"));
+
+        /* Validate just once before running the first step */
+        spvOptimizerOptionsSetRunValidator(optimizerOptions,
+            i == 0 && configuration.value<bool>("validateBeforeOptimization"));
+        #if SPIRVTOOLS_VERSION >= 201903
+        optimizer.SetValidateAfterAll(configuration.value<bool>("validateAfterEachOptimization"));
+        #endif
+        optimizer.SetTimeReport(configuration.value<bool>("optimizerTimeReport") ? Debug::output() : nullptr);
+
+        /* If the optimizer fails, exit. The message is printed by the message
+           consumer we set above. */
+        const std::size_t stepSizeBefore = binary->wordCount*4;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<UnsignedInt> stepOutputStorage;
+        if(!optimizer.Run(binary->code, binary->wordCount, &stepOutputStorage, optimizerOptions))
+            return false;
+        const std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - start;
+        durationTotal += duration;
+
+        /* Reference the vector guts in the binary again for the rest of the
+           code. Replace the old scope guard with an empty one, which will
+           also trigger the original deleter, if it was when disassembing. */
+        outputStorage = std::move(stepOutputStorage);
+        binaryDestroy = Containers::ScopeGuard{NoCreate};
+        binary = &binaryStorage;
+        binary->code = outputStorage.data();
+        binary->wordCount = outputStorage.size();
+
+        if(measurePasses) {
+            Containers::String name;
+            switch(steps[i].first()) {
+                case OptimizationStep::Preset:
+                    name = "optimization level " + steps[i].second();
+                    break;
+                case OptimizationStep::Pass:
+                    name = steps[i].second().hasPrefix("--"_s) ? Containers::String{steps[i].second()} : "--" + steps[i].second();
+                    break;
+                case OptimizationStep::EliminateDeadCode:
+                    name = "dead code elimination"_s;
+                    break;
+            }
+            const Double durationMs = std::chrono::duration<Double, std::milli>(duration).count();
+            arrayAppend(report, Utility::format("  {}: {:.3f} ms, {} -> {} bytes",
+                name, durationMs, stepSizeBefore, binary->wordCount*4));
+            /* One JSON object per line, appended to a growable array to
+               not copy the whole contents for every pass. The names don't
+               contain any characters that would need escaping. */
+            const Containers::String line = Utility::format("{{\"pass\": \"{}\", \"sizeBefore\": {}, \"sizeAfter\": {}, \"durationMs\": {:.6f}}}\n",
+                name, stepSizeBefore, binary->wordCount*4, durationMs);
+            arrayAppend(reportFileContents, Containers::arrayView(line.data(), line.size()));
+        }
+
+        i = end;
+    }
+
+    /* Print the report at the end so it isn't interleaved with potential
+       optimizer messages */
+    if(passReport) {
+        Debug out;
+        out << prefix << "optimization pass report:";
+        for(const Containers::String& line: report)
+            out << Debug::newline << line;
+        out << Debug::newline << Utility::format("  total: {:.3f} ms, {} -> {} bytes",
+            std::chrono::duration<Double, std::milli>(durationTotal).count(),
+            sizeBefore, binary->wordCount*4);
+    }
+    /* The optimized output is done already, so failing to write the
+       optional report isn't fatal */
+    if(!passReportFile.isEmpty() && !Utility::Path::write(passReportFile, reportFileContents))
+        Warning{} << prefix << "can't write the optimization pass report to" << passReportFile;
+
+    return true;
+}
+
+/* Used by doConvertDataToData() and doLinkDataToData() to either disassemble
+   the binary or copy it to the output */
+Containers::Optional<Containers::Array<char>> output(const spv_context context, const Utility::ConfigurationGroup& configuration, const Format outputFormat, const Containers::StringView inputFilename, const Containers::StringView outputFilename, const char* const prefix, const spv_binary_t& binary) {
+    Containers::Array<char> out;
+    if(outputFormat == Format::SpirvAssembly || (outputFormat == Format::Unspecified && outputFilename.hasSuffix(".spvasm"_s))) {
+        /* There's SPV_BINARY_TO_TEXT_OPTION_NONE which has a non-zero value
+           but isn't used anywhere. Looks like another variant of the same
+           brainfart. */
+        Int options = 0;
+        /* SPV_BINARY_TO_TEXT_OPTION_PRINT not exposed, we always want data */
+        /** @todo put Color into flags? so magnum-shaderconverter can use
+            --color auto and such */
+        if(configuration.value<bool>("color"))
+            options |= SPV_BINARY_TO_TEXT_OPTION_COLOR;
+        if(configuration.value<bool>("indent"))
+            options |= SPV_BINARY_TO_TEXT_OPTION_INDENT;
+        if(configuration.value<bool>("byteOffset"))
+            options |= SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET;
+        /* no-headers=false would be a hard-to-parse double negative, flip
+           that (also it would mean `magnum-shaderconverter -fno-no-headers`,
+           which looks extra stupid) */
+        if(!configuration.value<bool>("header"))
+            options |= SPV_BINARY_TO_TEXT_OPTION_NO_HEADER;
+        if(configuration.value<bool>("friendlyNames"))
+            options |= SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES;
+        /** @todo SPV_BINARY_TO_TEXT_OPTION_COMMENT, since
+            https://github.com/KhronosGroup/SPIRV-Tools/pull/3847, not in the
+            2020.6 release yet -- also, expose through setDebugInfoLevel()? */
+
+        spv_text text{};
+        spv_diagnostic diagnostic;
+        const spv_result_t error = spvBinaryToText(context, binary.code, binary.wordCount, options, &text, &diagnostic);
+        Containers::ScopeGuard textDestroy{text, spvTextDestroy};
+        Containers::ScopeGuard diagnosticDestroy{diagnostic, spvDiagnosticDestroy};
+        if(error) {
+            Error e;
+            e << prefix << "disassembly failed:";
+            printDiagnostic(e, inputFilename, diagnostic);
+            return {};
+        }
+
+        /* Copy the text to the output. We can't take ownership of that array
+           because it *might* have a different deleter (in reality it uses a
+           plain delete[], but I don't want to depend on such an implementation
+           detail, this is not a perf-critical code path). */
+        out = Containers::Array<char>{NoInit, text->length};
+        Utility::copy(Containers::arrayView(text->str, text->length), out);
+
+    /* Otherwise simply copy the binary to the output. We can't take ownership
+       of the array here either because in addition to the case above the
+       binary could also point right at the input `data`. */
+    } else {
+        Containers::ArrayView<const char> in(reinterpret_cast<const char*>(binary.code), 4*binary.wordCount);
+        out = Containers::Array<char>{NoInit, in.size()};
+        Utility::copy(in, out);
+    }
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(out));
+}
+
 }
 
 Containers::Pair<bool, Containers::String> SpirvToolsConverter::doValidateFile(const Stage stage, const Containers::StringView filename) {
@@ -355,156 +657,115 @@ Containers::Optional<Containers::Array<char>> SpirvToolsConverter::doConvertData
     /* Run the optimizer, if desired. What the hell, is the output a vector
        again?! Is everyone mad or */
     std::vector<UnsignedInt> optimizerOutputStorage;
-    if(!_state->optimizationLevel.isEmpty() && _state->optimizationLevel != "0"_s) {
-        spvtools::Optimizer optimizer{env};
-        if(_state->optimizationLevel == "1"_s)
-            optimizer.RegisterPerformancePasses();
-        else if(_state->optimizationLevel == "s"_s)
-            optimizer.RegisterSizePasses();
-        else if(_state->optimizationLevel == "legalizeHlsl"_s)
-            optimizer.RegisterLegalizationPasses();
-        else {
-            Error{} << "ShaderTools::SpirvToolsConverter::convertDataToData(): optimization level should be 0, 1, s, legalizeHlsl or empty but got" << _state->optimizationLevel;
-            return {};
-        }
+    if(!optimize(env, configuration(), _state->optimizationLevel, false, "ShaderTools::SpirvToolsConverter::convertDataToData():", binaryStorage, binary, binaryDestroy, optimizerOutputStorage))
+        return {};
 
-        /* Print using our own APIs */
-        optimizer.SetMessageConsumer([](spv_message_level_t level, const char* file, const spv_position_t& position, const char* message) {
-            std::ostream* output{};
-            const char* prefix{};
-            switch(level) {
-                /* LCOV_EXCL_START */
-                case SPV_MSG_FATAL:
-                    output = Error::output();
-                    prefix = "fatal optimization error:";
-                    break;
-                case SPV_MSG_INTERNAL_ERROR:
-                    output = Error::output();
-                    prefix = "internal optimization error:";
-                    break;
-                case SPV_MSG_ERROR:
-                    output = Error::output();
-                    prefix = "optimization error:";
-                    break;
-                case SPV_MSG_WARNING:
-                    output = Warning::output();
-                    prefix = "optimization warning:";
-                    break;
-                case SPV_MSG_INFO:
-                    output = Debug::output();
-                    prefix = "optimization info";
-                    break;
-                case SPV_MSG_DEBUG:
-                    output = Debug::output();
-                    prefix = "optimization debug info";
-                    break;
-                /* LCOV_EXCL_STOP */
-            }
-            /* output can be nullptr in case Debug/Warning/Error is silenced */
-            CORRADE_INTERNAL_ASSERT(prefix);
-
-            Debug out{output};
-            out << "ShaderTools::SpirvToolsConverter::convertDataToData():" << prefix << Debug::newline;
-            spv_diagnostic_t diag{position, const_cast<char*>(message), false};
-            printDiagnostic(out, file, &diag);
-        });
-
-        /* Validator options and limits. Same as in doValidateData(). */
-        spv_validator_options validatorOptions = spvValidatorOptionsCreate();
-        Containers::ScopeGuard validatorOptionsDestroy{validatorOptions, spvValidatorOptionsDestroy};
-        setValidationOptions(validatorOptions, configuration());
-
-        /* Optimizer options */
-        spv_optimizer_options optimizerOptions = spvOptimizerOptionsCreate();
-        Containers::ScopeGuard optimizerOptionsDestroy{optimizerOptions, spvOptimizerOptionsDestroy};
-        spvOptimizerOptionsSetRunValidator(optimizerOptions,
-            configuration().value<bool>("validateBeforeOptimization"));
-        spvOptimizerOptionsSetValidatorOptions(optimizerOptions,
-            validatorOptions);
-        spvOptimizerOptionsSetMaxIdBound(optimizerOptions,
-            configuration().value<UnsignedInt>("maxIdBound"));
-        #if SPIRVTOOLS_VERSION >= 201904
-        spvOptimizerOptionsSetPreserveBindings(optimizerOptions,
-            configuration().value<UnsignedInt>("preserveBindings"));
-        spvOptimizerOptionsSetPreserveSpecConstants(optimizerOptions,
-            configuration().value<UnsignedInt>("preserveSpecializationConstants"));
-        #endif
-        #if SPIRVTOOLS_VERSION >= 201903
-        optimizer.SetValidateAfterAll(configuration().value<bool>("validateAfterEachOptimization"));
-        #endif
-        optimizer.SetTimeReport(configuration().value<bool>("optimizerTimeReport") ? Debug::output() : nullptr);
+    /* Disassemble, if desired, or if the output filename ends with *.spvasm */
+    return output(context, configuration(), _state->outputFormat, inputFilename, outputFilename, "ShaderTools::SpirvToolsConverter::convertDataToData():", *binary);
+}
 
-        /* If the optimizer fails, exit. The message is printed by the message
-           consumer we set above. */
-        if(!optimizer.Run(binary->code, binary->wordCount, &optimizerOutputStorage, optimizerOptions))
-            return {};
 
-        /* Reference the vector guts in the binary again for the rest of the
-           code. Replace the old scope guard with an empty one, which will
-           also trigger the original deleter, if it was when disassembing. */
-        binaryDestroy = Containers::ScopeGuard{NoCreate};
-        binary = &binaryStorage;
-        binary->code = optimizerOutputStorage.data();
-        binary->wordCount = optimizerOutputStorage.size();
+namespace {
+
+Containers::Array<Containers::String> linkInputFilenames(const Containers::ArrayView<const Containers::Pair<Stage, Containers::StringView>> filenames) {
+    Containers::Array<Containers::String> out{std::size_t(filenames.size())};
+    for(std::size_t i = 0; i != filenames.size(); ++i)
+        out[i] = Containers::String::nullTerminatedGlobalView(filenames[i].second());
+    return out;
+}
+
+}
+
+bool SpirvToolsConverter::doLinkFilesToFile(const Containers::ArrayView<const Containers::Pair<Stage, Containers::StringView>> from, const Containers::StringView to) {
+    _state->linkInputFilenames = linkInputFilenames(from);
+    _state->outputFilename = Containers::String::nullTerminatedGlobalView(to);
+    return AbstractConverter::doLinkFilesToFile(from, to);
+}
+
+Containers::Optional<Containers::Array<char>> SpirvToolsConverter::doLinkFilesToData(const Containers::ArrayView<const Containers::Pair<Stage, Containers::StringView>> filenames) {
+    _state->linkInputFilenames = linkInputFilenames(filenames);
+    return AbstractConverter::doLinkFilesToData(filenames);
+}
+
+Containers::Optional<Containers::Array<char>> SpirvToolsConverter::doLinkDataToData(const Containers::ArrayView<const Containers::Pair<Stage, Containers::ArrayView<const char>>> data) {
+    /* Same as in doConvertDataToData(), save the input filenames and the
+       output filename if we're linking files and clear them so they don't
+       affect the next call */
+    const Containers::Array<Containers::String> inputFilenames = Utility::move(_state->linkInputFilenames);
+    const Containers::String outputFilename = Utility::move(_state->outputFilename);
+    _state->linkInputFilenames = {};
+    _state->outputFilename = {};
+
+    if(_state->inputFormat != Format::Unspecified &&
+       _state->inputFormat != Format::Spirv &&
+       _state->inputFormat != Format::SpirvAssembly) {
+        Error{} << "ShaderTools::SpirvToolsConverter::linkDataToData(): input format should be Spirv, SpirvAssembly or Unspecified but got" << _state->inputFormat;
+        return {};
+    }
+    if(!_state->inputVersion.isEmpty()) {
+        Error{} << "ShaderTools::SpirvToolsConverter::linkDataToData(): input format version should be empty but got" << _state->inputVersion;
+        return {};
     }
 
-    /* Disassemble, if desired, or if the output filename ends with *.spvasm */
-    Containers::Array<char> out;
-    if(_state->outputFormat == Format::SpirvAssembly || (_state->outputFormat == Format::Unspecified && outputFilename.hasSuffix(".spvasm"_s))) {
-        /* There's SPV_BINARY_TO_TEXT_OPTION_NONE which has a non-zero value
-           but isn't used anywhere. Looks like another variant of the same
-           brainfart. */
-        Int options = 0;
-        /* SPV_BINARY_TO_TEXT_OPTION_PRINT not exposed, we always want data */
-        /** @todo put Color into flags? so magnum-shaderconverter can use
-            --color auto and such */
-        if(configuration().value<bool>("color"))
-            options |= SPV_BINARY_TO_TEXT_OPTION_COLOR;
-        if(configuration().value<bool>("indent"))
-            options |= SPV_BINARY_TO_TEXT_OPTION_INDENT;
-        if(configuration().value<bool>("byteOffset"))
-            options |= SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET;
-        /* no-headers=false would be a hard-to-parse double negative, flip
-           that (also it would mean `magnum-shaderconverter -fno-no-headers`,
-           which looks extra stupid) */
-        if(!configuration().value<bool>("header"))
-            options |= SPV_BINARY_TO_TEXT_OPTION_NO_HEADER;
-        if(configuration().value<bool>("friendlyNames"))
-            options |= SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES;
-        /** @todo SPV_BINARY_TO_TEXT_OPTION_COMMENT, since
-            https://github.com/KhronosGroup/SPIRV-Tools/pull/3847, not in the
-            2020.6 release yet -- also, expose through setDebugInfoLevel()? */
+    if(_state->outputFormat != Format::Unspecified &&
+       _state->outputFormat != Format::Spirv &&
+       _state->outputFormat != Format::SpirvAssembly) {
+        Error{} << "ShaderTools::SpirvToolsConverter::linkDataToData(): output format should be Spirv, SpirvAssembly or Unspecified but got" << _state->outputFormat;
+        return {};
+    }
 
-        spv_text text{};
-        spv_diagnostic diagnostic;
-        const spv_result_t error = spvBinaryToText(context, binary->code, binary->wordCount, options, &text, &diagnostic);
-        Containers::ScopeGuard textDestroy{text, spvTextDestroy};
-        Containers::ScopeGuard diagnosticDestroy{diagnostic, spvDiagnosticDestroy};
-        if(error) {
-            Error e;
-            e << "ShaderTools::SpirvToolsConverter::convertDataToData(): disassembly failed:";
-            printDiagnostic(e, inputFilename, diagnostic);
+    /* Target environment, default to Vulkan 1.0. */
+    spv_target_env env = SPV_ENV_VULKAN_1_0;
+    if(!_state->outputVersion.isEmpty()) {
+        if(!spvParseTargetEnv(_state->outputVersion.data(), &env)) {
+            Error{} << "ShaderTools::SpirvToolsConverter::linkDataToData(): unrecognized output format version" << _state->outputVersion;
             return {};
         }
+    }
 
-        /* Copy the text to the output. We can't take ownership of that array
-           because it *might* have a different deleter (in reality it uses a
-           plain delete[], but I don't want to depend on such an implementation
-           detail, this is not a perf-critical code path). */
-        out = Containers::Array<char>{NoInit, text->length};
-        Utility::copy(Containers::arrayView(text->str, text->length), out);
+    /* The linker wants the C++ context wrapper, the C APIs get the underlying
+       C context through it */
+    spvtools::Context context{env};
+    context.SetMessageConsumer(messageConsumer("ShaderTools::SpirvToolsConverter::linkDataToData():", "link"));
 
-    /* Otherwise simply copy the binary to the output. We can't take ownership
-       of the array here either because in addition to the case above the
-       binary could also point right at the input `data`. */
-    } else {
-        Containers::ArrayView<const char> in(reinterpret_cast<const char*>(binary->code), 4*binary->wordCount);
-        out = Containers::Array<char>{NoInit, in.size()};
-        Utility::copy(in, out);
+    /** @todo make this work on big-endian */
+
+    /* Assemble all inputs that need it, keep views on the rest */
+    Containers::Array<spv_binary_t> binaryStorage{ValueInit, data.size()};
+    Containers::Array<spv_binary> binaries{ValueInit, data.size()};
+    Containers::Array<Containers::ScopeGuard> binaryDestroy{DirectInit, data.size(), NoCreate};
+    Containers::Array<const UnsignedInt*> binaryCode{NoInit, data.size()};
+    Containers::Array<std::size_t> binarySize{NoInit, data.size()};
+    for(std::size_t i = 0; i != data.size(); ++i) {
+        if(!readData(context.CContextRef(), configuration(), _state->inputFormat, inputFilenames.isEmpty() ? Containers::StringView{} : Containers::StringView{inputFilenames[i]}, "ShaderTools::SpirvToolsConverter::linkDataToData():", binaryStorage[i], binaries[i], binaryDestroy[i], data[i].second(), 0))
+            return {};
+        binaryCode[i] = binaries[i]->code;
+        binarySize[i] = binaries[i]->wordCount;
     }
 
-    /* GCC 4.8 needs extra help here */
-    return Containers::optional(Utility::move(out));
+    /* Link. Yes, a vector again. The message is printed by the message
+       consumer we set above. */
+    spvtools::LinkerOptions linkerOptions;
+    const bool createLibrary = configuration().value<bool>("linkCreateLibrary");
+    linkerOptions.SetCreateLibrary(createLibrary);
+    linkerOptions.SetVerifyIds(configuration().value<bool>("linkVerifyIds"));
+    std::vector<UnsignedInt> linkerOutputStorage;
+    if(spvtools::Link(context, binaryCode.data(), binarySize.data(), data.size(), &linkerOutputStorage, linkerOptions) != SPV_SUCCESS)
+        return {};
+
+    spv_binary_t linkedStorage{linkerOutputStorage.data(), linkerOutputStorage.size()};
+    spv_binary linked = &linkedStorage;
+
+    /* Optimize, if desired, and strip code that was exported by the libraries
+       but isn't used by anything in the final module. Exports need to stay
+       when creating a library, so it's not done in that case. */
+    Containers::ScopeGuard linkedDestroy{NoCreate};
+    std::vector<UnsignedInt> optimizerOutputStorage;
+    if(!optimize(env, configuration(), _state->optimizationLevel, !createLibrary && configuration().value<bool>("linkEliminateDeadCode"), "ShaderTools::SpirvToolsConverter::linkDataToData():", linkedStorage, linked, linkedDestroy, optimizerOutputStorage))
+        return {};
+
+    /* Disassemble, if desired, or if the output filename ends with *.spvasm */
+    return output(context.CContextRef(), configuration(), _state->outputFormat, {}, outputFilename, "ShaderTools::SpirvToolsConverter::linkDataToData():", *linked);
 }
 
 }}
@@ -61,8 +61,8 @@ namespace Magnum { namespace ShaderTools {
 @m_keywords{SpirvAssemblyShaderConverter}
 
 Uses [SPIRV-Tools](https://github.com/KhronosGroup/SPIRV-Tools) for SPIR-V
-validation, optimization and converting between SPIR-V binary and assembly text
-(@ref Format::Spirv, @ref Format::SpirvAssembly).
+validation, optimization, linking and converting between SPIR-V binary and
+assembly text (@ref Format::Spirv, @ref Format::SpirvAssembly).
 
 This plugin provides the `SpirvShaderConverter`, `SpirvAssemblyShaderConverter`,
 `SpirvToSpirvAssemblyShaderConverter` and `SpirvAssemblyToSpirvShaderConverter`
@@ -186,9 +186,77 @@ between SPIR-V binary and assembly @ref ShaderTools-SpirvToolsConverter-conversi
     be accepted by Vulkan
 
 Compared to [spirv-opt](https://github.com/KhronosGroup/SPIRV-Tools#optimizer-tool)
-it can work with assembly on both input and output as well, but there's
-currently no way to directly control particular optimizer stages, only general
-validation options specified through the @ref ShaderTools-SpirvToolsConverter-configuration "plugin-specific config".
+it can work with assembly on both input and output as well. Validation options
+can be specified through the @ref ShaderTools-SpirvToolsConverter-configuration "plugin-specific config".
+
+@subsection ShaderTools-SpirvToolsConverter-optimization-passes Custom optimization passes
+
+Particular optimizer passes can be listed in the @cb{.ini} optimizationPasses @ce
+@ref ShaderTools-SpirvToolsConverter-configuration "configuration option",
+using the same names as the `spirv-opt` command line, with or without the
+leading `--`. They're run in given order after the preset set via
+@ref setOptimizationLevel(), if any, which means the level can be left empty
+to run just the custom passes. Passes taking an argument are specified the same
+way as on the command line, for example `scalar-replacement=100`.
+
+Enabling @cb{.ini} optimizerPassReport @ce prints a line with duration and
+output size difference for each custom pass to the debug output. The preset
+is reported as a single step, preceding the custom passes:
+
+@code{.shell-session}
+ShaderTools::SpirvToolsConverter::convertDataToData(): optimization pass report:
+  optimization level 1: 1.203 ms, 1884 -> 1048 bytes
+  --merge-blocks: 0.063 ms, 1048 -> 1048 bytes
+  --strip-debug: 0.012 ms, 1048 -> 912 bytes
+  total: 1.278 ms, 1884 -> 912 bytes
+@endcode
+
+For further processing, the @cb{.ini} optimizerPassReportFile @ce option
+writes the report to a file, with one JSON object per line, independently of
+whether @cb{.ini} optimizerPassReport @ce is enabled:
+
+@code{.json}
+{"pass": "optimization level 1", "sizeBefore": 1884, "sizeAfter": 1048, "durationMs": 1.203471}
+{"pass": "--merge-blocks", "sizeBefore": 1048, "sizeAfter": 1048, "durationMs": 0.062918}
+@endcode
+
+If the file can't be written, a warning is printed and the conversion
+succeeds regardless.
+
+To measure the passes independently, each is run by a separate optimizer
+instance, which may add a small overhead compared to running with the report
+disabled. The output is the same as with the report disabled. To measure
+particular passes of a preset, leave the optimization level empty and list the
+passes in @cb{.ini} optimizationPasses @ce instead. The
+@cb{.ini} optimizerTimeReport @ce option can be used to get resource
+utilization of each pass of the preset as well.
+
+@section ShaderTools-SpirvToolsConverter-linking SPIR-V linking
+
+Use @ref linkDataToData(), @ref linkDataToFile(), @ref linkFilesToData() or
+@ref linkFilesToFile() to link multiple SPIR-V modules together, similarly to
+the [spirv-link](https://github.com/KhronosGroup/SPIRV-Tools#linker-tool)
+tool. This makes it possible to compile code shared among many shaders just
+once and then link it to each final module. Functions and globals to be shared
+have to be decorated with @cb{.spirv} LinkageAttributes @ce as either
+@cb{.spirv} Export @ce or @cb{.spirv} Import @ce and the modules have to
+declare the @cb{.spirv} Linkage @ce capability. The @p stage parameter is
+ignored, same as with @ref ShaderTools-SpirvToolsConverter-conversion "conversion",
+and each input can be either a SPIR-V binary or assembly, detected or
+specified @ref ShaderTools-SpirvToolsConverter-format "the same way".
+
+After linking, functions, variables and constants that aren't referenced
+from any entry point are removed and IDs compacted, which is usually the case
+for the majority of a shared library. This can be disabled with the
+@cb{.ini} linkEliminateDeadCode @ce @ref ShaderTools-SpirvToolsConverter-configuration "configuration option".
+If @ref setOptimizationLevel() is set, the linked module is additionally
+@ref ShaderTools-SpirvToolsConverter-optimization "optimized" with given
+preset. Setting the level to `s` is recommended for the smallest possible
+output.
+
+Enabling @cb{.ini} linkCreateLibrary @ce produces a library instead of a
+final module --- exports are preserved and dead code elimination is not done
+in that case.
 
 @section ShaderTools-SpirvToolsConverter-format Input and output format and version
 
@@ -205,10 +273,10 @@ ways:
     `SpirvAssemblyShaderConverter`, which will set the input and output format
     accordingly, the last two setting both the input and output format to the
     same value
-3.  Calling @ref convertFileToFile(), in which case the input format is
-    autodetected based on file contents and the output format is a SPIR-V
-    assembly instead of SPIR-V binary (the default) if the output file
-    extension is `*.spvasm`.
+3.  Calling @ref convertFileToFile() or @ref linkFilesToFile(), in which
+    case the input format is autodetected based on file contents and the
+    output format is a SPIR-V assembly instead of SPIR-V binary (the default)
+    if the output file extension is `*.spvasm`.
 
 The @p format passed to @ref setInputFormat() has to be either
 @ref Format::Unspecified, @ref Format::Spirv or @ref Format::SpirvAssembly. The
@@ -285,6 +353,9 @@ class MAGNUM_SPIRVTOOLSSHADERCONVERTER_EXPORT SpirvToolsConverter: public Abstra
         MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL bool doConvertFileToFile(Stage stage, Containers::StringView from, Containers::StringView to) override;
         MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertFileToData(Stage stage, Containers::StringView filename) override;
         MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertDataToData(Magnum::ShaderTools::Stage stage, Containers::ArrayView<const char> data) override;
+        MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL bool doLinkFilesToFile(Containers::ArrayView<const Containers::Pair<Stage, Containers::StringView>> from, Containers::StringView to) override;
+        MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doLinkFilesToData(Containers::ArrayView<const Containers::Pair<Stage, Containers::StringView>> filenames) override;
+        MAGNUM_SPIRVTOOLSSHADERCONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doLinkDataToData(Containers::ArrayView<const Containers::Pair<Stage, Containers::ArrayView<const char>>> data) override;
 
         struct State;
         Containers::Pointer<State> _state;
@@ -27,12 +27,15 @@
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/TestSuite/Compare/File.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
@@ -81,6 +84,18 @@ struct SpirvToolsConverterTest: TestSuite::Tester {
 
     void convertOptimize();
     void convertOptimizeFail();
+    void convertOptimizePasses();
+    void convertOptimizePassReport();
+    void convertOptimizePassReportFile();
+    void convertOptimizePassReportFileCantWrite();
+    void convertOptimizeUnknownPass();
+
+    void link();
+    void linkFilesToFile();
+    void linkWrongInputFormat();
+    void linkWrongOutputFormat();
+    void linkWrongOutputVersion();
+    void linkFail();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractConverter> _converterManager{"nonexistent"};
@@ -169,6 +184,18 @@ const struct {
         "triangle-shaders.spv", Format::Spirv}
 };
 
+const struct {
+    const char* name;
+    const char* level;
+    bool eliminateDeadCode, createLibrary;
+    bool expectUnused;
+} LinkData[] {
+    {"", "", true, false, false},
+    {"no dead code elimination", "", false, false, true},
+    {"-Os", "s", true, false, false},
+    {"library", "", true, true, true},
+};
+
 SpirvToolsConverterTest::SpirvToolsConverterTest() {
     addInstancedTests({&SpirvToolsConverterTest::validate,
                        &SpirvToolsConverterTest::validateFile},
@@ -215,7 +242,21 @@ SpirvToolsConverterTest::SpirvToolsConverterTest() {
     addInstancedTests({&SpirvToolsConverterTest::convertOptimize},
         Containers::arraySize(OptimizeData));
 
-    addTests({&SpirvToolsConverterTest::convertOptimizeFail});
+    addTests({&SpirvToolsConverterTest::convertOptimizeFail,
+              &SpirvToolsConverterTest::convertOptimizePasses,
+              &SpirvToolsConverterTest::convertOptimizePassReport,
+              &SpirvToolsConverterTest::convertOptimizePassReportFile,
+              &SpirvToolsConverterTest::convertOptimizePassReportFileCantWrite,
+              &SpirvToolsConverterTest::convertOptimizeUnknownPass});
+
+    addInstancedTests({&SpirvToolsConverterTest::link},
+        Containers::arraySize(LinkData));
+
+    addTests({&SpirvToolsConverterTest::linkFilesToFile,
+              &SpirvToolsConverterTest::linkWrongInputFormat,
+              &SpirvToolsConverterTest::linkWrongOutputFormat,
+              &SpirvToolsConverterTest::linkWrongOutputVersion,
+              &SpirvToolsConverterTest::linkFail});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -875,6 +916,246 @@ void SpirvToolsConverterTest::convertOptimizeFail() {
         "<data>:5: {}\n", expected));
 }
 
+void SpirvToolsConverterTest::convertOptimizePasses() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    /* No preset, just custom passes, with and without the leading -- */
+    converter->configuration().setValue("optimizationPasses", "eliminate-dead-code-aggressive  --merge-blocks\n--compact-ids");
+    converter->setOutputFormat(Format::Spirv, "spv1.2");
+
+    Containers::Optional<Containers::Array<char>> input = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv"));
+    CORRADE_VERIFY(input);
+
+    std::ostringstream out;
+    Debug redirectOutput{&out};
+    Containers::Optional<Containers::Array<char>> output = converter->convertDataToData({}, *input);
+    CORRADE_VERIFY(output);
+    CORRADE_COMPARE_AS(output->size(), 5*4, TestSuite::Compare::Greater);
+    CORRADE_COMPARE_AS(output->size(), input->size(), TestSuite::Compare::LessOrEqual);
+    /* The report is disabled by default */
+    CORRADE_COMPARE(out.str(), "");
+}
+
+void SpirvToolsConverterTest::convertOptimizePassReport() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    converter->setOptimizationLevel("1");
+    converter->configuration().setValue("optimizerPassReport", true);
+    converter->configuration().setValue("optimizationPasses", "--compact-ids");
+    converter->setOutputFormat(Format::Spirv, "spv1.2");
+
+    std::ostringstream out;
+    Debug redirectOutput{&out};
+    Containers::Optional<Containers::Array<char>> output = converter->convertFileToData({},
+        Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv"));
+    CORRADE_VERIFY(output);
+
+    /* The durations and sizes depend on the machine and SPIRV-Tools version,
+       check just the structure. The preset is reported as a whole, followed
+       by the custom pass and the total. */
+    const std::string report = out.str();
+    CORRADE_COMPARE_AS(report,
+        "ShaderTools::SpirvToolsConverter::convertDataToData(): optimization pass report:\n"
+        "  optimization level 1: ",
+        TestSuite::Compare::StringHasPrefix);
+    CORRADE_COMPARE(Containers::StringView{report}.split('\n').size(), 5);
+    CORRADE_VERIFY(Containers::StringView{report}.contains(" bytes\n  --compact-ids: "));
+    CORRADE_VERIFY(Containers::StringView{report}.contains(" bytes\n  total: "));
+    CORRADE_VERIFY(Containers::StringView{report}.hasSuffix(Utility::format(" -> {} bytes\n", output->size())));
+
+    /* The report shouldn't affect the output in any way */
+    converter->configuration().setValue("optimizerPassReport", false);
+    Containers::Optional<Containers::Array<char>> outputNoReport = converter->convertFileToData({},
+        Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv"));
+    CORRADE_VERIFY(outputNoReport);
+    CORRADE_COMPARE_AS(*output, *outputNoReport,
+        TestSuite::Compare::Container);
+}
+
+void SpirvToolsConverterTest::convertOptimizePassReportFile() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    const Containers::String filename = Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_OUTPUT_DIR, "pass-report.jsonl");
+    if(Utility::Path::exists(filename))
+        CORRADE_VERIFY(Utility::Path::remove(filename));
+
+    converter->setOptimizationLevel("1");
+    converter->configuration().setValue("optimizerPassReportFile", filename);
+    converter->configuration().setValue("optimizationPasses", "--compact-ids");
+    converter->setOutputFormat(Format::Spirv, "spv1.2");
+
+    /* The report file is independent of the printed report, which stays
+       disabled */
+    std::ostringstream out;
+    Debug redirectOutput{&out};
+    Containers::Optional<Containers::Array<char>> input = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv"));
+    CORRADE_VERIFY(input);
+    Containers::Optional<Containers::Array<char>> output = converter->convertDataToData({}, *input);
+    CORRADE_VERIFY(output);
+    CORRADE_COMPARE(out.str(), "");
+
+    Containers::Optional<Containers::String> report = Utility::Path::readString(filename);
+    CORRADE_VERIFY(report);
+    Containers::Array<Containers::StringView> lines = report->splitWithoutEmptyParts('\n');
+    /* The preset is reported as a whole, followed by the custom pass */
+    CORRADE_COMPARE(lines.size(), 2);
+
+    /* Each line is a record, the first starts with the input size and the
+       last is the custom pass ending with the output size */
+    for(const Containers::StringView line: lines) {
+        CORRADE_ITERATION(line);
+        CORRADE_COMPARE_AS(line, "{\"pass\": \"", TestSuite::Compare::StringHasPrefix);
+        CORRADE_VERIFY(line.contains("\", \"sizeBefore\": "));
+        CORRADE_VERIFY(line.contains(", \"durationMs\": "));
+        CORRADE_COMPARE_AS(line, "}", TestSuite::Compare::StringHasSuffix);
+    }
+    CORRADE_COMPARE_AS(lines.front(), Utility::format("{{\"pass\": \"optimization level 1\", \"sizeBefore\": {},", input->size()), TestSuite::Compare::StringHasPrefix);
+    CORRADE_COMPARE_AS(lines.back(), "{\"pass\": \"--compact-ids\", ", TestSuite::Compare::StringHasPrefix);
+    CORRADE_VERIFY(lines.back().contains(Utility::format("\"sizeAfter\": {},", output->size())));
+}
+
+void SpirvToolsConverterTest::convertOptimizePassReportFileCantWrite() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    converter->configuration().setValue("optimizerPassReportFile", "/some/path/that/does/not/exist");
+    converter->configuration().setValue("optimizationPasses", "--compact-ids");
+
+    /* The conversion still succeeds, with just a warning */
+    std::ostringstream out, outWarning;
+    Error redirectError{&out};
+    Warning redirectWarning{&outWarning};
+    CORRADE_VERIFY(converter->convertFileToData({},
+        Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "triangle-shaders.noopt.spv")));
+    /* There's an error from Path::write() */
+    CORRADE_VERIFY(!out.str().empty());
+    CORRADE_COMPARE(outWarning.str(),
+        "ShaderTools::SpirvToolsConverter::convertDataToData(): can't write the optimization pass report to /some/path/that/does/not/exist\n");
+}
+
+void SpirvToolsConverterTest::convertOptimizeUnknownPass() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    converter->configuration().setValue("optimizationPasses", "merge-blocks nonexistent-pass");
+    /* Force input format to binary so it doesn't go through disassembly (and
+       fail on that) */
+    converter->setInputFormat(Format::Spirv);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertDataToData({}, {}));
+    CORRADE_COMPARE(out.str(),
+        "ShaderTools::SpirvToolsConverter::convertDataToData(): unrecognized optimization pass nonexistent-pass\n");
+}
+
+void SpirvToolsConverterTest::link() {
+    auto&& data = LinkData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+    CORRADE_VERIFY(converter->features() & ConverterFeature::LinkData);
+
+    converter->setOptimizationLevel(data.level);
+    converter->configuration().setValue("linkEliminateDeadCode", data.eliminateDeadCode);
+    converter->configuration().setValue("linkCreateLibrary", data.createLibrary);
+    converter->setOutputFormat(Format::SpirvAssembly, "spv1.0");
+
+    Containers::Optional<Containers::Array<char>> library = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "link-library.spvasm"));
+    Containers::Optional<Containers::Array<char>> main = Utility::Path::read(Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "link-main.spvasm"));
+    CORRADE_VERIFY(library);
+    CORRADE_VERIFY(main);
+
+    Containers::Optional<Containers::Array<char>> out = converter->linkDataToData({
+        {Stage::Vertex, *main},
+        {Stage::Vertex, *library}
+    });
+    CORRADE_VERIFY(out);
+
+    /* The exact output depends on the SPIRV-Tools version, so check just the
+       important bits */
+    Containers::StringView assembly = *out;
+    CORRADE_VERIFY(assembly.contains("OpEntryPoint Vertex"));
+    CORRADE_COMPARE(assembly.contains("Import"), false);
+    CORRADE_COMPARE(assembly.contains("OpCapability Linkage"), data.createLibrary);
+    CORRADE_COMPARE(assembly.contains("unused"), data.expectUnused);
+}
+
+void SpirvToolsConverterTest::linkFilesToFile() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    converter->setOutputFormat({}, "spv1.0");
+
+    /* The *.spvasm extension should make it output an assembly */
+    Containers::String filename = Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_OUTPUT_DIR, "linked.spvasm");
+    if(Utility::Path::exists(filename))
+        CORRADE_VERIFY(Utility::Path::remove(filename));
+
+    CORRADE_VERIFY(converter->linkFilesToFile({
+        {Stage::Vertex, Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "link-main.spvasm")},
+        {Stage::Vertex, Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "link-library.spvasm")}
+    }, filename));
+
+    Containers::Optional<Containers::String> out = Utility::Path::readString(filename);
+    CORRADE_VERIFY(out);
+    CORRADE_VERIFY(out->contains("OpFunctionCall"));
+    CORRADE_VERIFY(!out->contains("unused"));
+}
+
+void SpirvToolsConverterTest::linkWrongInputFormat() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    converter->setInputFormat(Format::Glsl);
+
+    const char data[4]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->linkDataToData({{{}, data}}));
+    CORRADE_COMPARE(out.str(),
+        "ShaderTools::SpirvToolsConverter::linkDataToData(): input format should be Spirv, SpirvAssembly or Unspecified but got ShaderTools::Format::Glsl\n");
+}
+
+void SpirvToolsConverterTest::linkWrongOutputFormat() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    converter->setOutputFormat(Format::Glsl);
+
+    const char data[4]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->linkDataToData({{{}, data}}));
+    CORRADE_COMPARE(out.str(),
+        "ShaderTools::SpirvToolsConverter::linkDataToData(): output format should be Spirv, SpirvAssembly or Unspecified but got ShaderTools::Format::Glsl\n");
+}
+
+void SpirvToolsConverterTest::linkWrongOutputVersion() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    converter->setOutputFormat(Format::Spirv, "vulkan2.1");
+
+    const char data[4]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->linkDataToData({{{}, data}}));
+    CORRADE_COMPARE(out.str(),
+        "ShaderTools::SpirvToolsConverter::linkDataToData(): unrecognized output format version vulkan2.1\n");
+}
+
+void SpirvToolsConverterTest::linkFail() {
+    Containers::Pointer<AbstractConverter> converter = _converterManager.instantiate("SpirvToolsShaderConverter");
+
+    converter->setOutputFormat({}, "spv1.0");
+
+    /* The main module alone has an unresolved import */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->linkFilesToData({
+        {Stage::Vertex, Utility::Path::join(SPIRVTOOLSSHADERCONVERTER_TEST_DIR, "link-main.spvasm")}
+    }));
+    /* The rest of the message is SPIRV-Tools version-dependent */
+    CORRADE_COMPARE_AS(out.str(),
+        "ShaderTools::SpirvToolsConverter::linkDataToData(): link error:\n",
+        TestSuite::Compare::StringHasPrefix);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::ShaderTools::Test::SpirvToolsConverterTest)
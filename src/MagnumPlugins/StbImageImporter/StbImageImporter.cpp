@@ -25,11 +25,16 @@
 
 #include "StbImageImporter.h"
 
+#include <cstring>
+#include <new>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Move.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/ImageData.h>
 
@@ -50,11 +55,150 @@
 #define STBI_THREAD_LOCAL CORRADE_THREAD_LOCAL
 #endif
 
-/* Not defining malloc/free, because there's no equivalent for realloc in C++ */
+/* Allocate everything with new[] so the decoded images can be returned
+   directly in an Array with the default deleter instead of having to be
+   copied -- a custom deleter isn't an option, as it'd become a dangling
+   function pointer if the plugin gets unloaded before the array is deleted.
+   There's no equivalent of realloc() in C++, but stb_image calls
+   STBI_REALLOC_SIZED() everywhere except for stbi_load_gif_from_memory(),
+   which isn't used. */
+namespace {
+
+void* stbiMalloc(const std::size_t size) {
+    return new(std::nothrow) char[size];
+}
+
+void* stbiReallocSized(void* const data, const std::size_t oldSize, const std::size_t newSize) {
+    char* const out = new(std::nothrow) char[newSize];
+    /* On failure the original memory is left untouched, same as realloc() */
+    if(!out) return nullptr;
+    if(data) {
+        std::memcpy(out, data, oldSize < newSize ? oldSize : newSize);
+        delete[] static_cast<char*>(data);
+    }
+    return out;
+}
+
+void* stbiRealloc(void*, std::size_t) {
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+void stbiFree(void* const data) {
+    delete[] static_cast<char*>(data);
+}
+
+}
+
+#define STBI_MALLOC(size) stbiMalloc(size)
+#define STBI_REALLOC_SIZED(data, oldSize, newSize) stbiReallocSized(data, oldSize, newSize)
+#define STBI_REALLOC(data, newSize) stbiRealloc(data, newSize)
+#define STBI_FREE(data) stbiFree(data)
 #include "stb_image.h"
 
 namespace Magnum { namespace Trade {
 
+namespace {
+
+/* Counts GIF frames and collects their delays without decoding the LZW
+   data. Mirrors what stbi__gif_load_next() does when going through the
+   blocks, except that the image data are only skipped. Stops at the first
+   block stb_image would fail on, so it reports only frames that precede it,
+   the same as stbi_load_gif_from_memory() would. */
+bool scanGif(const Containers::ArrayView<const char> data, Vector2i& size, Containers::Array<int>& delays) {
+    stbi__context s;
+    stbi__start_mem(&s, reinterpret_cast<const stbi_uc*>(data.data()), data.size());
+    if(!stbi__gif_test(&s)) return false;
+
+    /* The stbi__gif struct is quite large due to the LZW code table, so
+       allocate it on the heap. Only the header and global palette get
+       parsed into it. */
+    Containers::Pointer<stbi__gif> g{InPlaceInit};
+    stbi__start_mem(&s, reinterpret_cast<const stbi_uc*>(data.data()), data.size());
+    if(!stbi__gif_header(&s, g.get(), nullptr, 0) || !g->w || !g->h)
+        return false;
+
+    Int delay = 0;
+    for(bool end = false; !end; ) switch(stbi__get8(&s)) {
+        /* Image descriptor */
+        case 0x2C: {
+            const Int x = stbi__get16le(&s);
+            const Int y = stbi__get16le(&s);
+            const Int w = stbi__get16le(&s);
+            const Int h = stbi__get16le(&s);
+            if(x + w > g->w || y + h > g->h) {
+                end = true;
+                break;
+            }
+            const Int lflags = stbi__get8(&s);
+            if(lflags & 0x80)
+                stbi__skip(&s, 3*(2 << (lflags & 7)));
+            else if(!(g->flags & 0x80)) {
+                end = true;
+                break;
+            }
+            /* LZW minimum code size, followed by the data sub-blocks */
+            stbi__get8(&s);
+            for(Int len; (len = stbi__get8(&s)) != 0; )
+                stbi__skip(&s, len);
+            arrayAppend(delays, delay);
+            break;
+        }
+
+        /* Extension. Only the graphic control extension is interesting as it
+           contains the frame delay, which then stays set for all following
+           frames until changed. */
+        case 0x21: {
+            if(stbi__get8(&s) == 0xF9) {
+                const Int len = stbi__get8(&s);
+                if(len == 4) {
+                    stbi__get8(&s);
+                    delay = 10*stbi__get16le(&s);
+                    stbi__get8(&s);
+                } else {
+                    /* stb_image doesn't skip the sub-blocks in this case */
+                    stbi__skip(&s, len);
+                    break;
+                }
+            }
+            for(Int len; (len = stbi__get8(&s)) != 0; )
+                stbi__skip(&s, len);
+            break;
+        }
+
+        /* Everything else, including the 0x3B stream terminator and running
+           out of data, ends the scan */
+        default: end = true;
+    }
+
+    size = {g->w, g->h};
+    return !delays.isEmpty();
+}
+
+/* Incremental GIF decoder. Frames are decoded on demand, sequentially, and
+   only the last two composited frames are kept around -- the last one is
+   in gif.out, the one before it is needed for the "restore to previous"
+   disposal method. Going back to an earlier frame restarts the decoding from
+   the beginning. */
+struct GifDecoder {
+    explicit GifDecoder(const Containers::ArrayView<const char> data, const std::size_t frameStride): twoBack{NoInit, frameStride}, previous{NoInit, frameStride} {
+        stbi__start_mem(&context, reinterpret_cast<const stbi_uc*>(data.data()), data.size());
+        std::memset(&gif, 0, sizeof(stbi__gif));
+    }
+
+    ~GifDecoder() {
+        STBI_FREE(gif.out);
+        STBI_FREE(gif.history);
+        STBI_FREE(gif.background);
+    }
+
+    stbi__context context;
+    stbi__gif gif;
+    UnsignedInt nextFrame{};
+    Containers::Array<char> twoBack, previous;
+};
+
+}
+
 struct StbImageImporter::State {
     Containers::Array<char> data;
 
@@ -62,6 +206,9 @@ struct StbImageImporter::State {
     Vector3i gifSize;
     std::size_t gifFrameStride;
     Containers::Array<int> gifDelays;
+
+    /* Populated on first GIF frame access */
+    Containers::Pointer<GifDecoder> gifDecoder;
 };
 
 StbImageImporter::StbImageImporter() {
@@ -113,43 +260,34 @@ void StbImageImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
     #endif
         (true);
 
-    /* Try to open as a gif. If that succeeds, great. If that fails, the actual
-       opening (and error handling) is done in doImage2D(). */
-    {
-        int* delays;
-        Vector3i size;
-        int components;
-        stbi_uc* gifData = stbi_load_gif_from_memory(reinterpret_cast<const stbi_uc*>(data.begin()), data.size(), &delays, &size.x(), &size.y(), &size.z(), &components, 0);
-        if(gifData) {
-            _in.emplace();
-
-            /* Acquire ownership of the data */
-            _in->gifDelays = Containers::Array<int>{delays, std::size_t(size.z()),
-                [](int* data, std::size_t) { stbi_image_free(data); }};
-            _in->data = Containers::Array<char>{reinterpret_cast<char*>(gifData),
-                std::size_t(size.product()*components),
-                [](char* data, std::size_t) { stbi_image_free(data); }};
-
-            /* Save size, decide on frame stride. stb_image says that for GIF
-               the result is always four-channel, so take a shortcut and report
-               the images as PixelFormat::RGBA8Unorm always -- that also means
-               we don't need to handle alignment explicitly. */
-            _in->gifSize = size;
-            CORRADE_INTERNAL_ASSERT(components == 4);
-            CORRADE_INTERNAL_ASSERT((size.x()*components)%4 == 0);
-            _in->gifFrameStride = size.xy().product()*components;
-            return;
-        }
-    }
-
     /* Take over the existing array or copy the data if we can't */
-    _in.emplace();
+    Containers::Pointer<State> state{InPlaceInit};
     if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
-        _in->data = Utility::move(data);
+        state->data = Utility::move(data);
     } else {
-        _in->data = Containers::Array<char>{NoInit, data.size()};
-        Utility::copy(data, _in->data);
+        state->data = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, state->data);
     }
+
+    /* Check if this is a gif and if so, count its frames. The frames
+       themselves are decoded only in doImage2D(), so the memory use depends
+       only on frame size, not on the animation length. If that fails, the
+       actual opening (and error handling) is done in doImage2D() as well. */
+    Vector2i gifSize;
+    if(scanGif(state->data, gifSize, state->gifDelays)) {
+        /* Convert the growable array back to a non-growable with the default
+           deleter so we can expose it via importerState() */
+        arrayShrink(state->gifDelays);
+
+        /* Save size, decide on frame stride. stb_image says that for GIF the
+           result is always four-channel, so take a shortcut and report the
+           images as PixelFormat::RGBA8Unorm always -- that also means we
+           don't need to handle alignment explicitly. */
+        state->gifSize = {gifSize, Int(state->gifDelays.size())};
+        state->gifFrameStride = gifSize.product()*4;
+    }
+
+    _in = Utility::move(state);
 }
 
 const void* StbImageImporter::doImporterState() const {
@@ -161,13 +299,44 @@ UnsignedInt StbImageImporter::doImage2DCount() const {
 }
 
 Containers::Optional<ImageData2D> StbImageImporter::doImage2D(const UnsignedInt id, UnsignedInt) {
-    /* This is a GIF that was loaded already during data opening. Return Nth
-       image */
+    /* This is a GIF, decode frames until the Nth one. If we're past it
+       already, start from scratch. */
     if(!_in->gifSize.isZero()) {
-        Containers::Array<char> imageData{_in->gifFrameStride};
-        Utility::copy(Containers::arrayCast<char>(
-            _in->data.slice(id*_in->gifFrameStride, (id + 1)*_in->gifFrameStride)),
-            imageData);
+        if(!_in->gifDecoder || _in->gifDecoder->nextFrame > id)
+            _in->gifDecoder.emplace(_in->data, _in->gifFrameStride);
+
+        GifDecoder& decoder = *_in->gifDecoder;
+        while(decoder.nextFrame <= id) {
+            /* Save the frame before the one being decoded, and pass the
+               frame two back for the "restore to previous" disposal. Unlike
+               stbi_load_gif_from_memory(), which passes a pointer *before*
+               its output buffer there, this points to the actual frame. */
+            if(decoder.nextFrame >= 1)
+                Utility::copy(Containers::arrayView(reinterpret_cast<const char*>(decoder.gif.out), _in->gifFrameStride), decoder.previous);
+
+            int components;
+            stbi_uc* const out = stbi__gif_load_next(&decoder.context, &decoder.gif, &components, 4, decoder.nextFrame >= 2 ? reinterpret_cast<stbi_uc*>(decoder.twoBack.data()) : nullptr);
+            /* The frames were counted on opening already, so hitting the end
+               marker here means the file is inconsistent with what the scan
+               found. Restart from scratch on the next call. */
+            if(!out || out == reinterpret_cast<stbi_uc*>(&decoder.context)) {
+                Error{} << "Trade::StbImageImporter::image2D(): cannot decode GIF frame" << decoder.nextFrame << Debug::nospace << ":" << (out ? "unexpected end of file" : stbi_failure_reason());
+                _in->gifDecoder = nullptr;
+                return {};
+            }
+
+            if(decoder.nextFrame >= 1)
+                Utility::swap(decoder.twoBack, decoder.previous);
+            ++decoder.nextFrame;
+        }
+
+        /* The frame is stored top-down, flip it while copying */
+        const std::size_t rowSize = _in->gifSize.x()*4;
+        Containers::Array<char> imageData{NoInit, _in->gifFrameStride};
+        Utility::copy(Containers::StridedArrayView2D<const char>{
+            Containers::arrayView(reinterpret_cast<const char*>(decoder.gif.out), _in->gifFrameStride),
+            {std::size_t(_in->gifSize.y()), rowSize}}.flipped<0>(),
+            Containers::StridedArrayView2D<char>{imageData, {std::size_t(_in->gifSize.y()), rowSize}});
         return Trade::ImageData2D{PixelFormat::RGBA8Unorm, _in->gifSize.xy(), Utility::move(imageData)};
     }
 
@@ -250,12 +419,10 @@ Containers::Optional<ImageData2D> StbImageImporter::doImage2D(const UnsignedInt
         return Containers::NullOpt;
     }
 
-    /* Copy the data into array with default deleter and free the original (we
-       can't use custom deleter to avoid dangling function pointer call when
-       the plugin is unloaded sooner than the array is deleted) */
-    Containers::Array<char> imageData{std::size_t(size.product()*components*channelSize)};
-    Utility::copy(Containers::arrayView(reinterpret_cast<char*>(data), imageData.size()), imageData);
-    stbi_image_free(data);
+    /* The data were allocated with new[] (see STBI_MALLOC above), so they can
+       be taken over by an array with the default deleter without a copy. The
+       Y flip was done in-place by stb_image already. */
+    Containers::Array<char> imageData{reinterpret_cast<char*>(data), std::size_t(size.product()*components*channelSize)};
 
     /* Adjust pixel storage if row size is not four byte aligned */
     PixelStorage storage;
@@ -182,6 +182,13 @@ frame. Example usage:
 
 @snippet StbImageImporter.cpp gif-delays
 
+The frames are decoded on demand in @ref image2D(), keeping only the last two
+composited frames in memory for handling frame disposal. Thus the memory use
+depends only on the frame size and not on the animation length. Accessing the
+frames sequentially is the fastest, going back to an earlier frame restarts the
+decoding from the beginning. Frame count and delays are gathered when opening
+the file without decoding the image data.
+
 Note that the support for GIF transitions is currently incomplete, see
 [nothings/stb#683](https://github.com/nothings/stb/pull/683) for details.
 
@@ -73,6 +73,8 @@ struct StbImageImporterTest: TestSuite::Tester {
     void rgbaPng();
 
     void animatedGif();
+    void animatedGifRandomAccess();
+    void animatedGifDisposePrevious();
 
     void forceBitDepth8();
     void forceBitDepth16();
@@ -278,7 +280,9 @@ StbImageImporterTest::StbImageImporterTest() {
 
     addInstancedTests({&StbImageImporterTest::rgbaPng}, Containers::arraySize(RgbaPngTestData));
 
-    addTests({&StbImageImporterTest::animatedGif});
+    addTests({&StbImageImporterTest::animatedGif,
+              &StbImageImporterTest::animatedGifRandomAccess,
+              &StbImageImporterTest::animatedGifDisposePrevious});
 
     addInstancedTests({&StbImageImporterTest::forceBitDepth8},
         Containers::arraySize(ForceBitDepth8Data));
@@ -672,6 +676,98 @@ void StbImageImporterTest::animatedGif() {
     }
 }
 
+void StbImageImporterTest::animatedGifRandomAccess() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbImageImporter");
+
+    /* Frames are decoded on demand, going back restarts the decoding from
+       the beginning. The result should be the same regardless of the order
+       in which the frames are accessed. */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBIMAGEIMPORTER_TEST_DIR, "dispose_bgnd.gif")));
+    CORRADE_COMPARE(importer->image2DCount(), 5);
+
+    Containers::Optional<Trade::ImageData2D> sequential[5];
+    for(UnsignedInt i = 0; i != importer->image2DCount(); ++i) {
+        CORRADE_ITERATION(i);
+        sequential[i] = importer->image2D(i);
+        CORRADE_VERIFY(sequential[i]);
+    }
+
+    for(UnsignedInt i: {3u, 1u, 1u, 4u, 0u, 2u}) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE_AS(*image, *sequential[i], DebugTools::CompareImage);
+    }
+}
+
+void StbImageImporterTest::animatedGifDisposePrevious() {
+    using namespace Math::Literals;
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbImageImporter");
+
+    /* A 4x4 GIF with a red first frame, then a green 2x2 square in the top
+       left corner, a blue 4x2 rectangle on the top with the "restore to
+       previous" disposal, a white 2x2 square in the bottom right with the
+       "restore to previous" disposal again and finally a green 2x2 square
+       in the bottom left. The restore should bring back the previous frame
+       contents and not the frame before or the background. Generated with
+       gif-dispose-previous.py, the reference frames match what Pillow
+       decodes. */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBIMAGEIMPORTER_TEST_DIR, "dispose-previous.gif")));
+    CORRADE_COMPARE(importer->image2DCount(), 5);
+
+    constexpr Color4ub r = 0xff0000ff_rgba;
+    constexpr Color4ub g = 0x00ff00ff_rgba;
+    constexpr Color4ub b = 0x0000ffff_rgba;
+    constexpr Color4ub w = 0xffffffff_rgba;
+    /* Bottom-up, as the importer Y-flips the output */
+    const Color4ub expected[5][16]{
+        {r, r, r, r,
+         r, r, r, r,
+         r, r, r, r,
+         r, r, r, r},
+        {r, r, r, r,
+         r, r, r, r,
+         g, g, r, r,
+         g, g, r, r},
+        {r, r, r, r,
+         r, r, r, r,
+         b, b, b, b,
+         b, b, b, b},
+        /* The blue rectangle gets restored to the second frame */
+        {r, r, w, w,
+         r, r, w, w,
+         g, g, r, r,
+         g, g, r, r},
+        /* The white square gets restored to the third frame, which is the
+           same as the second in the bottom right */
+        {g, g, r, r,
+         g, g, r, r,
+         g, g, r, r,
+         g, g, r, r},
+    };
+
+    for(UnsignedInt i = 0; i != importer->image2DCount(); ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE_AS(*image,
+            (ImageView2D{PixelFormat::RGBA8Unorm, {4, 4}, expected[i]}),
+            DebugTools::CompareImage);
+    }
+
+    /* Going back restarts the decoding, the two frames kept for the restore
+       should be set up again correctly */
+    for(UnsignedInt i: {3u, 2u, 4u}) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE_AS(*image,
+            (ImageView2D{PixelFormat::RGBA8Unorm, {4, 4}, expected[i]}),
+            DebugTools::CompareImage);
+    }
+}
+
 void StbImageImporterTest::forceBitDepth8() {
     auto&& data = ForceBitDepth8Data[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# Generates a 4x4 animated GIF with frames covering only a part of the canvas
+# and using the "do not dispose" and "restore to previous" disposal methods.
+# Each frame is filled with a single color from the global palette, and the
+# whole file is written by hand to have full control over the frame
+# rectangles and disposal methods. Usage:
+#
+#   ./gif-dispose-previous.py dispose-previous.gif
+
+import struct
+import sys
+
+RED = (0xff, 0x00, 0x00)
+GREEN = (0x00, 0xff, 0x00)
+BLUE = (0x00, 0x00, 0xff)
+WHITE = (0xff, 0xff, 0xff)
+PALETTE = [RED, GREEN, BLUE, WHITE]
+
+WIDTH = 4
+HEIGHT = 4
+
+DO_NOT_DISPOSE = 1
+RESTORE_TO_PREVIOUS = 3
+
+# x, y, width, height, palette index, disposal method
+FRAMES = [
+    (0, 0, 4, 4, 0, DO_NOT_DISPOSE),
+    (0, 0, 2, 2, 1, DO_NOT_DISPOSE),
+    (0, 0, 4, 2, 2, RESTORE_TO_PREVIOUS),
+    (2, 2, 2, 2, 3, RESTORE_TO_PREVIOUS),
+    (0, 2, 2, 2, 1, DO_NOT_DISPOSE),
+]
+
+def lzw(indices, min_code_size: int) -> bytes:
+    clear = 1 << min_code_size
+    end = clear + 1
+
+    def reset():
+        return {(i,): i for i in range(clear)}, end + 1, min_code_size + 1
+
+    table, next_code, code_size = reset()
+    codes = [(clear, code_size)]
+    prefix = ()
+    for index in indices:
+        if prefix + (index,) in table:
+            prefix = prefix + (index,)
+            continue
+        codes += [(table[prefix], code_size)]
+        if next_code < 4096:
+            table[prefix + (index,)] = next_code
+            next_code += 1
+            if next_code > (1 << code_size) and code_size < 12:
+                code_size += 1
+        else:
+            codes += [(clear, code_size)]
+            table, next_code, code_size = reset()
+        prefix = (index,)
+    if prefix:
+        codes += [(table[prefix], code_size)]
+    codes += [(end, code_size)]
+
+    # Codes are packed LSB first
+    packed = bytearray()
+    bits = 0
+    bit_count = 0
+    for code, size in codes:
+        bits |= code << bit_count
+        bit_count += size
+        while bit_count >= 8:
+            packed += bytes([bits & 0xff])
+            bits >>= 8
+            bit_count -= 8
+    if bit_count:
+        packed += bytes([bits & 0xff])
+
+    # Split into sub-blocks of at most 255 bytes, terminated by an empty one
+    out = bytearray([min_code_size])
+    for i in range(0, len(packed), 255):
+        out += bytes([len(packed[i:i + 255])]) + packed[i:i + 255]
+    return out + b'\x00'
+
+# Header and a logical screen descriptor with a 4-color global palette
+out = bytearray(b'GIF89a')
+out += struct.pack('<HHBBB', WIDTH, HEIGHT, 0x81, 0, 0)
+for color in PALETTE:
+    out += bytes(color)
+
+for x, y, width, height, index, disposal in FRAMES:
+    # Graphic control extension with the disposal method and a 100 ms delay,
+    # no transparency
+    out += struct.pack('<BBBBHBB', 0x21, 0xf9, 4, disposal << 2, 10, 0, 0)
+    # Image descriptor without a local palette and the image data
+    out += struct.pack('<BHHHHB', 0x2c, x, y, width, height, 0)
+    out += lzw([index]*width*height, 2)
+
+# Trailer
+out += b'\x3b'
+
+with open(sys.argv[1], 'wb') as f:
+    f.write(out)
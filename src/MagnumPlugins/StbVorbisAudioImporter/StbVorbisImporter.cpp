@@ -27,11 +27,14 @@
 
 #include "StbVorbisImporter.h"
 
-#include <cstdlib> /* std::free() */
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/ScopeGuard.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Functions.h>
 
 /* GCC 12 and 13 in Release warns about some clearly bogus "maybe
    uninitialized" variables inside stb_vorbis. I DON'T CARE, THE FILE IS PULLED
@@ -48,64 +51,193 @@
 
 namespace Magnum { namespace Audio {
 
+namespace {
+
+/* number of channels = 1-8, 16-bit integer or 32-bit float */
+constexpr BufferFormat VorbisFormatTable[8][2]{
+    #define _v(value) BufferFormat::value
+    {_v(Mono16), _v(MonoFloat)},
+    {_v(Stereo16), _v(StereoFloat)},
+    {BufferFormat{}, BufferFormat{}}, /* Not a thing */
+    {_v(Quad16), _v(Quad32)},
+    {BufferFormat{}, BufferFormat{}}, /* Also not a thing */
+    {_v(Surround51Channel16), _v(Surround51Channel32)},
+    {_v(Surround61Channel16), _v(Surround61Channel32)},
+    {_v(Surround71Channel16), _v(Surround71Channel32)}
+    #undef _v
+};
+
+/* Returns the number of decoded frames, which is less than the output size
+   only if the end of the stream was reached */
+std::size_t decodeInto(stb_vorbis* const vorbis, const Int channelCount, const bool floatOutput, const Containers::ArrayView<char> out) {
+    return floatOutput ?
+        stb_vorbis_get_samples_float_interleaved(vorbis, channelCount, reinterpret_cast<Float*>(out.data()), out.size()/sizeof(Float)) :
+        stb_vorbis_get_samples_short_interleaved(vorbis, channelCount, reinterpret_cast<Short*>(out.data()), out.size()/sizeof(Short));
+}
+
+}
+
 StbVorbisImporter::StbVorbisImporter() = default;
 
 StbVorbisImporter::StbVorbisImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
 ImporterFeatures StbVorbisImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool StbVorbisImporter::doIsOpened() const { return _data; }
+bool StbVorbisImporter::doIsOpened() const { return !!_data; }
 
 void StbVorbisImporter::doOpenData(Containers::ArrayView<const char> data) {
-    Int numChannels, frequency;
-    Short* decodedData = nullptr;
-
-    Int samples = stb_vorbis_decode_memory(reinterpret_cast<const UnsignedByte*>(data.data()), data.size(), &numChannels, &frequency, &decodedData);
-
-    if(samples == -1) {
-        Error() << "Audio::StbVorbisImporter::openData(): the file signature is invalid";
-        return;
-    } else if (samples == -2) {
-        /* memory allocation failure */
-        Error() << "Audio::StbVorbisImporter::openData(): out of memory";
-        return;
+    const bool floatOutput = configuration().value<bool>("floatOutput");
+    const std::size_t sampleSize = floatOutput ? sizeof(Float) : sizeof(Short);
+
+    Containers::Array<char> out;
+    Int channelCount;
+    UnsignedInt frequency;
+
+    /* Pushdata API, decoding the input in blocks */
+    if(configuration().value<bool>("pushdata")) {
+        const std::size_t blockSize = configuration().value<std::size_t>("pushdataBlockSize");
+        if(!blockSize) {
+            Error() << "Audio::StbVorbisImporter::openData(): pushdataBlockSize can't be zero";
+            return;
+        }
+
+        const UnsignedByte* const input = reinterpret_cast<const UnsignedByte*>(data.data());
+
+        /* Feed the decoder with larger and larger blocks until it has
+           enough to parse the headers */
+        std::size_t offset = 0;
+        std::size_t blockLength = Math::min(blockSize, data.size());
+        stb_vorbis* vorbis;
+        for(;;) {
+            Int used, error;
+            vorbis = stb_vorbis_open_pushdata(input, blockLength, &used, &error, nullptr);
+            if(vorbis) {
+                offset = used;
+                break;
+            }
+
+            if(error == VORBIS_outofmem) {
+                Error() << "Audio::StbVorbisImporter::openData(): out of memory";
+                return;
+            }
+            if(error != VORBIS_need_more_data) {
+                Error() << "Audio::StbVorbisImporter::openData(): the file signature is invalid";
+                return;
+            }
+            if(blockLength == data.size()) {
+                Error() << "Audio::StbVorbisImporter::openData(): file too short, expected at least complete headers but got only" << data.size() << "bytes";
+                return;
+            }
+
+            blockLength = Math::min(blockLength + blockSize, data.size());
+        }
+        Containers::ScopeGuard closeVorbis{vorbis, stb_vorbis_close};
+
+        const stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+        channelCount = info.channels;
+        frequency = info.sample_rate;
+        if(channelCount < 1 || channelCount > 8 || VorbisFormatTable[channelCount - 1][floatOutput] == BufferFormat{}) {
+            Error() << "Audio::StbVorbisImporter::openData(): unsupported channel count"
+                    << channelCount << "with" << sampleSize*8 << "bits per sample";
+            return;
+        }
+
+        /* The stream length isn't known in advance, so the output is grown
+           as frames get decoded */
+        blockLength = Math::min(blockSize, data.size() - offset);
+        for(;;) {
+            Float** output;
+            Int samples;
+            const Int used = stb_vorbis_decode_frame_pushdata(vorbis, input + offset, blockLength, nullptr, &output, &samples);
+
+            /* A complete frame isn't available in the block. If there's more
+               data, enlarge the block and try again, otherwise we're done --
+               in case of a truncated stream this means we decoded everything
+               up to the last complete frame. */
+            if(!used) {
+                if(offset + blockLength == data.size()) break;
+                blockLength = Math::min(blockLength + blockSize, data.size() - offset);
+                continue;
+            }
+
+            offset += used;
+            blockLength = Math::min(blockSize, data.size() - offset);
+
+            /* Zero samples means a resynchronization or a frame that's
+               discarded, such as the very first one */
+            if(!samples) continue;
+
+            const Containers::ArrayView<char> frame = arrayAppend(out, NoInit, samples*channelCount*sampleSize);
+            if(floatOutput) {
+                Float* const dst = reinterpret_cast<Float*>(frame.data());
+                for(Int i = 0; i != samples; ++i)
+                    for(Int c = 0; c != channelCount; ++c)
+                        dst[i*channelCount + c] = output[c][i];
+            } else convert_channels_short_interleaved(channelCount, reinterpret_cast<Short*>(frame.data()), channelCount, output, 0, samples);
+        }
+
+    /* Pulldata API, which has the whole input available */
+    } else {
+        Int error;
+        stb_vorbis* const vorbis = stb_vorbis_open_memory(reinterpret_cast<const UnsignedByte*>(data.data()), data.size(), &error, nullptr);
+        if(!vorbis) {
+            if(error == VORBIS_outofmem)
+                Error() << "Audio::StbVorbisImporter::openData(): out of memory";
+            else
+                Error() << "Audio::StbVorbisImporter::openData(): the file signature is invalid";
+            return;
+        }
+        Containers::ScopeGuard closeVorbis{vorbis, stb_vorbis_close};
+
+        const stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+        channelCount = info.channels;
+        frequency = info.sample_rate;
+        if(channelCount < 1 || channelCount > 8 || VorbisFormatTable[channelCount - 1][floatOutput] == BufferFormat{}) {
+            Error() << "Audio::StbVorbisImporter::openData(): unsupported channel count"
+                    << channelCount << "with" << sampleSize*8 << "bits per sample";
+            return;
+        }
+
+        /* Unlike stb_vorbis_decode_memory(), which starts with a small buffer
+           and doubles it as it goes, allocate the output upfront based on the
+           granule position of the last page and decode directly into it. The
+           array is made growable so it can be shrunk without a reallocation
+           if the stream turns out to be shorter. */
+        const std::size_t frameSize = channelCount*sampleSize;
+        const std::size_t expectedFrameCount = stb_vorbis_stream_length_in_samples(vorbis);
+        arrayResize(out, NoInit, expectedFrameCount*frameSize);
+        std::size_t frameCount = decodeInto(vorbis, channelCount, floatOutput, out);
+
+        /* If the whole output got filled, the length might have been
+           underestimated in case of a broken file. Decode the rest in chunks
+           of the maximal Vorbis frame size. */
+        if(frameCount == expectedFrameCount) {
+            Containers::Array<char> chunk{NoInit, 4096*frameSize};
+            while(const std::size_t chunkFrameCount = decodeInto(vorbis, channelCount, floatOutput, chunk)) {
+                arrayAppend(out, chunk.prefix(chunkFrameCount*frameSize));
+                frameCount += chunkFrameCount;
+            }
+        }
+
+        arrayResize(out, NoInit, frameCount*frameSize);
     }
 
-    Containers::Array<char> tempData{reinterpret_cast<char*>(decodedData), size_t(samples*numChannels*2),
-        [](char* data, size_t) { std::free(data); }};
+    _format = VorbisFormatTable[channelCount - 1][floatOutput];
     _frequency = frequency;
 
-    /** @todo Floating-point formats */
-    if(numChannels == 1)
-        _format = BufferFormat::Mono16;
-    else if(numChannels == 2)
-        _format = BufferFormat::Stereo16;
-    else if(numChannels == 4)
-        _format = BufferFormat::Quad16;
-    else if(numChannels == 6)
-        _format = BufferFormat::Surround51Channel16;
-    else if(numChannels == 7)
-        _format = BufferFormat::Surround61Channel16;
-    else if(numChannels == 8)
-        _format = BufferFormat::Surround71Channel16;
-    else {
-        Error() << "Audio::StbVorbisImporter::openData(): unsupported channel count"
-                << numChannels << "with" << 16 << "bits per sample";
-        return;
-    }
-
-    _data = Utility::move(tempData);
+    /* The array is kept growable, as it's only ever copied out in doData() */
+    _data = Utility::move(out);
 }
 
-void StbVorbisImporter::doClose() { _data = nullptr; }
+void StbVorbisImporter::doClose() { _data = Containers::NullOpt; }
 
 BufferFormat StbVorbisImporter::doFormat() const { return _format; }
 
 UnsignedInt StbVorbisImporter::doFrequency() const { return _frequency; }
 
 Containers::Array<char> StbVorbisImporter::doData() {
-    Containers::Array<char> copy{NoInit, _data.size()};
-    Utility::copy(_data, copy);
+    Containers::Array<char> copy{NoInit, _data->size()};
+    Utility::copy(*_data, copy);
     return copy;
 }
 
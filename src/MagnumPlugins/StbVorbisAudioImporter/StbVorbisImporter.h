@@ -32,6 +32,7 @@
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/StbVorbisAudioImporter/configure.h"
@@ -59,8 +60,8 @@ namespace Magnum { namespace Audio {
 
 @m_keywords{StbVorbisAudioImporter VorbisAudioImporter}
 
-Imports mono, stereo and surround sound files with 16 bits per channel using
-the [stb_vorbis](https://github.com/nothings/stb) library.
+Imports mono, stereo and surround sound files with 16 bits or 32-bit floats
+per channel using the [stb_vorbis](https://github.com/nothings/stb) library.
 
 This plugins provides `VorbisAudioImporter`, but note that this plugin doesn't
 have complete support for all format quirks and the performance might be worse
@@ -134,7 +135,31 @@ information.
 The files are imported with @ref BufferFormat::Mono16,
 @ref BufferFormat::Stereo16, @ref BufferFormat::Quad16,
 @ref BufferFormat::Surround51Channel16, @ref BufferFormat::Surround61Channel16
-and @ref BufferFormat::Surround71Channel16.
+and @ref BufferFormat::Surround71Channel16. If the
+@cb{.ini} floatOutput @ce @ref Audio-StbVorbisImporter-configuration "configuration option"
+is enabled, the files are imported with @ref BufferFormat::MonoFloat,
+@ref BufferFormat::StereoFloat, @ref BufferFormat::Quad32,
+@ref BufferFormat::Surround51Channel32, @ref BufferFormat::Surround61Channel32
+and @ref BufferFormat::Surround71Channel32 instead, which is the format
+stb_vorbis decodes to internally, avoiding a conversion to integers and back
+if floating-point output is desired.
+
+By default the whole file is decoded at once with the output allocated
+upfront based on the stream length. If the @cb{.ini} pushdata @ce option is
+enabled, the stb_vorbis pushdata API is used instead, which processes the
+input in blocks of @cb{.ini} pushdataBlockSize @ce bytes and doesn't require
+the stream to be complete --- for example in case of a file that's still
+being downloaded, everything up to the last complete frame is decoded.
+
+@section Audio-StbVorbisImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/StbVorbisAudioImporter/StbVorbisImporter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_STBVORBISAUDIOIMPORTER_EXPORT StbVorbisImporter: public AbstractImporter {
     public:
@@ -154,7 +179,7 @@ class MAGNUM_STBVORBISAUDIOIMPORTER_EXPORT StbVorbisImporter: public AbstractImp
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL UnsignedInt doFrequency() const override;
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
 
-        Containers::Array<char> _data;
+        Containers::Optional<Containers::Array<char>> _data;
         BufferFormat _format;
         UnsignedInt _frequency;
 };
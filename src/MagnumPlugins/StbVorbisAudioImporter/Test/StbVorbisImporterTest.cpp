@@ -26,18 +26,45 @@
 
 #include <sstream>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringStl.h> /** @todo remove when AbstractImporter is <string>-free */
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Magnum/Audio/AbstractImporter.h>
+#include <Magnum/Math/Functions.h>
 
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
 
+const struct {
+    const char* name;
+    const char* filename;
+    BufferFormat format;
+} FloatOutputData[]{
+    {"mono", "mono16.ogg", BufferFormat::MonoFloat},
+    {"stereo", "stereo8.ogg", BufferFormat::StereoFloat}
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    bool floatOutput;
+    Containers::Optional<std::size_t> blockSize;
+} PushdataData[]{
+    {"mono", "mono16.ogg", false, {}},
+    {"mono, float", "mono16.ogg", true, {}},
+    {"stereo", "stereo8.ogg", false, {}},
+    {"stereo, float", "stereo8.ogg", true, {}},
+    /* Smaller than the headers, the block has to be enlarged several times */
+    {"stereo, 256-byte blocks", "stereo8.ogg", false, 256},
+    {"stereo, float, 256-byte blocks", "stereo8.ogg", true, 256},
+};
+
 struct StbVorbisImporterTest: TestSuite::Tester {
     explicit StbVorbisImporterTest();
 
@@ -50,6 +77,11 @@ struct StbVorbisImporterTest: TestSuite::Tester {
     void mono16();
     void stereo8();
 
+    void floatOutput();
+    void pushdata();
+    void pushdataTooShort();
+    void pushdataTruncated();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -64,6 +96,15 @@ StbVorbisImporterTest::StbVorbisImporterTest() {
               &StbVorbisImporterTest::mono16,
               &StbVorbisImporterTest::stereo8});
 
+    addInstancedTests({&StbVorbisImporterTest::floatOutput},
+        Containers::arraySize(FloatOutputData));
+
+    addInstancedTests({&StbVorbisImporterTest::pushdata},
+        Containers::arraySize(PushdataData));
+
+    addTests({&StbVorbisImporterTest::pushdataTooShort,
+              &StbVorbisImporterTest::pushdataTruncated});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef STBVORBISAUDIOIMPORTER_PLUGIN_FILENAME
@@ -134,6 +175,97 @@ void StbVorbisImporterTest::stereo8() {
         }), TestSuite::Compare::Container);
 }
 
+void StbVorbisImporterTest::floatOutput() {
+    auto&& data = FloatOutputData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Import as 16-bit for comparison */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, data.filename)));
+    Containers::Array<char> expected = importer->data();
+
+    importer->configuration().setValue("floatOutput", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(importer->format(), data.format);
+    CORRADE_COMPARE(importer->frequency(), 96000);
+
+    Containers::Array<char> imported = importer->data();
+    Containers::ArrayView<const Float> floats = Containers::arrayCast<const Float>(imported);
+    CORRADE_COMPARE(floats.size(), expected.size()/2);
+
+    /* Converting the floats the same way as stb_vorbis does should give back
+       the 16-bit output */
+    Containers::Array<Short> converted{NoInit, floats.size()};
+    for(std::size_t i = 0; i != floats.size(); ++i)
+        converted[i] = Short(Math::clamp(Math::round(floats[i]*32768.0f), -32768.0f, 32767.0f));
+    CORRADE_COMPARE_AS(converted,
+        Containers::arrayCast<const Short>(expected),
+        TestSuite::Compare::Container);
+}
+
+void StbVorbisImporterTest::pushdata() {
+    auto&& data = PushdataData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Import with the default pulldata API for comparison */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    importer->configuration().setValue("floatOutput", data.floatOutput);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, data.filename)));
+    const BufferFormat expectedFormat = importer->format();
+    Containers::Array<char> expected = importer->data();
+
+    importer->configuration().setValue("pushdata", true);
+    if(data.blockSize)
+        importer->configuration().setValue("pushdataBlockSize", *data.blockSize);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(importer->format(), expectedFormat);
+    CORRADE_COMPARE(importer->frequency(), 96000);
+    CORRADE_COMPARE_AS(importer->data(),
+        expected,
+        TestSuite::Compare::Container);
+}
+
+void StbVorbisImporterTest::pushdataTooShort() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    importer->configuration().setValue("pushdata", true);
+
+    Containers::Optional<Containers::Array<char>> data = Utility::Path::read(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "mono16.ogg"));
+    CORRADE_VERIFY(data);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openData(data->prefix(100)));
+    CORRADE_COMPARE(out.str(), "Audio::StbVorbisImporter::openData(): file too short, expected at least complete headers but got only 100 bytes\n");
+}
+
+void StbVorbisImporterTest::pushdataTruncated() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    importer->configuration().setValue("pushdata", true);
+
+    Containers::Optional<Containers::Array<char>> data = Utility::Path::read(Utility::Path::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "stereo8.ogg"));
+    CORRADE_VERIFY(data);
+
+    /* The file is a 58-byte identification header page, a 4329-byte page
+       with the comment and setup headers and a final 114-byte page with two
+       audio packets, 44 and 41 bytes. Cutting off the last 10 bytes leaves
+       the headers and the first audio packet complete, the second packet is
+       incomplete. */
+    CORRADE_COMPARE(data->size(), 4501);
+    CORRADE_VERIFY(importer->openData(data->exceptSuffix(10)));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    CORRADE_COMPARE(importer->frequency(), 96000);
+
+    /* The first audio packet only primes the overlap window and produces no
+       samples, the incomplete second packet gets dropped. So the import
+       succeeds, with nothing decoded. */
+    CORRADE_COMPARE(importer->data().size(), 0);
+
+    /* With the whole file there's the second packet, which produces the
+       single sample in the file */
+    CORRADE_VERIFY(importer->openData(*data));
+    CORRADE_COMPARE(importer->data().size(), 1*2*2);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::StbVorbisImporterTest)
@@ -0,0 +1,443 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StaticArray.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Format.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Packing.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Test { namespace {
+
+/* Encoding and decoding throughput of the block compression plugins in pixels
+   per second, and quality of the compressed data as PSNR against the source
+   image. Each throughput case is run with a varying number of threads --
+   BasisImageConverter parallelizes internally through its threads option,
+   for the other plugins each thread runs a separate plugin instance on its own
+   copy of the work, which is how a texture processing pipeline would scale
+   them. By default only small sizes and a single thread plus all hardware
+   threads are used, pass for example --compression-sizes "1024 4096" and
+   --compression-threads "1 4 16" to override. */
+struct BlockCompressionBenchmark: TestSuite::Tester {
+    explicit BlockCompressionBenchmark();
+
+    void encode();
+    void decode();
+    void quality();
+
+    private:
+        struct Source {
+            Vector2i size;
+            Containers::Array<char> pixels;
+            /* Output of each EncodeData entry, empty if the plugin isn't
+               enabled */
+            Containers::Array<Containers::Optional<Trade::ImageData2D>> images;
+            Containers::Array<Containers::Array<char>> files;
+            /* Input of each DecodeData entry that has a decoder, empty if
+               the plugins producing it aren't enabled */
+            Containers::Array<Containers::Optional<Trade::ImageData2D>> decoderInputs;
+        };
+
+        void throughputBegin();
+        std::uint64_t throughputEnd();
+
+        PluginManager::Manager<Trade::AbstractImporter> _importerManager{"nonexistent"};
+        PluginManager::Manager<Trade::AbstractImageConverter> _converterManager{"nonexistent"};
+        Containers::Array<Source> _sources;
+        Containers::Array<UnsignedInt> _threadCounts;
+
+        std::size_t _pixelCount;
+        std::chrono::steady_clock::time_point _throughputStart;
+};
+
+using namespace Containers::Literals;
+
+const struct {
+    const char* name;
+    const char* plugin;
+    /* Whitespace-separated key=value pairs */
+    const char* options;
+    /* If set, the plugin produces a file and parallelizes internally via the
+       threads option. Otherwise it produces a compressed image and each
+       thread runs a separate plugin instance. */
+    bool file;
+} EncodeData[]{
+    {"BC1, stb_dxt", "StbDxtImageConverter", "alpha=false", false},
+    {"BC1, stb_dxt high quality", "StbDxtImageConverter", "alpha=false highQuality=true", false},
+    {"BC3, stb_dxt", "StbDxtImageConverter", "alpha=true", false},
+    /* The Y flip is disabled in order to have the transcoded compressed
+       images in the same orientation as the source, since BasisImporter
+       can't flip all of them back */
+    {"Basis ETC1S", "BasisImageConverter", "y_flip=false", true},
+    {"Basis UASTC", "BasisImageConverter", "y_flip=false uastc=true", true},
+};
+
+const struct {
+    const char* name;
+    /* Index into EncodeData */
+    std::size_t encoder;
+    /* If set, the output of the encoder is transcoded by BasisImporter to
+       this format */
+    const char* transcodeFormat;
+    /* If null, the transcoding itself is measured */
+    const char* decoder;
+} DecodeData[]{
+    {"BC1, bcdec", 0, nullptr, "BcDecImageConverter"},
+    {"BC1 high quality, bcdec", 1, nullptr, "BcDecImageConverter"},
+    {"BC3, bcdec", 2, nullptr, "BcDecImageConverter"},
+    {"BC1 from Basis ETC1S, bcdec", 3, "Bc1RGB", "BcDecImageConverter"},
+    {"BC7 from Basis UASTC, bcdec", 4, "Bc7RGBA", "BcDecImageConverter"},
+    {"ETC2 from Basis UASTC, etcdec", 4, "Etc2RGBA", "EtcDecImageConverter"},
+    {"Basis ETC1S to RGBA8", 3, "RGBA8", nullptr},
+    {"Basis ETC1S to BC1", 3, "Bc1RGB", nullptr},
+    {"Basis UASTC to RGBA8", 4, "RGBA8", nullptr},
+    {"Basis UASTC to BC7", 4, "Bc7RGBA", nullptr},
+};
+
+/* Picked to catch broken output, not small quality regressions -- for those
+   the printed value should be tracked instead */
+constexpr Double MinimumPsnr = 24.0;
+
+/* Smooth gradients with a bit of deterministic noise on top and a gradient in
+   the alpha channel, so there's some work for the encoders to do */
+Containers::Array<char> syntheticImage(const Vector2i& size) {
+    Containers::Array<char> out{NoInit, std::size_t(size.product()*4)};
+    const Containers::ArrayView<Color4ub> pixels = Containers::arrayCast<Color4ub>(out);
+    for(Int y = 0; y != size.y(); ++y) {
+        for(Int x = 0; x != size.x(); ++x) {
+            const UnsignedInt hash = (UnsignedInt(x)*73856093u ^ UnsignedInt(y)*19349663u)*2654435761u;
+            const Float noise = Float(hash >> 24)/255.0f*0.0625f;
+            const Vector2 t = Vector2{Vector2i{x, y}}/Vector2{size};
+            pixels[y*size.x() + x] = Math::pack<Color4ub>(Math::clamp(Color4{t.x() + noise, t.y(), 1.0f - t.x()*t.y() + noise, 1.0f - 0.5f*t.y()}, 0.0f, 1.0f));
+        }
+    }
+    return out;
+}
+
+void configure(Utility::ConfigurationGroup& configuration, const Containers::StringView options) {
+    for(const Containers::StringView option: options.splitOnWhitespaceWithoutEmptyParts()) {
+        const Containers::Array3<Containers::StringView> keyValue = option.partition('=');
+        configuration.setValue(keyValue[0], keyValue[2]);
+    }
+}
+
+/* Calls the function with indices from 0 to count - 1, each in a separate
+   thread, with the first one on the calling thread */
+template<class F> void parallel(const std::size_t count, const F& f) {
+    Containers::Array<std::thread> threads{ValueInit, count - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{f, i + 1};
+    f(0);
+    for(std::thread& thread: threads)
+        thread.join();
+}
+
+/* Only the RGB channels are compared, as some of the formats drop alpha */
+Double psnr(const Containers::StridedArrayView2D<const Color4ub>& expected, const Containers::StridedArrayView2D<const Color4ub>& actual) {
+    CORRADE_INTERNAL_ASSERT(expected.size() == actual.size());
+    Double squaredError = 0.0;
+    for(std::size_t y = 0; y != expected.size()[0]; ++y) {
+        for(std::size_t x = 0; x != expected.size()[1]; ++x) {
+            const Vector3d difference = Vector3d{expected[y][x].rgb()} - Vector3d{actual[y][x].rgb()};
+            squaredError += Math::dot(difference, difference);
+        }
+    }
+
+    const Double meanSquaredError = squaredError/(3*expected.size()[0]*expected.size()[1]);
+    return 10.0*std::log10(255.0*255.0/meanSquaredError);
+}
+
+BlockCompressionBenchmark::BlockCompressionBenchmark(): TestSuite::Tester{TesterConfiguration{}.setSkippedArgumentPrefixes({"compression"})} {
+    Utility::Arguments args{"compression"};
+    args.addOption("sizes", "256 1024").setHelp("sizes", "sizes of the source images, have to be a multiple of 4", "\"N N...\"")
+        .addOption("threads").setHelp("threads", "thread counts to run with, default is 1 and all hardware threads", "\"N N...\"")
+        .parse(arguments().first(), arguments().second());
+
+    /* Load the plugins directly from the build tree. Otherwise they're either
+       static and already loaded or not built at all, in which case the
+       particular benchmark cases are skipped. */
+    #ifdef BASISIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(BASISIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef BASISIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(BASISIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef BCDECIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(BCDECIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef ETCDECIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(ETCDECIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STBDXTIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(STBDXTIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+
+    if(const Containers::StringView threads = args.value<Containers::StringView>("threads")) {
+        for(const Containers::StringView threadCount: threads.splitOnWhitespaceWithoutEmptyParts())
+            arrayAppend(_threadCounts, UnsignedInt(Math::max(std::strtol(Containers::String::nullTerminatedView(threadCount).data(), nullptr, 10), 1l)));
+    } else {
+        arrayAppend(_threadCounts, 1u);
+        if(std::thread::hardware_concurrency() > 1)
+            arrayAppend(_threadCounts, std::thread::hardware_concurrency());
+    }
+
+    /* Encode all sources up front, the decoders then get the output */
+    for(const Containers::StringView sizeString: args.value<Containers::StringView>("sizes").splitOnWhitespaceWithoutEmptyParts()) {
+        const Int size = std::strtol(Containers::String::nullTerminatedView(sizeString).data(), nullptr, 10);
+        Source source{Vector2i{size}, syntheticImage(Vector2i{size}),
+            Containers::Array<Containers::Optional<Trade::ImageData2D>>{ValueInit, Containers::arraySize(EncodeData)},
+            Containers::Array<Containers::Array<char>>{ValueInit, Containers::arraySize(EncodeData)},
+            Containers::Array<Containers::Optional<Trade::ImageData2D>>{ValueInit, Containers::arraySize(DecodeData)}};
+        const ImageView2D image{PixelFormat::RGBA8Unorm, source.size, source.pixels};
+
+        for(std::size_t i = 0; i != Containers::arraySize(EncodeData); ++i) {
+            if(!(_converterManager.loadState(EncodeData[i].plugin) & PluginManager::LoadState::Loaded))
+                continue;
+
+            Containers::Pointer<Trade::AbstractImageConverter> converter = _converterManager.instantiate(EncodeData[i].plugin);
+            configure(converter->configuration(), EncodeData[i].options);
+            if(EncodeData[i].file) {
+                converter->configuration().setValue("threads", 0);
+                Containers::Optional<Containers::Array<char>> file = converter->convertToData(image);
+                CORRADE_INTERNAL_ASSERT(file);
+                source.files[i] = *Utility::move(file);
+            } else {
+                source.images[i] = converter->convert(image);
+                CORRADE_INTERNAL_ASSERT(source.images[i]);
+            }
+        }
+
+        for(std::size_t i = 0; i != Containers::arraySize(DecodeData); ++i) {
+            if(!DecodeData[i].decoder)
+                continue;
+
+            if(DecodeData[i].transcodeFormat) {
+                if(!(_importerManager.loadState("BasisImporter") & PluginManager::LoadState::Loaded) || source.files[DecodeData[i].encoder].isEmpty())
+                    continue;
+
+                Containers::Pointer<Trade::AbstractImporter> importer = _importerManager.instantiate("BasisImporter");
+                importer->configuration().setValue("format", DecodeData[i].transcodeFormat);
+                importer->configuration().setValue("assumeYUp", true);
+                CORRADE_INTERNAL_ASSERT_OUTPUT(importer->openData(source.files[DecodeData[i].encoder]));
+                source.decoderInputs[i] = importer->image2D(0);
+                CORRADE_INTERNAL_ASSERT(source.decoderInputs[i]);
+
+            } else if(const Containers::Optional<Trade::ImageData2D>& encoded = source.images[DecodeData[i].encoder]) {
+                Containers::Array<char> copy{NoInit, encoded->data().size()};
+                Utility::copy(encoded->data(), copy);
+                source.decoderInputs[i] = Trade::ImageData2D{encoded->compressedFormat(), encoded->size(), Utility::move(copy)};
+            }
+        }
+
+        arrayAppend(_sources, Utility::move(source));
+    }
+
+    addCustomInstancedBenchmarks({&BlockCompressionBenchmark::encode}, 3, Containers::arraySize(EncodeData)*_sources.size()*_threadCounts.size(),
+        &BlockCompressionBenchmark::throughputBegin,
+        &BlockCompressionBenchmark::throughputEnd,
+        BenchmarkUnits::Count);
+
+    addCustomInstancedBenchmarks({&BlockCompressionBenchmark::decode}, 10, Containers::arraySize(DecodeData)*_sources.size()*_threadCounts.size(),
+        &BlockCompressionBenchmark::throughputBegin,
+        &BlockCompressionBenchmark::throughputEnd,
+        BenchmarkUnits::Count);
+
+    addInstancedTests({&BlockCompressionBenchmark::quality},
+        Containers::arraySize(DecodeData)*_sources.size());
+}
+
+void BlockCompressionBenchmark::encode() {
+    auto&& data = EncodeData[testCaseInstanceId()/(_sources.size()*_threadCounts.size())];
+    const Source& source = _sources[testCaseInstanceId()/_threadCounts.size() % _sources.size()];
+    const UnsignedInt threadCount = _threadCounts[testCaseInstanceId() % _threadCounts.size()];
+    setTestCaseDescription(Utility::format("{}, {}x{}, {} threads", data.name, source.size.x(), source.size.y(), threadCount));
+
+    if(!(_converterManager.loadState(data.plugin) & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP(data.plugin << "plugin not enabled, cannot benchmark");
+
+    Containers::Array<Containers::Pointer<Trade::AbstractImageConverter>> converters{ValueInit, data.file ? 1 : threadCount};
+    for(Containers::Pointer<Trade::AbstractImageConverter>& converter: converters) {
+        converter = _converterManager.instantiate(data.plugin);
+        configure(converter->configuration(), data.options);
+        if(data.file)
+            converter->configuration().setValue("threads", threadCount);
+    }
+
+    const ImageView2D image{PixelFormat::RGBA8Unorm, source.size, source.pixels};
+    Containers::Array<std::size_t> outputSizes{ValueInit, converters.size()};
+    _pixelCount = source.size.product()*converters.size();
+    CORRADE_BENCHMARK(1) {
+        parallel(converters.size(), [&](const std::size_t i) {
+            if(data.file) {
+                if(Containers::Optional<Containers::Array<char>> file = converters[i]->convertToData(image))
+                    outputSizes[i] = file->size();
+            } else if(Containers::Optional<Trade::ImageData2D> compressed = converters[i]->convert(image))
+                outputSizes[i] = compressed->data().size();
+        });
+    }
+
+    for(std::size_t i = 0; i != outputSizes.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(outputSizes[i]);
+    }
+}
+
+void BlockCompressionBenchmark::decode() {
+    const std::size_t dataId = testCaseInstanceId()/(_sources.size()*_threadCounts.size());
+    auto&& data = DecodeData[dataId];
+    const Source& source = _sources[testCaseInstanceId()/_threadCounts.size() % _sources.size()];
+    const UnsignedInt threadCount = _threadCounts[testCaseInstanceId() % _threadCounts.size()];
+    setTestCaseDescription(Utility::format("{}, {}x{}, {} threads", data.name, source.size.x(), source.size.y(), threadCount));
+
+    Containers::Array<std::size_t> outputSizes{ValueInit, threadCount};
+    _pixelCount = source.size.product()*threadCount;
+
+    /* Decoding the data prepared in the constructor */
+    if(data.decoder) {
+        if(!(_converterManager.loadState(data.decoder) & PluginManager::LoadState::Loaded))
+            CORRADE_SKIP(data.decoder << "plugin not enabled, cannot benchmark");
+        if(!source.decoderInputs[dataId])
+            CORRADE_SKIP(EncodeData[data.encoder].plugin << "or BasisImporter plugin not enabled, cannot benchmark");
+
+        Containers::Array<Containers::Pointer<Trade::AbstractImageConverter>> converters{ValueInit, threadCount};
+        for(Containers::Pointer<Trade::AbstractImageConverter>& converter: converters)
+            converter = _converterManager.instantiate(data.decoder);
+
+        const Trade::ImageData2D& input = *source.decoderInputs[dataId];
+        CORRADE_BENCHMARK(1) {
+            parallel(threadCount, [&](const std::size_t i) {
+                if(Containers::Optional<Trade::ImageData2D> image = converters[i]->convert(input))
+                    outputSizes[i] = image->data().size();
+            });
+        }
+
+    /* Transcoding the Basis file */
+    } else {
+        if(!(_importerManager.loadState("BasisImporter") & PluginManager::LoadState::Loaded))
+            CORRADE_SKIP("BasisImporter plugin not enabled, cannot benchmark");
+        if(source.files[data.encoder].isEmpty())
+            CORRADE_SKIP(EncodeData[data.encoder].plugin << "plugin not enabled, cannot benchmark");
+
+        Containers::Array<Containers::Pointer<Trade::AbstractImporter>> importers{ValueInit, threadCount};
+        for(Containers::Pointer<Trade::AbstractImporter>& importer: importers) {
+            importer = _importerManager.instantiate("BasisImporter");
+            importer->configuration().setValue("format", data.transcodeFormat);
+            importer->configuration().setValue("assumeYUp", true);
+        }
+
+        const Containers::ArrayView<const char> file = source.files[data.encoder];
+        CORRADE_BENCHMARK(1) {
+            parallel(threadCount, [&](const std::size_t i) {
+                if(!importers[i]->openData(file))
+                    return;
+                if(Containers::Optional<Trade::ImageData2D> image = importers[i]->image2D(0))
+                    outputSizes[i] = image->data().size();
+            });
+        }
+    }
+
+    for(std::size_t i = 0; i != outputSizes.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(outputSizes[i]);
+    }
+}
+
+void BlockCompressionBenchmark::quality() {
+    const std::size_t dataId = testCaseInstanceId()/_sources.size();
+    auto&& data = DecodeData[dataId];
+    const Source& source = _sources[testCaseInstanceId() % _sources.size()];
+    setTestCaseDescription(Utility::format("{}, {}x{}", data.name, source.size.x(), source.size.y()));
+
+    Containers::Optional<Trade::ImageData2D> decoded;
+    if(data.decoder) {
+        if(!(_converterManager.loadState(data.decoder) & PluginManager::LoadState::Loaded))
+            CORRADE_SKIP(data.decoder << "plugin not enabled, cannot test");
+        if(!source.decoderInputs[dataId])
+            CORRADE_SKIP(EncodeData[data.encoder].plugin << "or BasisImporter plugin not enabled, cannot test");
+
+        decoded = _converterManager.instantiate(data.decoder)->convert(*source.decoderInputs[dataId]);
+
+    } else {
+        if(Containers::StringView{data.transcodeFormat} != "RGBA8"_s)
+            CORRADE_SKIP("Transcoding to a compressed format, quality is measured by the decoder cases.");
+        if(!(_importerManager.loadState("BasisImporter") & PluginManager::LoadState::Loaded))
+            CORRADE_SKIP("BasisImporter plugin not enabled, cannot test");
+        if(source.files[data.encoder].isEmpty())
+            CORRADE_SKIP(EncodeData[data.encoder].plugin << "plugin not enabled, cannot test");
+
+        Containers::Pointer<Trade::AbstractImporter> importer = _importerManager.instantiate("BasisImporter");
+        importer->configuration().setValue("format", data.transcodeFormat);
+        importer->configuration().setValue("assumeYUp", true);
+        CORRADE_VERIFY(importer->openData(source.files[data.encoder]));
+        decoded = importer->image2D(0);
+    }
+
+    CORRADE_VERIFY(decoded);
+    CORRADE_COMPARE(decoded->size(), source.size);
+    CORRADE_COMPARE(decoded->format(), PixelFormat::RGBA8Unorm);
+
+    const ImageView2D image{PixelFormat::RGBA8Unorm, source.size, source.pixels};
+    const Double value = psnr(image.pixels<Color4ub>(), decoded->pixels<Color4ub>());
+    CORRADE_INFO(Utility::format("PSNR {:.2f} dB", value));
+    CORRADE_COMPARE_AS(value, MinimumPsnr,
+        TestSuite::Compare::GreaterOrEqual);
+}
+
+void BlockCompressionBenchmark::throughputBegin() {
+    _throughputStart = std::chrono::steady_clock::now();
+}
+
+/* Reported as pixels per second, summed over all threads */
+std::uint64_t BlockCompressionBenchmark::throughputEnd() {
+    const std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - _throughputStart;
+    return std::uint64_t(Double(_pixelCount)/std::chrono::duration<Double>(duration).count());
+}
+
+}}}
+
+CORRADE_TEST_MAIN(Magnum::Test::BlockCompressionBenchmark)
@@ -0,0 +1,390 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/String.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Packing.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+#include "allocationTracking.h"
+
+namespace Magnum { namespace Test { namespace {
+
+/* Decoding speed and memory use of all image importers, on synthetic images
+   encoded with the converter plugins and optionally on real-world files. By
+   default only small sizes are used in order to have the benchmark run in a
+   reasonable time as a part of the test suite, pass for example
+   --corpus-sizes "256 1024 4096" to test larger images and
+   --corpus-directory path/to/images to add real-world files. */
+struct ImageImporterBenchmark: TestSuite::Tester {
+    explicit ImageImporterBenchmark();
+
+    void decode();
+    void decodePeakAllocation();
+
+    private:
+        struct Case {
+            Containers::String name;
+            const char* importer;
+            Containers::Array<char> data;
+        };
+
+        Containers::Pointer<Trade::AbstractImporter> instantiateAndVerify(const Case& data);
+
+        void throughputBegin();
+        std::uint64_t throughputEnd();
+        void peakAllocationBegin();
+        std::uint64_t peakAllocationEnd();
+
+        PluginManager::Manager<Trade::AbstractImporter> _importerManager{"nonexistent"};
+        PluginManager::Manager<Trade::AbstractImageConverter> _converterManager{"nonexistent"};
+        Containers::Array<Case> _cases;
+
+        std::size_t _decodedSize;
+        std::chrono::steady_clock::time_point _throughputStart;
+        std::size_t _allocationBase;
+};
+
+using namespace Containers::Literals;
+
+const struct {
+    const char* importer;
+    /* If null, the file is written by hand */
+    const char* converter;
+    const char* formatName;
+    PixelFormat format;
+} SyntheticData[]{
+    {"PngImporter", "PngImageConverter", "RGB8", PixelFormat::RGB8Unorm},
+    {"PngImporter", "PngImageConverter", "RGBA8", PixelFormat::RGBA8Unorm},
+    {"SpngImporter", "PngImageConverter", "RGB8", PixelFormat::RGB8Unorm},
+    {"SpngImporter", "PngImageConverter", "RGBA8", PixelFormat::RGBA8Unorm},
+    {"PngImporter", "PngImageConverter", "RGBA16", PixelFormat::RGBA16Unorm},
+    {"SpngImporter", "PngImageConverter", "RGBA16", PixelFormat::RGBA16Unorm},
+    {"StbImageImporter", "PngImageConverter", "RGBA8 PNG", PixelFormat::RGBA8Unorm},
+    {"JpegImporter", "JpegImageConverter", "RGB8", PixelFormat::RGB8Unorm},
+    {"StbImageImporter", "JpegImageConverter", "RGB8 JPEG", PixelFormat::RGB8Unorm},
+    {"StbImageImporter", "StbHdrImageConverter", "RGB32F HDR", PixelFormat::RGB32F},
+    {"WebPImporter", "WebPImageConverter", "RGBA8", PixelFormat::RGBA8Unorm},
+    {"OpenExrImporter", "OpenExrImageConverter", "RGBA16F", PixelFormat::RGBA16F},
+    {"OpenExrImporter", "OpenExrImageConverter", "RGBA32F", PixelFormat::RGBA32F},
+    {"KtxImporter", "KtxImageConverter", "RGBA8", PixelFormat::RGBA8Unorm},
+    {"DdsImporter", nullptr, "RGBA8", PixelFormat::RGBA8Unorm},
+};
+
+/* Importers to use for real-world files of given extension */
+const struct {
+    Containers::StringView extension;
+    const char* importers[3];
+} CorpusData[]{
+    {".png"_s, {"PngImporter", "SpngImporter", "StbImageImporter"}},
+    {".jpg"_s, {"JpegImporter", "StbImageImporter", nullptr}},
+    {".jpeg"_s, {"JpegImporter", "StbImageImporter", nullptr}},
+    {".webp"_s, {"WebPImporter", nullptr, nullptr}},
+    {".exr"_s, {"OpenExrImporter", nullptr, nullptr}},
+    {".hdr"_s, {"StbImageImporter", nullptr, nullptr}},
+    {".ktx2"_s, {"KtxImporter", nullptr, nullptr}},
+    {".dds"_s, {"DdsImporter", nullptr, nullptr}},
+};
+
+/* Smooth gradients with a bit of deterministic noise on top, so the data
+   compress reasonably but aren't trivial */
+Color4 syntheticPixel(const Vector2i& position, const Vector2i& size) {
+    const UnsignedInt hash = (UnsignedInt(position.x())*73856093u ^ UnsignedInt(position.y())*19349663u)*2654435761u;
+    const Float noise = Float(hash >> 24)/255.0f*0.125f;
+    const Vector2 t = Vector2{position}/Vector2{size};
+    return {t.x() + noise, t.y(), 1.0f - t.x()*t.y() + noise, 1.0f - noise};
+}
+
+Containers::Array<char> syntheticImage(const PixelFormat format, const Vector2i& size) {
+    Containers::Array<Color4> colors{NoInit, std::size_t(size.product())};
+    for(Int y = 0; y != size.y(); ++y)
+        for(Int x = 0; x != size.x(); ++x)
+            colors[y*size.x() + x] = syntheticPixel({x, y}, size);
+
+    Containers::Array<char> out{NoInit, std::size_t(size.product()*pixelFormatSize(format))};
+    if(format == PixelFormat::RGB8Unorm) {
+        const Containers::ArrayView<Vector3ub> pixels = Containers::arrayCast<Vector3ub>(out);
+        for(std::size_t i = 0; i != colors.size(); ++i)
+            pixels[i] = Math::pack<Vector3ub>(Math::clamp(Vector3{colors[i].rgb()}, 0.0f, 1.0f));
+    } else if(format == PixelFormat::RGBA8Unorm) {
+        const Containers::ArrayView<Vector4ub> pixels = Containers::arrayCast<Vector4ub>(out);
+        for(std::size_t i = 0; i != colors.size(); ++i)
+            pixels[i] = Math::pack<Vector4ub>(Math::clamp(Vector4{colors[i]}, 0.0f, 1.0f));
+    } else if(format == PixelFormat::RGBA16Unorm) {
+        const Containers::ArrayView<Vector4us> pixels = Containers::arrayCast<Vector4us>(out);
+        for(std::size_t i = 0; i != colors.size(); ++i)
+            pixels[i] = Math::pack<Vector4us>(Math::clamp(Vector4{colors[i]}, 0.0f, 1.0f));
+
+    /* The HDR formats get a larger range */
+    } else if(format == PixelFormat::RGBA16F) {
+        const Containers::ArrayView<Vector4us> pixels = Containers::arrayCast<Vector4us>(out);
+        for(std::size_t i = 0; i != colors.size(); ++i)
+            pixels[i] = Math::packHalf(Vector4{colors[i]*4.0f});
+    } else if(format == PixelFormat::RGB32F) {
+        const Containers::ArrayView<Vector3> pixels = Containers::arrayCast<Vector3>(out);
+        for(std::size_t i = 0; i != colors.size(); ++i)
+            pixels[i] = colors[i].rgb()*4.0f;
+    } else if(format == PixelFormat::RGBA32F) {
+        const Containers::ArrayView<Vector4> pixels = Containers::arrayCast<Vector4>(out);
+        for(std::size_t i = 0; i != colors.size(); ++i)
+            pixels[i] = colors[i]*4.0f;
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+    return out;
+}
+
+/* There's no DDS converter, so make an uncompressed RGBA8 file by hand */
+Containers::Array<char> ddsFile(const Vector2i& size, const Containers::ArrayView<const char> pixels) {
+    Containers::Array<char> out{ValueInit, 128 + pixels.size()};
+    const Containers::ArrayView<UnsignedInt> header = Containers::arrayCast<UnsignedInt>(out.prefix(128));
+    std::memcpy(out.data(), "DDS ", 4);
+    header[1] = 124;                    /* header size */
+    header[2] = 0x100f;                 /* caps, height, width, pixel format */
+    header[3] = size.y();
+    header[4] = size.x();
+    header[5] = size.x()*4;             /* pitch */
+    header[19] = 32;                    /* pixel format size */
+    header[20] = 0x41;                  /* RGB + alpha pixels */
+    header[22] = 32;                    /* bits per pixel */
+    header[23] = 0x000000ff;            /* RGBA masks */
+    header[24] = 0x0000ff00;
+    header[25] = 0x00ff0000;
+    header[26] = 0xff000000;
+    header[27] = 0x1000;                /* texture */
+    Utility::copy(pixels, out.exceptPrefix(128));
+    return out;
+}
+
+ImageImporterBenchmark::ImageImporterBenchmark(): TestSuite::Tester{TesterConfiguration{}.setSkippedArgumentPrefixes({"corpus"})} {
+    Utility::Arguments args{"corpus"};
+    args.addOption("sizes", "256 1024").setHelp("sizes", "sizes of synthetic images", "\"N N...\"")
+        .addOption("directory").setHelp("directory", "directory with real-world images to benchmark additionally", "DIR")
+        .parse(arguments().first(), arguments().second());
+
+    /* Load the plugins directly from the build tree. Otherwise they're either
+       static and already loaded or not built at all, in which case the
+       particular benchmark cases are skipped. */
+    #ifdef DDSIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(DDSIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef JPEGIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(JPEGIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef KTXIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(KTXIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef OPENEXRIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(OPENEXRIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef PNGIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(PNGIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef SPNGIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(SPNGIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STBIMAGEIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(STBIMAGEIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef WEBPIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(WEBPIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef JPEGIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(JPEGIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef KTXIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(KTXIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef OPENEXRIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(OPENEXRIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef PNGIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(PNGIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STBIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(STBIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef WEBPIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(WEBPIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+
+    /* Synthetic images. If a converter isn't available, the cases that depend
+       on it are not added at all; if an importer isn't available, the cases
+       are skipped later. */
+    for(const Containers::StringView sizeString: args.value<Containers::StringView>("sizes").splitOnWhitespaceWithoutEmptyParts()) {
+        /* The view is a part of a null-terminated string, so this is fine */
+        const Int size = std::strtol(sizeString.data(), nullptr, 10);
+        for(const auto& data: SyntheticData) {
+            if(data.converter && !(_converterManager.loadState(data.converter) & PluginManager::LoadState::Loaded))
+                continue;
+
+            const Containers::Array<char> pixels = syntheticImage(data.format, Vector2i{size});
+            Containers::Array<char> file;
+            if(data.converter) {
+                Containers::Pointer<Trade::AbstractImageConverter> converter = _converterManager.instantiate(data.converter);
+                Containers::Optional<Containers::Array<char>> converted = converter->convertToData(ImageView2D{data.format, Vector2i{size}, pixels});
+                CORRADE_INTERNAL_ASSERT(converted);
+                file = *Utility::move(converted);
+            } else file = ddsFile(Vector2i{size}, pixels);
+
+            arrayAppend(_cases, InPlaceInit,
+                Utility::format("{}, {} {}x{}, {} kB", data.importer, data.formatName, size, size, file.size()/1024),
+                data.importer,
+                Utility::move(file));
+        }
+    }
+
+    /* Real-world files, each with all importers that support given
+       extension */
+    if(const Containers::StringView directory = args.value<Containers::StringView>("directory")) {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(directory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot|Utility::Path::ListFlag::SortAscending);
+        CORRADE_INTERNAL_ASSERT(files);
+        for(const Containers::String& filename: *files) {
+            const Containers::String extension = Utility::String::lowercase(Utility::Path::splitExtension(filename).second());
+            for(const auto& data: CorpusData) {
+                if(data.extension != extension) continue;
+
+                Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(directory, filename));
+                CORRADE_INTERNAL_ASSERT(file);
+                for(const char* const importer: data.importers) {
+                    if(!importer) continue;
+                    Containers::Array<char> copy{NoInit, file->size()};
+                    Utility::copy(*file, copy);
+                    arrayAppend(_cases, InPlaceInit,
+                        Utility::format("{}, {}, {} kB", importer, filename, file->size()/1024),
+                        importer,
+                        Utility::move(copy));
+                }
+            }
+        }
+    }
+
+    /* The same benchmark measured once for the wall time and once for the
+       decoded size per second */
+    addInstancedBenchmarks({&ImageImporterBenchmark::decode}, 10, _cases.size());
+
+    addCustomInstancedBenchmarks({&ImageImporterBenchmark::decode}, 10, _cases.size(),
+        &ImageImporterBenchmark::throughputBegin,
+        &ImageImporterBenchmark::throughputEnd,
+        BenchmarkUnits::Count);
+
+    addCustomInstancedBenchmarks({&ImageImporterBenchmark::decodePeakAllocation}, 1, _cases.size(),
+        &ImageImporterBenchmark::peakAllocationBegin,
+        &ImageImporterBenchmark::peakAllocationEnd,
+        BenchmarkUnits::Bytes);
+}
+
+Containers::Pointer<Trade::AbstractImporter> ImageImporterBenchmark::instantiateAndVerify(const Case& data) {
+    if(!(_importerManager.loadState(data.importer) & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP(data.importer << "plugin not enabled, cannot benchmark");
+
+    Containers::Pointer<Trade::AbstractImporter> importer = _importerManager.instantiate(data.importer);
+
+    /* Verify that the file actually decodes outside of the measured loop,
+       and remember the decoded size for the throughput calculation */
+    CORRADE_VERIFY(importer->openData(data.data));
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    _decodedSize = image->data().size();
+
+    return importer;
+}
+
+void ImageImporterBenchmark::decode() {
+    const Case& data = _cases[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<Trade::AbstractImporter> importer = instantiateAndVerify(data);
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(data.data);
+        size += importer->image2D(0)->data().size();
+    }
+
+    CORRADE_COMPARE(size, _decodedSize);
+}
+
+void ImageImporterBenchmark::decodePeakAllocation() {
+    const Case& data = _cases[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<Trade::AbstractImporter> importer = instantiateAndVerify(data);
+    importer->close();
+
+    /* Includes the memory taken by the output image */
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(data.data);
+        size += importer->image2D(0)->data().size();
+        importer->close();
+    }
+
+    CORRADE_COMPARE(size, _decodedSize);
+}
+
+void ImageImporterBenchmark::throughputBegin() {
+    setBenchmarkName("decoded MB/s");
+    _throughputStart = std::chrono::steady_clock::now();
+}
+
+/* Reported as decoded megabytes (10^6 bytes) per second, there's no
+   dedicated benchmark unit for that so it's a plain count with the unit in
+   the benchmark name */
+std::uint64_t ImageImporterBenchmark::throughputEnd() {
+    const std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - _throughputStart;
+    return std::uint64_t(Double(_decodedSize)/1.0e6/std::chrono::duration<Double>(duration).count());
+}
+
+void ImageImporterBenchmark::peakAllocationBegin() {
+    _allocationBase = allocationResetPeak();
+}
+
+std::uint64_t ImageImporterBenchmark::peakAllocationEnd() {
+    return allocationPeak - _allocationBase;
+}
+
+}}}
+
+CORRADE_TEST_MAIN(Magnum::Test::ImageImporterBenchmark)
@@ -0,0 +1,458 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <string>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Primitives/Grid.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/SceneData.h>
+
+#include "configure.h"
+#include "allocationTracking.h"
+
+namespace Magnum { namespace Test { namespace {
+
+/* Open and import time and memory use of all scene importers, on generated
+   scenes written either with the scene converter plugins or by hand. Scene
+   size is controlled with --scene-meshes, --scene-vertices and
+   --scene-nodes, --scene-results file.jsonl additionally writes every
+   measurement as a JSON object on a separate line, for tracking over time.
+
+   Neither of the converters can write animations at the moment, so the
+   scenes contain just meshes and a node hierarchy. */
+struct SceneImporterBenchmark: TestSuite::Tester {
+    explicit SceneImporterBenchmark();
+    ~SceneImporterBenchmark();
+
+    void open();
+    void mesh();
+    void scene();
+    void peakAllocation();
+
+    private:
+        struct Case {
+            Containers::String name;
+            const char* importer;
+            Containers::Array<char> data;
+        };
+
+        Containers::Pointer<Trade::AbstractImporter> instantiateAndVerify(const Case& data);
+        void record(const char* unit, std::uint64_t value);
+
+        void timeBegin();
+        std::uint64_t timeEnd();
+        void peakAllocationBegin();
+        std::uint64_t peakAllocationEnd();
+
+        PluginManager::Manager<Trade::AbstractImporter> _importerManager;
+        PluginManager::Manager<Trade::AbstractSceneConverter> _converterManager;
+        Containers::Array<Case> _cases;
+
+        Containers::String _resultsFilename;
+        std::string _results;
+
+        std::size_t _batchSize;
+        std::chrono::steady_clock::time_point _timeStart;
+        std::size_t _allocationBase;
+};
+
+/* A quad tree, each node referencing one of the meshes and with a bit of
+   translation so the transformations aren't all identity */
+struct Node {
+    UnsignedInt mapping;
+    Int parent;
+    Vector3 translation;
+    UnsignedInt mesh;
+};
+
+Int nodeParent(const UnsignedInt i) {
+    return i ? Int((i - 1)/4) : -1;
+}
+
+Vector3 nodeTranslation(const UnsignedInt i) {
+    return {Float(i%16), Float(i/16%16), Float(i/256)};
+}
+
+Trade::MeshData gridMesh(const UnsignedInt vertexCount) {
+    const Int subdivisions = Math::max(Int(Math::sqrt(Float(vertexCount))) - 2, 0);
+    return Primitives::grid3DSolid({subdivisions, subdivisions},
+        Primitives::GridFlag::Normals|Primitives::GridFlag::TextureCoordinates);
+}
+
+Containers::Array<char> toArray(const std::string& string) {
+    Containers::Array<char> out{NoInit, string.size()};
+    Utility::copy(Containers::arrayView(string.data(), string.size()), out);
+    return out;
+}
+
+Containers::Optional<Containers::Array<char>> gltfFile(Trade::AbstractSceneConverter& converter, const Trade::MeshData& mesh, const UnsignedInt meshCount, const UnsignedInt nodeCount) {
+    if(!converter.beginData()) return {};
+    for(UnsignedInt i = 0; i != meshCount; ++i)
+        if(!converter.add(mesh)) return {};
+
+    Containers::Array<char> nodeData{NoInit, nodeCount*sizeof(Node)};
+    const Containers::StridedArrayView1D<Node> nodes = Containers::arrayCast<Node>(nodeData);
+    for(UnsignedInt i = 0; i != nodeCount; ++i)
+        nodes[i] = {i, nodeParent(i), nodeTranslation(i), i%meshCount};
+    if(!converter.add(Trade::SceneData{Trade::SceneMappingType::UnsignedInt, nodeCount, Utility::move(nodeData), {
+        Trade::SceneFieldData{Trade::SceneField::Parent, nodes.slice(&Node::mapping), nodes.slice(&Node::parent)},
+        Trade::SceneFieldData{Trade::SceneField::Translation, nodes.slice(&Node::mapping), nodes.slice(&Node::translation)},
+        Trade::SceneFieldData{Trade::SceneField::Mesh, nodes.slice(&Node::mapping), nodes.slice(&Node::mesh)}
+    }})) return {};
+
+    return converter.endData();
+}
+
+/* OBJ has no hierarchy, so it's just the meshes, each as a separate object */
+Containers::Array<char> objFile(const Trade::MeshData& mesh, const UnsignedInt meshCount) {
+    const Containers::Array<Vector3> positions = mesh.positions3DAsArray();
+    const Containers::Array<Vector3> normals = mesh.normalsAsArray();
+    const Containers::Array<Vector2> textureCoordinates = mesh.textureCoordinates2DAsArray();
+    const Containers::Array<UnsignedInt> indices = mesh.indicesAsArray();
+
+    std::string out;
+    for(UnsignedInt i = 0; i != meshCount; ++i) {
+        Utility::formatInto(out, out.size(), "o mesh{}\n", i);
+        for(const Vector3& position: positions)
+            Utility::formatInto(out, out.size(), "v {} {} {}\n", position.x(), position.y(), position.z());
+        for(const Vector3& normal: normals)
+            Utility::formatInto(out, out.size(), "vn {} {} {}\n", normal.x(), normal.y(), normal.z());
+        for(const Vector2& textureCoordinate: textureCoordinates)
+            Utility::formatInto(out, out.size(), "vt {} {}\n", textureCoordinate.x(), textureCoordinate.y());
+        /* Indices are global and one-based */
+        const UnsignedInt offset = i*positions.size() + 1;
+        for(std::size_t j = 0; j < indices.size(); j += 3) {
+            const UnsignedInt a = indices[j] + offset, b = indices[j + 1] + offset, c = indices[j + 2] + offset;
+            Utility::formatInto(out, out.size(), "f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n", a, b, c);
+        }
+    }
+
+    return toArray(out);
+}
+
+void ogexNode(std::string& out, const UnsignedInt i, const UnsignedInt meshCount, const UnsignedInt nodeCount) {
+    const Vector3 translation = nodeTranslation(i);
+    Utility::formatInto(out, out.size(),
+        "GeometryNode {{\n"
+        "ObjectRef {{ref {{$geometry{}}}}}\n"
+        "Translation {{float[3] {{{{{}, {}, {}}}}}}}\n",
+        i%meshCount, translation.x(), translation.y(), translation.z());
+    for(UnsignedInt child = 4*i + 1; child <= 4*i + 4 && child < nodeCount; ++child)
+        ogexNode(out, child, meshCount, nodeCount);
+    out += "}\n";
+}
+
+/* There's no OpenGEX converter, so write the file by hand. Each geometry
+   object is a copy of the same mesh, the node hierarchy is the same as in
+   the glTF file. */
+Containers::Array<char> ogexFile(const Trade::MeshData& mesh, const UnsignedInt meshCount, const UnsignedInt nodeCount) {
+    const Containers::Array<Vector3> positions = mesh.positions3DAsArray();
+    const Containers::Array<Vector3> normals = mesh.normalsAsArray();
+    const Containers::Array<Vector2> textureCoordinates = mesh.textureCoordinates2DAsArray();
+    const Containers::Array<UnsignedInt> indices = mesh.indicesAsArray();
+
+    std::string meshData = "Mesh (primitive = \"triangles\") {\n";
+    meshData += "VertexArray (attrib = \"position\") {float[3] {";
+    for(std::size_t i = 0; i != positions.size(); ++i)
+        Utility::formatInto(meshData, meshData.size(), "{}{{{}, {}, {}}}", i ? ", " : "", positions[i].x(), positions[i].y(), positions[i].z());
+    meshData += "}}\nVertexArray (attrib = \"normal\") {float[3] {";
+    for(std::size_t i = 0; i != normals.size(); ++i)
+        Utility::formatInto(meshData, meshData.size(), "{}{{{}, {}, {}}}", i ? ", " : "", normals[i].x(), normals[i].y(), normals[i].z());
+    meshData += "}}\nVertexArray (attrib = \"texcoord\") {float[2] {";
+    for(std::size_t i = 0; i != textureCoordinates.size(); ++i)
+        Utility::formatInto(meshData, meshData.size(), "{}{{{}, {}}}", i ? ", " : "", textureCoordinates[i].x(), textureCoordinates[i].y());
+    meshData += "}}\nIndexArray {unsigned_int32[3] {";
+    for(std::size_t i = 0; i < indices.size(); i += 3)
+        Utility::formatInto(meshData, meshData.size(), "{}{{{}, {}, {}}}", i ? ", " : "", indices[i], indices[i + 1], indices[i + 2]);
+    meshData += "}}\n}\n";
+
+    std::string out = "Metric (key = \"distance\") {float {1.0}}\n";
+    if(nodeCount) ogexNode(out, 0, meshCount, nodeCount);
+    for(UnsignedInt i = 0; i != meshCount; ++i) {
+        Utility::formatInto(out, out.size(), "GeometryObject $geometry{} {{\n", i);
+        out += meshData;
+        out += "}\n";
+    }
+
+    return toArray(out);
+}
+
+SceneImporterBenchmark::SceneImporterBenchmark(): TestSuite::Tester{TesterConfiguration{}.setSkippedArgumentPrefixes({"scene"})} {
+    Utility::Arguments args{"scene"};
+    args.addOption("meshes", "16").setHelp("meshes", "mesh count", "N")
+        .addOption("vertices", "1024").setHelp("vertices", "vertex count of each mesh", "N")
+        .addOption("nodes", "256").setHelp("nodes", "node count", "N")
+        .addOption("results").setHelp("results", "write measurements into a JSON Lines file", "FILE")
+        .parse(arguments().first(), arguments().second());
+    const UnsignedInt meshCount = Math::max(args.value<UnsignedInt>("meshes"), 1u);
+    const UnsignedInt vertexCount = args.value<UnsignedInt>("vertices");
+    const UnsignedInt nodeCount = args.value<UnsignedInt>("nodes");
+    _resultsFilename = args.value<Containers::StringView>("results");
+
+    /* Load the plugins directly from the build tree. Otherwise they're either
+       static and already loaded or not built at all, in which case the
+       particular benchmark cases are skipped. It also pulls in the
+       AnyImageImporter dependency. */
+    #ifdef ASSIMPIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(ASSIMPIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef GLTFIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(GLTFIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef OPENGEXIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(OPENGEXIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef UFBXIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(UFBXIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* Reset the plugin dir after so it doesn't load anything else from the
+       filesystem. Do this also in case of static plugins (no _FILENAME
+       defined) so it doesn't attempt to load dynamic system-wide plugins. */
+    #ifndef CORRADE_PLUGINMANAGER_NO_DYNAMIC_PLUGIN_SUPPORT
+    _importerManager.setPluginDirectory({});
+    _converterManager.setPluginDirectory({});
+    #endif
+    #ifdef STANFORDIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(STANFORDIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef GLTFSCENECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(GLTFSCENECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STANFORDSCENECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(STANFORDSCENECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+
+    const Trade::MeshData mesh = gridMesh(vertexCount);
+    const Containers::String sizeDescription = Utility::format("{} meshes, {} vertices each, {} nodes", meshCount, mesh.vertexCount(), nodeCount);
+
+    /* Files that can be made with a converter, added only if the converter is
+       available */
+    if(_converterManager.loadState("GltfSceneConverter") & PluginManager::LoadState::Loaded) {
+        Containers::Pointer<Trade::AbstractSceneConverter> converter = _converterManager.instantiate("GltfSceneConverter");
+        Containers::Optional<Containers::Array<char>> glb = gltfFile(*converter, mesh, meshCount, nodeCount);
+        CORRADE_INTERNAL_ASSERT(glb);
+        for(const char* importer: {"GltfImporter", "AssimpImporter"}) {
+            Containers::Array<char> copy{NoInit, glb->size()};
+            Utility::copy(*glb, copy);
+            arrayAppend(_cases, InPlaceInit,
+                Utility::format("{}, GLB, {}, {} kB", importer, sizeDescription, copy.size()/1024),
+                importer, Utility::move(copy));
+        }
+    }
+
+    /* PLY can't contain multiple meshes or a hierarchy, so it's a single mesh
+       with all the vertices */
+    if(_converterManager.loadState("StanfordSceneConverter") & PluginManager::LoadState::Loaded) {
+        Containers::Pointer<Trade::AbstractSceneConverter> converter = _converterManager.instantiate("StanfordSceneConverter");
+        const Trade::MeshData plyMesh = gridMesh(meshCount*vertexCount);
+        Containers::Optional<Containers::Array<char>> ply = converter->convertToData(plyMesh);
+        CORRADE_INTERNAL_ASSERT(ply);
+        for(const char* importer: {"StanfordImporter", "AssimpImporter"}) {
+            Containers::Array<char> copy{NoInit, ply->size()};
+            Utility::copy(*ply, copy);
+            arrayAppend(_cases, InPlaceInit,
+                Utility::format("{}, PLY, a single mesh with {} vertices, {} kB", importer, plyMesh.vertexCount(), copy.size()/1024),
+                importer, Utility::move(copy));
+        }
+    }
+
+    /* Files written by hand */
+    {
+        const Containers::Array<char> obj = objFile(mesh, meshCount);
+        for(const char* importer: {"UfbxImporter", "AssimpImporter"}) {
+            Containers::Array<char> copy{NoInit, obj.size()};
+            Utility::copy(obj, copy);
+            arrayAppend(_cases, InPlaceInit,
+                Utility::format("{}, OBJ, {} meshes, {} vertices each, {} kB", importer, meshCount, mesh.vertexCount(), copy.size()/1024),
+                importer, Utility::move(copy));
+        }
+    } {
+        const Containers::Array<char> ogex = ogexFile(mesh, meshCount, nodeCount);
+        for(const char* importer: {"OpenGexImporter", "AssimpImporter"}) {
+            Containers::Array<char> copy{NoInit, ogex.size()};
+            Utility::copy(ogex, copy);
+            arrayAppend(_cases, InPlaceInit,
+                Utility::format("{}, OpenGEX, {}, {} kB", importer, sizeDescription, copy.size()/1024),
+                importer, Utility::move(copy));
+        }
+    }
+
+    addCustomInstancedBenchmarks({&SceneImporterBenchmark::open,
+                                  &SceneImporterBenchmark::mesh,
+                                  &SceneImporterBenchmark::scene}, 5, _cases.size(),
+        &SceneImporterBenchmark::timeBegin,
+        &SceneImporterBenchmark::timeEnd,
+        BenchmarkUnits::Nanoseconds);
+
+    addCustomInstancedBenchmarks({&SceneImporterBenchmark::peakAllocation}, 1, _cases.size(),
+        &SceneImporterBenchmark::peakAllocationBegin,
+        &SceneImporterBenchmark::peakAllocationEnd,
+        BenchmarkUnits::Bytes);
+}
+
+SceneImporterBenchmark::~SceneImporterBenchmark() {
+    if(_resultsFilename && !Utility::Path::write(_resultsFilename, Containers::arrayView(_results.data(), _results.size())))
+        Error{} << "Cannot write benchmark results to" << _resultsFilename;
+}
+
+Containers::Pointer<Trade::AbstractImporter> SceneImporterBenchmark::instantiateAndVerify(const Case& data) {
+    if(!(_importerManager.loadState(data.importer) & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP(data.importer << "plugin not enabled, cannot benchmark");
+
+    Containers::Pointer<Trade::AbstractImporter> importer = _importerManager.instantiate(data.importer);
+
+    /* Verify that the file actually opens outside of the measured loop */
+    CORRADE_VERIFY(importer->openData(data.data));
+    CORRADE_COMPARE_AS(importer->meshCount(), 0u, TestSuite::Compare::Greater);
+
+    return importer;
+}
+
+void SceneImporterBenchmark::open() {
+    const Case& data = _cases[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<Trade::AbstractImporter> importer = instantiateAndVerify(data);
+
+    _batchSize = 1;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(data.data);
+    }
+
+    CORRADE_VERIFY(importer->isOpened());
+}
+
+void SceneImporterBenchmark::mesh() {
+    const Case& data = _cases[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<Trade::AbstractImporter> importer = instantiateAndVerify(data);
+
+    /* Measures the average time to import a single mesh */
+    const UnsignedInt meshCount = importer->meshCount();
+    _batchSize = meshCount;
+    UnsignedInt i = 0;
+    std::size_t vertexCount = 0;
+    CORRADE_BENCHMARK(meshCount) {
+        vertexCount += importer->mesh(i++)->vertexCount();
+    }
+
+    CORRADE_COMPARE_AS(vertexCount, std::size_t{}, TestSuite::Compare::Greater);
+}
+
+void SceneImporterBenchmark::scene() {
+    const Case& data = _cases[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<Trade::AbstractImporter> importer = instantiateAndVerify(data);
+    if(!importer->sceneCount())
+        CORRADE_SKIP("The file has no scene.");
+
+    _batchSize = 1;
+    UnsignedLong objectCount = 0;
+    CORRADE_BENCHMARK(1) {
+        objectCount += importer->scene(0)->mappingBound();
+    }
+
+    CORRADE_COMPARE_AS(objectCount, 0ull, TestSuite::Compare::Greater);
+}
+
+void SceneImporterBenchmark::peakAllocation() {
+    const Case& data = _cases[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<Trade::AbstractImporter> importer = instantiateAndVerify(data);
+    importer->close();
+
+    /* Opening the file and importing everything, including the memory taken
+       by the output meshes and scene */
+    _batchSize = 1;
+    std::size_t vertexCount = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(data.data);
+        Containers::Array<Trade::MeshData> meshes;
+        for(UnsignedInt i = 0; i != importer->meshCount(); ++i) {
+            Containers::Optional<Trade::MeshData> mesh = importer->mesh(i);
+            vertexCount += mesh->vertexCount();
+            arrayAppend(meshes, *Utility::move(mesh));
+        }
+        Containers::Optional<Trade::SceneData> scene;
+        if(importer->sceneCount())
+            scene = importer->scene(0);
+        importer->close();
+    }
+
+    CORRADE_COMPARE_AS(vertexCount, std::size_t{}, TestSuite::Compare::Greater);
+}
+
+void SceneImporterBenchmark::record(const char* const unit, const std::uint64_t value) {
+    if(!_resultsFilename) return;
+
+    Utility::formatInto(_results, _results.size(),
+        "{{\"benchmark\": \"{}\", \"case\": \"{}\", \"unit\": \"{}\", \"value\": {}}}\n",
+        testCaseName(), testCaseDescription(), unit, value);
+}
+
+void SceneImporterBenchmark::timeBegin() {
+    _timeStart = std::chrono::steady_clock::now();
+}
+
+std::uint64_t SceneImporterBenchmark::timeEnd() {
+    const std::uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _timeStart).count();
+    record("ns", duration/_batchSize);
+    return duration;
+}
+
+void SceneImporterBenchmark::peakAllocationBegin() {
+    _allocationBase = allocationResetPeak();
+}
+
+std::uint64_t SceneImporterBenchmark::peakAllocationEnd() {
+    const std::uint64_t peak = allocationPeak - _allocationBase;
+    record("B", peak/_batchSize);
+    return peak;
+}
+
+}}}
+
+CORRADE_TEST_MAIN(Magnum::Test::SceneImporterBenchmark)
@@ -0,0 +1,215 @@
+#ifndef Magnum_Test_allocationTracking_h
+#define Magnum_Test_allocationTracking_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Tracks the amount of currently allocated heap memory and its peak. Meant
+   to be included in exactly one file of each benchmark executable.
+
+   With glibc, malloc() and friends are replaced with wrappers around the
+   internal __libc_malloc() etc., measuring the size with
+   malloc_usable_size(). That covers C++ allocations, which go through
+   malloc() as well, and also third-party C libraries such as libpng or
+   libjpeg used by the plugins. The reported values thus include allocator
+   rounding, but not its bookkeeping overhead. Not done with AddressSanitizer,
+   which replaces malloc() on its own.
+
+   Elsewhere only the global operator new and delete are replaced, and thus
+   only C++ allocations are tracked, third-party libraries that allocate
+   through malloc() directly are not.
+
+   For dynamically loaded plugins and shared libraries either relies on symbol
+   interposition, which works on ELF platforms with the executable built with
+   ENABLE_EXPORTS, but not on Windows or Apple platforms, where only
+   allocations done by the executable itself and static plugins are
+   tracked. */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define MAGNUM_TEST_ALLOCATION_TRACKING_MALLOC
+#include <malloc.h> /* malloc_usable_size() */
+#endif
+
+namespace Magnum { namespace Test { namespace {
+
+std::atomic<std::size_t> allocationCurrent{0};
+std::atomic<std::size_t> allocationPeak{0};
+
+void allocationAdd(const std::size_t size) noexcept {
+    const std::size_t current = allocationCurrent += size;
+    std::size_t peak = allocationPeak.load();
+    while(current > peak && !allocationPeak.compare_exchange_weak(peak, current)) {}
+}
+
+/* Resets the peak to the currently allocated amount and returns it. Peak
+   allocation of an operation is then allocationPeak - allocationResetPeak()
+   after it's done. */
+std::size_t allocationResetPeak() {
+    const std::size_t current = allocationCurrent;
+    allocationPeak = current;
+    return current;
+}
+
+}}}
+
+#ifdef MAGNUM_TEST_ALLOCATION_TRACKING_MALLOC
+extern "C" {
+
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void* __libc_memalign(std::size_t, std::size_t);
+void* __libc_valloc(std::size_t);
+void* __libc_pvalloc(std::size_t);
+void __libc_free(void*);
+
+}
+
+namespace Magnum { namespace Test { namespace {
+
+void* trackedAllocated(void* const memory) noexcept {
+    if(memory) allocationAdd(malloc_usable_size(memory));
+    return memory;
+}
+
+}}}
+
+extern "C" {
+
+void* malloc(const std::size_t size) noexcept {
+    return Magnum::Test::trackedAllocated(__libc_malloc(size));
+}
+
+void* calloc(const std::size_t count, const std::size_t size) noexcept {
+    return Magnum::Test::trackedAllocated(__libc_calloc(count, size));
+}
+
+void* realloc(void* const pointer, const std::size_t size) noexcept {
+    const std::size_t previousSize = pointer ? malloc_usable_size(pointer) : 0;
+    void* const memory = __libc_realloc(pointer, size);
+    /* On failure the original allocation stays untouched, with zero size
+       it's freed */
+    if(!memory && size) return nullptr;
+    Magnum::Test::allocationCurrent -= previousSize;
+    return Magnum::Test::trackedAllocated(memory);
+}
+
+void* memalign(const std::size_t alignment, const std::size_t size) noexcept {
+    return Magnum::Test::trackedAllocated(__libc_memalign(alignment, size));
+}
+
+void* aligned_alloc(const std::size_t alignment, const std::size_t size) noexcept {
+    return Magnum::Test::trackedAllocated(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void** const pointer, const std::size_t alignment, const std::size_t size) noexcept {
+    if(!alignment || alignment % sizeof(void*) || (alignment & (alignment - 1)))
+        return 22; /* EINVAL */
+    void* const memory = Magnum::Test::trackedAllocated(__libc_memalign(alignment, size));
+    if(!memory) return 12; /* ENOMEM */
+    *pointer = memory;
+    return 0;
+}
+
+void* valloc(const std::size_t size) noexcept {
+    return Magnum::Test::trackedAllocated(__libc_valloc(size));
+}
+
+void* pvalloc(const std::size_t size) noexcept {
+    return Magnum::Test::trackedAllocated(__libc_pvalloc(size));
+}
+
+void free(void* const pointer) noexcept {
+    if(!pointer) return;
+    Magnum::Test::allocationCurrent -= malloc_usable_size(pointer);
+    __libc_free(pointer);
+}
+
+}
+#else
+namespace Magnum { namespace Test { namespace {
+
+/* Keeps the returned memory aligned for any fundamental type */
+constexpr std::size_t AllocationHeaderSize = alignof(std::max_align_t);
+
+void* trackedAllocate(const std::size_t size) noexcept {
+    void* const memory = std::malloc(size + AllocationHeaderSize);
+    if(!memory) return nullptr;
+    *static_cast<std::size_t*>(memory) = size;
+    allocationAdd(size);
+    return static_cast<char*>(memory) + AllocationHeaderSize;
+}
+
+void trackedDeallocate(void* const pointer) noexcept {
+    if(!pointer) return;
+    void* const memory = static_cast<char*>(pointer) - AllocationHeaderSize;
+    allocationCurrent -= *static_cast<std::size_t*>(memory);
+    std::free(memory);
+}
+
+}}}
+
+void* operator new(const std::size_t size) {
+    if(void* const pointer = Magnum::Test::trackedAllocate(size))
+        return pointer;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](const std::size_t size) {
+    if(void* const pointer = Magnum::Test::trackedAllocate(size))
+        return pointer;
+    throw std::bad_alloc{};
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    return Magnum::Test::trackedAllocate(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept {
+    return Magnum::Test::trackedAllocate(size);
+}
+
+void operator delete(void* const pointer) noexcept {
+    Magnum::Test::trackedDeallocate(pointer);
+}
+
+void operator delete[](void* const pointer) noexcept {
+    Magnum::Test::trackedDeallocate(pointer);
+}
+
+void operator delete(void* const pointer, const std::nothrow_t&) noexcept {
+    Magnum::Test::trackedDeallocate(pointer);
+}
+
+void operator delete[](void* const pointer, const std::nothrow_t&) noexcept {
+    Magnum::Test::trackedDeallocate(pointer);
+}
+#endif
+
+#endif
@@ -0,0 +1,51 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#cmakedefine ASSIMPIMPORTER_PLUGIN_FILENAME "${ASSIMPIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine BASISIMAGECONVERTER_PLUGIN_FILENAME "${BASISIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine BASISIMPORTER_PLUGIN_FILENAME "${BASISIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine BCDECIMAGECONVERTER_PLUGIN_FILENAME "${BCDECIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine DDSIMPORTER_PLUGIN_FILENAME "${DDSIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine ETCDECIMAGECONVERTER_PLUGIN_FILENAME "${ETCDECIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine GLTFIMPORTER_PLUGIN_FILENAME "${GLTFIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine GLTFSCENECONVERTER_PLUGIN_FILENAME "${GLTFSCENECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine JPEGIMAGECONVERTER_PLUGIN_FILENAME "${JPEGIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine JPEGIMPORTER_PLUGIN_FILENAME "${JPEGIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine KTXIMAGECONVERTER_PLUGIN_FILENAME "${KTXIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine KTXIMPORTER_PLUGIN_FILENAME "${KTXIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine OPENEXRIMAGECONVERTER_PLUGIN_FILENAME "${OPENEXRIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine OPENEXRIMPORTER_PLUGIN_FILENAME "${OPENEXRIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine OPENGEXIMPORTER_PLUGIN_FILENAME "${OPENGEXIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine PNGIMAGECONVERTER_PLUGIN_FILENAME "${PNGIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine PNGIMPORTER_PLUGIN_FILENAME "${PNGIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine SPNGIMPORTER_PLUGIN_FILENAME "${SPNGIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine STANFORDIMPORTER_PLUGIN_FILENAME "${STANFORDIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine STANFORDSCENECONVERTER_PLUGIN_FILENAME "${STANFORDSCENECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine STBDXTIMAGECONVERTER_PLUGIN_FILENAME "${STBDXTIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine STBIMAGECONVERTER_PLUGIN_FILENAME "${STBIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine UFBXIMPORTER_PLUGIN_FILENAME "${UFBXIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine WEBPIMAGECONVERTER_PLUGIN_FILENAME "${WEBPIMAGECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine WEBPIMPORTER_PLUGIN_FILENAME "${WEBPIMPORTER_PLUGIN_FILENAME}"